@@ -0,0 +1,326 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// chained_hash_table.cpp
+//
+// Identification: src/container/hash/chained_hash_table.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/rid.h"
+#include "container/hash/chained_hash_table.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+CHAINED_HASH_TABLE_TYPE::ChainedHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                                          const KeyComparator &comparator, size_t num_buckets,
+                                          HashFunction<KeyType> hash_fn)
+    : buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      initial_buckets_(std::max<size_t>(num_buckets, 1)),
+      hash_fn_(std::move(hash_fn)) {
+  if (initial_buckets_ > HashTableHeaderPage::MAX_BLOCKS) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "too many buckets for one hash table header page");
+  }
+  Page *page = buffer_pool_manager_->NewPage(&header_page_id_);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no frame left for a hash table header page");
+  }
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(page->GetData());
+  header->SetPageId(header_page_id_);
+  header->SetSize(initial_buckets_);
+  for (size_t i = 0; i < initial_buckets_; i++) {
+    page_id_t head_page_id = NewChainPage();
+    header->AddBlockPageId(head_page_id);
+    bucket_page_ids_.push_back(head_page_id);
+  }
+  num_pages_ = initial_buckets_;
+  buffer_pool_manager_->UnpinPage(header_page_id_, true);
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool CHAINED_HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) {
+  table_latch_.RLock();
+  page_id_t head_page_id = bucket_page_ids_[BucketOf(hash_fn_.GetHash(key))];
+  Page *head = FetchChainPage(head_page_id);
+  head->RLatch();
+  bool found = false;
+  page_id_t page_id = head_page_id;
+  while (page_id != INVALID_PAGE_ID) {
+    Page *page = page_id == head_page_id ? head : FetchChainPage(page_id);
+    auto *chain = reinterpret_cast<ChainPage *>(page->GetData());
+    found = chain->GetValue(key, comparator_, result) || found;
+    page_id_t next_page_id = chain->GetNextPageId();
+    if (page != head) {
+      buffer_pool_manager_->UnpinPage(page_id, false);
+    }
+    page_id = next_page_id;
+  }
+  head->RUnlatch();
+  buffer_pool_manager_->UnpinPage(head_page_id, false);
+  table_latch_.RUnlock();
+  return found;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool CHAINED_HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.RLock();
+  page_id_t head_page_id = bucket_page_ids_[BucketOf(hash_fn_.GetHash(key))];
+  Page *head = FetchChainPage(head_page_id);
+  head->WLatch();
+  //整条链都要查重，顺便记下第一个还有空位的page
+  bool exists = false;
+  page_id_t room_page_id = INVALID_PAGE_ID;
+  page_id_t last_page_id = head_page_id;
+  page_id_t page_id = head_page_id;
+  while (page_id != INVALID_PAGE_ID && !exists) {
+    Page *page = page_id == head_page_id ? head : FetchChainPage(page_id);
+    auto *chain = reinterpret_cast<ChainPage *>(page->GetData());
+    exists = chain->Find(key, value, comparator_) >= 0;
+    if (room_page_id == INVALID_PAGE_ID && !chain->IsFull()) {
+      room_page_id = page_id;
+    }
+    last_page_id = page_id;
+    page_id_t next_page_id = chain->GetNextPageId();
+    if (page != head) {
+      buffer_pool_manager_->UnpinPage(page_id, false);
+    }
+    page_id = next_page_id;
+  }
+
+  bool grew = false;
+  if (!exists) {
+    if (room_page_id == INVALID_PAGE_ID) {
+      // 全满：在链尾接一个新page
+      room_page_id = NewChainPage();
+      Page *last = last_page_id == head_page_id ? head : FetchChainPage(last_page_id);
+      reinterpret_cast<ChainPage *>(last->GetData())->SetNextPageId(room_page_id);
+      if (last != head) {
+        buffer_pool_manager_->UnpinPage(last_page_id, true);
+      }
+      num_pages_++;
+      grew = true;
+    }
+    Page *page = room_page_id == head_page_id ? head : FetchChainPage(room_page_id);
+    reinterpret_cast<ChainPage *>(page->GetData())->Append(MappingType(key, value));
+    if (page != head) {
+      buffer_pool_manager_->UnpinPage(room_page_id, true);
+    }
+  }
+  head->WUnlatch();
+  buffer_pool_manager_->UnpinPage(head_page_id, !exists);
+  bool split = grew && NeedsSplit();
+  table_latch_.RUnlock();
+  if (split) {
+    Split();
+  }
+  return !exists;
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool CHAINED_HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.RLock();
+  page_id_t head_page_id = bucket_page_ids_[BucketOf(hash_fn_.GetHash(key))];
+  Page *head = FetchChainPage(head_page_id);
+  head->WLatch();
+  bool found = false;
+  page_id_t prev_page_id = INVALID_PAGE_ID;
+  page_id_t page_id = head_page_id;
+  while (page_id != INVALID_PAGE_ID && !found) {
+    Page *page = page_id == head_page_id ? head : FetchChainPage(page_id);
+    auto *chain = reinterpret_cast<ChainPage *>(page->GetData());
+    int index = chain->Find(key, value, comparator_);
+    page_id_t next_page_id = chain->GetNextPageId();
+    found = index >= 0;
+    if (found) {
+      chain->RemoveAt(static_cast<uint32_t>(index));
+    }
+    if (page == head) {
+      prev_page_id = page_id;
+      page_id = next_page_id;
+      continue;
+    }
+    if (found && chain->GetCount() == 0) {
+      //空了的overflow page从链上摘掉并释放，head page一直保留
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      Page *prev = prev_page_id == head_page_id ? head : FetchChainPage(prev_page_id);
+      reinterpret_cast<ChainPage *>(prev->GetData())->SetNextPageId(next_page_id);
+      if (prev != head) {
+        buffer_pool_manager_->UnpinPage(prev_page_id, true);
+      }
+      buffer_pool_manager_->DeletePage(page_id);
+      num_pages_--;
+    } else {
+      buffer_pool_manager_->UnpinPage(page_id, found);
+    }
+    prev_page_id = page_id;
+    page_id = next_page_id;
+  }
+  head->WUnlatch();
+  buffer_pool_manager_->UnpinPage(head_page_id, found);
+  table_latch_.RUnlock();
+  return found;
+}
+
+/*****************************************************************************
+ * GETSIZE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+size_t CHAINED_HASH_TABLE_TYPE::GetSize() {
+  table_latch_.RLock();
+  size_t size = bucket_page_ids_.size();
+  table_latch_.RUnlock();
+  return size;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+double CHAINED_HASH_TABLE_TYPE::GetAverageChainLength() {
+  table_latch_.RLock();
+  double length = static_cast<double>(num_pages_.load()) / static_cast<double>(bucket_page_ids_.size());
+  table_latch_.RUnlock();
+  return length;
+}
+
+/*****************************************************************************
+ * SPLIT
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+size_t CHAINED_HASH_TABLE_TYPE::BucketOf(uint64_t hash) const {
+  size_t bucket = hash % (initial_buckets_ << level_);
+  //这一轮已经分裂过的bucket按两倍的模数分
+  if (bucket < next_) {
+    bucket = hash % (initial_buckets_ << (level_ + 1));
+  }
+  return bucket;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool CHAINED_HASH_TABLE_TYPE::NeedsSplit() const {
+  return static_cast<double>(num_pages_.load()) > MAX_CHAIN_LENGTH * static_cast<double>(bucket_page_ids_.size()) &&
+         bucket_page_ids_.size() < HashTableHeaderPage::MAX_BLOCKS;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void CHAINED_HASH_TABLE_TYPE::Split() {
+  table_latch_.WLock();
+  //等锁期间别的insert可能已经分裂过了
+  if (!NeedsSplit()) {
+    table_latch_.WUnlock();
+    return;
+  }
+  size_t bucket = next_;
+  size_t image = bucket_page_ids_.size();
+  size_t modulus = initial_buckets_ << (level_ + 1);
+
+  std::vector<page_id_t> pages;
+  std::vector<MappingType> stay;
+  std::vector<MappingType> move;
+  for (page_id_t page_id = bucket_page_ids_[bucket]; page_id != INVALID_PAGE_ID;) {
+    Page *page = FetchChainPage(page_id);
+    auto *chain = reinterpret_cast<ChainPage *>(page->GetData());
+    for (uint32_t i = 0; i < chain->GetCount(); i++) {
+      const MappingType &pair = chain->PairAt(i);
+      (hash_fn_.GetHash(pair.first) % modulus == image ? move : stay).push_back(pair);
+    }
+    pages.push_back(page_id);
+    page_id_t next_page_id = chain->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+
+  page_id_t image_page_id = NewChainPage();
+  num_pages_++;
+  Page *page = buffer_pool_manager_->FetchPage(header_page_id_);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no frame left for the hash table header page");
+  }
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(page->GetData());
+  header->AddBlockPageId(image_page_id);
+  header->SetSize(image + 1);
+  buffer_pool_manager_->UnpinPage(header_page_id_, true);
+  bucket_page_ids_.push_back(image_page_id);
+
+  WriteChain(std::move(pages), stay);
+  WriteChain({image_page_id}, move);
+  if (++next_ == initial_buckets_ << level_) {
+    level_++;
+    next_ = 0;
+  }
+  table_latch_.WUnlock();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void CHAINED_HASH_TABLE_TYPE::WriteChain(std::vector<page_id_t> pages, const std::vector<MappingType> &pairs) {
+  size_t needed = std::max<size_t>((pairs.size() + CHAIN_ARRAY_SIZE - 1) / CHAIN_ARRAY_SIZE, 1);
+  while (pages.size() < needed) {
+    pages.push_back(NewChainPage());
+    num_pages_++;
+  }
+  size_t pos = 0;
+  for (size_t i = 0; i < needed; i++) {
+    Page *page = FetchChainPage(pages[i]);
+    auto *chain = reinterpret_cast<ChainPage *>(page->GetData());
+    chain->Clear();
+    while (pos < pairs.size() && chain->Append(pairs[pos])) {
+      pos++;
+    }
+    chain->SetNextPageId(i + 1 < needed ? pages[i + 1] : INVALID_PAGE_ID);
+    buffer_pool_manager_->UnpinPage(pages[i], true);
+  }
+  for (size_t i = needed; i < pages.size(); i++) {
+    buffer_pool_manager_->DeletePage(pages[i]);
+    num_pages_--;
+  }
+}
+
+/*****************************************************************************
+ * PAGES
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *CHAINED_HASH_TABLE_TYPE::FetchChainPage(page_id_t page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no frame left for a hash table chain page");
+  }
+  return page;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+page_id_t CHAINED_HASH_TABLE_TYPE::NewChainPage() {
+  page_id_t page_id;
+  Page *page = buffer_pool_manager_->NewPage(&page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no frame left for a hash table chain page");
+  }
+  reinterpret_cast<ChainPage *>(page->GetData())->Init();
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  return page_id;
+}
+
+template class ChainedHashTable<int, int, IntComparator>;
+
+template class ChainedHashTable<GenericKey<4>, RID, GenericComparator<4>>;
+template class ChainedHashTable<GenericKey<8>, RID, GenericComparator<8>>;
+template class ChainedHashTable<GenericKey<16>, RID, GenericComparator<16>>;
+template class ChainedHashTable<GenericKey<32>, RID, GenericComparator<32>>;
+template class ChainedHashTable<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
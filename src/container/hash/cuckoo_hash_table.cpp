@@ -0,0 +1,316 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// cuckoo_hash_table.cpp
+//
+// Identification: src/container/hash/cuckoo_hash_table.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <initializer_list>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/rid.h"
+#include "container/hash/cuckoo_hash_table.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+CUCKOO_HASH_TABLE_TYPE::CuckooHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                                        const KeyComparator &comparator, size_t num_buckets,
+                                        HashFunction<KeyType> hash_fn)
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
+  table_ = NewTable(num_buckets);
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool CUCKOO_HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) {
+  table_latch_.RLock();
+  size_t first;
+  size_t second;
+  Buckets(table_, hash_fn_.GetHash(key), &first, &second);
+  bool found = false;
+  for (size_t bucket : {first, second}) {
+    Page *page = FetchBucketPage(table_, bucket);
+    page->RLatch();
+    found = reinterpret_cast<CuckooPage *>(page->GetData())
+                ->GetValue(static_cast<uint32_t>(bucket % CUCKOO_BUCKET_ARRAY_SIZE), key, comparator_, result) ||
+            found;
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  }
+  table_latch_.RUnlock();
+  return found;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool CUCKOO_HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.WLock();
+  size_t first;
+  size_t second;
+  Buckets(table_, hash_fn_.GetHash(key), &first, &second);
+  bool exists = false;
+  uint32_t num_values = 0;
+  for (size_t bucket : {first, second}) {
+    Page *page = FetchBucketPage(table_, bucket);
+    auto *cuckoo = reinterpret_cast<CuckooPage *>(page->GetData());
+    auto offset = static_cast<uint32_t>(bucket % CUCKOO_BUCKET_ARRAY_SIZE);
+    exists = exists || cuckoo->Contains(offset, key, value, comparator_);
+    num_values += cuckoo->CountKey(offset, key, comparator_);
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  }
+  //两个bucket都被这个key占满时，再大的table也放不下
+  if (exists || num_values == 2 * CUCKOO_SLOTS) {
+    table_latch_.WUnlock();
+    return false;
+  }
+  MappingType pair(key, value);
+  if (!Place(table_, pair)) {
+    Grow(pair);
+  }
+  table_latch_.WUnlock();
+  return true;
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool CUCKOO_HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.RLock();
+  size_t first;
+  size_t second;
+  Buckets(table_, hash_fn_.GetHash(key), &first, &second);
+  bool removed = false;
+  for (size_t bucket : {first, second}) {
+    Page *page = FetchBucketPage(table_, bucket);
+    page->WLatch();
+    removed = reinterpret_cast<CuckooPage *>(page->GetData())
+                  ->Remove(static_cast<uint32_t>(bucket % CUCKOO_BUCKET_ARRAY_SIZE), key, value, comparator_);
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), removed);
+    if (removed) {
+      break;
+    }
+  }
+  table_latch_.RUnlock();
+  return removed;
+}
+
+/*****************************************************************************
+ * GETSIZE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+size_t CUCKOO_HASH_TABLE_TYPE::GetSize() {
+  table_latch_.RLock();
+  size_t size = table_.num_buckets_;
+  table_latch_.RUnlock();
+  return size;
+}
+
+/*****************************************************************************
+ * TABLES
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+typename CUCKOO_HASH_TABLE_TYPE::Table CUCKOO_HASH_TABLE_TYPE::NewTable(size_t num_buckets) {
+  Table table;
+  size_t num_pages = std::max<size_t>((num_buckets + CUCKOO_BUCKET_ARRAY_SIZE - 1) / CUCKOO_BUCKET_ARRAY_SIZE, 1);
+  if (num_pages > HashTableHeaderPage::MAX_BLOCKS) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "too many buckets for one hash table header page");
+  }
+  table.num_buckets_ = num_pages * CUCKOO_BUCKET_ARRAY_SIZE;
+  Page *page = buffer_pool_manager_->NewPage(&table.header_page_id_);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no frame left for a hash table header page");
+  }
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(page->GetData());
+  header->SetPageId(table.header_page_id_);
+  header->SetSize(table.num_buckets_);
+  for (size_t i = 0; i < num_pages; i++) {
+    page_id_t bucket_page_id;
+    //NewPage已经清零，所有bucket都是空的
+    if (buffer_pool_manager_->NewPage(&bucket_page_id) == nullptr) {
+      buffer_pool_manager_->UnpinPage(table.header_page_id_, true);
+      DeleteTable(table);
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "no frame left for a hash table bucket page");
+    }
+    header->AddBlockPageId(bucket_page_id);
+    table.bucket_page_ids_.push_back(bucket_page_id);
+    buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  }
+  buffer_pool_manager_->UnpinPage(table.header_page_id_, true);
+  return table;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void CUCKOO_HASH_TABLE_TYPE::DeleteTable(const Table &table) {
+  for (page_id_t bucket_page_id : table.bucket_page_ids_) {
+    buffer_pool_manager_->DeletePage(bucket_page_id);
+  }
+  buffer_pool_manager_->DeletePage(table.header_page_id_);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void CUCKOO_HASH_TABLE_TYPE::Grow(const MappingType &pair) {
+  size_t num_buckets = table_.num_buckets_;
+  while (true) {
+    num_buckets *= 2;
+    Table bigger = NewTable(num_buckets);
+    bool placed = Place(bigger, pair);
+    for (size_t i = 0; placed && i < table_.bucket_page_ids_.size(); i++) {
+      Page *page = buffer_pool_manager_->FetchPage(table_.bucket_page_ids_[i]);
+      if (page == nullptr) {
+        DeleteTable(bigger);
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "no frame left for a hash table bucket page");
+      }
+      auto *cuckoo = reinterpret_cast<CuckooPage *>(page->GetData());
+      for (uint32_t bucket = 0; placed && bucket < CUCKOO_BUCKET_ARRAY_SIZE; bucket++) {
+        for (uint32_t slot = 0; placed && slot < CUCKOO_SLOTS; slot++) {
+          placed = !cuckoo->IsReadable(bucket, slot) || Place(bigger, cuckoo->PairAt(bucket, slot));
+        }
+      }
+      buffer_pool_manager_->UnpinPage(table_.bucket_page_ids_[i], false);
+    }
+    if (placed) {
+      DeleteTable(table_);
+      table_ = std::move(bigger);
+      return;
+    }
+    //没有放下全部pair的概率极小，换一个更大的table重来
+    DeleteTable(bigger);
+  }
+}
+
+/*****************************************************************************
+ * BUCKETS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void CUCKOO_HASH_TABLE_TYPE::Buckets(const Table &table, uint64_t hash, size_t *first, size_t *second) const {
+  *first = hash % table.num_buckets_;
+  *second = (hash >> 32) % table.num_buckets_;
+  if (*second == *first) {
+    *second = (*first + 1) % table.num_buckets_;
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *CUCKOO_HASH_TABLE_TYPE::FetchBucketPage(const Table &table, size_t bucket) {
+  Page *page = buffer_pool_manager_->FetchPage(table.bucket_page_ids_[bucket / CUCKOO_BUCKET_ARRAY_SIZE]);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no frame left for a hash table bucket page");
+  }
+  return page;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+size_t CUCKOO_HASH_TABLE_TYPE::OtherBucket(const Table &table, const KeyType &key, size_t bucket) {
+  size_t first;
+  size_t second;
+  Buckets(table, hash_fn_.GetHash(key), &first, &second);
+  return bucket == first ? second : first;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void CUCKOO_HASH_TABLE_TYPE::WritePair(const Table &table, size_t bucket, uint32_t slot, const MappingType &pair) {
+  Page *page = FetchBucketPage(table, bucket);
+  auto *cuckoo = reinterpret_cast<CuckooPage *>(page->GetData());
+  auto offset = static_cast<uint32_t>(bucket % CUCKOO_BUCKET_ARRAY_SIZE);
+  if (slot == CUCKOO_SLOTS) {
+    cuckoo->Insert(offset, pair);
+  } else {
+    cuckoo->SetAt(offset, slot, pair);
+  }
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+}
+
+/*
+ * Breadth first search from the two buckets of pair. Each step names a full
+ * bucket and the slot of its parent bucket whose pair can move there; the
+ * search ends at the first bucket with a free slot. A bucket is visited
+ * once, so the buckets of the chain are all different.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool CUCKOO_HASH_TABLE_TYPE::Place(const Table &table, const MappingType &pair) {
+  size_t first;
+  size_t second;
+  Buckets(table, hash_fn_.GetHash(pair.first), &first, &second);
+  for (size_t bucket : {first, second}) {
+    Page *page = FetchBucketPage(table, bucket);
+    bool inserted = reinterpret_cast<CuckooPage *>(page->GetData())
+                        ->Insert(static_cast<uint32_t>(bucket % CUCKOO_BUCKET_ARRAY_SIZE), pair);
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), inserted);
+    if (inserted) {
+      return true;
+    }
+  }
+
+  struct Step {
+    size_t bucket_;
+    size_t parent_;
+    uint32_t slot_;
+  };
+  constexpr size_t no_parent = static_cast<size_t>(-1);
+  std::vector<Step> steps{{first, no_parent, 0}, {second, no_parent, 0}};
+  std::unordered_set<size_t> visited{first, second};
+  bool found = false;
+  for (size_t i = 0; !found && i < steps.size() && steps.size() < MAX_SEARCH_BUCKETS; i++) {
+    Page *page = FetchBucketPage(table, steps[i].bucket_);
+    auto *cuckoo = reinterpret_cast<CuckooPage *>(page->GetData());
+    auto offset = static_cast<uint32_t>(steps[i].bucket_ % CUCKOO_BUCKET_ARRAY_SIZE);
+    for (uint32_t slot = 0; !found && slot < CUCKOO_SLOTS; slot++) {
+      size_t other = OtherBucket(table, cuckoo->PairAt(offset, slot).first, steps[i].bucket_);
+      if (!visited.insert(other).second) {
+        continue;
+      }
+      Page *other_page = FetchBucketPage(table, other);
+      found = !reinterpret_cast<CuckooPage *>(other_page->GetData())
+                   ->IsFull(static_cast<uint32_t>(other % CUCKOO_BUCKET_ARRAY_SIZE));
+      buffer_pool_manager_->UnpinPage(other_page->GetPageId(), false);
+      steps.push_back(Step{other, i, slot});
+    }
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  }
+  if (!found) {
+    return false;
+  }
+
+  //从链尾开始移动：每一步空出的slot正好给前一步用
+  size_t step = steps.size() - 1;
+  uint32_t free_slot = CUCKOO_SLOTS;
+  while (steps[step].parent_ != no_parent) {
+    const Step &to = steps[step];
+    const Step &from = steps[to.parent_];
+    Page *page = FetchBucketPage(table, from.bucket_);
+    MappingType moved = reinterpret_cast<CuckooPage *>(page->GetData())
+                            ->PairAt(static_cast<uint32_t>(from.bucket_ % CUCKOO_BUCKET_ARRAY_SIZE), to.slot_);
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    WritePair(table, to.bucket_, free_slot, moved);
+    free_slot = to.slot_;
+    step = to.parent_;
+  }
+  WritePair(table, steps[step].bucket_, free_slot, pair);
+  return true;
+}
+
+template class CuckooHashTable<int, int, IntComparator>;
+
+template class CuckooHashTable<GenericKey<4>, RID, GenericComparator<4>>;
+template class CuckooHashTable<GenericKey<8>, RID, GenericComparator<8>>;
+template class CuckooHashTable<GenericKey<16>, RID, GenericComparator<16>>;
+template class CuckooHashTable<GenericKey<32>, RID, GenericComparator<32>>;
+template class CuckooHashTable<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -0,0 +1,267 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table.cpp
+//
+// Identification: src/container/hash/extendible_hash_table.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/rid.h"
+#include "container/hash/extendible_hash_table.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+EXTENDIBLE_HASH_TABLE_TYPE::ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                                                const KeyComparator &comparator, HashFunction<KeyType> hash_fn)
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
+  Page *page = buffer_pool_manager_->NewPage(&directory_page_id_);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no frame left for a hash table directory page");
+  }
+  //NewPage已经清零：global depth和local depth都是0，bucket也是空的
+  auto *directory = reinterpret_cast<HashTableDirectoryPage *>(page->GetData());
+  directory->SetPageId(directory_page_id_);
+  page_id_t bucket_page_id;
+  if (buffer_pool_manager_->NewPage(&bucket_page_id) == nullptr) {
+    buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no frame left for a hash table bucket page");
+  }
+  directory->SetBucketPageId(0, bucket_page_id);
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+}
+
+/*****************************************************************************
+ * HELPERS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t EXTENDIBLE_HASH_TABLE_TYPE::Hash(const KeyType &key) {
+  return static_cast<uint32_t>(hash_fn_.GetHash(key));
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+HashTableDirectoryPage *EXTENDIBLE_HASH_TABLE_TYPE::FetchDirectoryPage() {
+  Page *page = buffer_pool_manager_->FetchPage(directory_page_id_);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no frame left for the hash table directory page");
+  }
+  return reinterpret_cast<HashTableDirectoryPage *>(page->GetData());
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *EXTENDIBLE_HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(bucket_page_id);
+  if (page == nullptr) {
+    buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no frame left for a hash table bucket page");
+  }
+  return page;
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key,
+                                          std::vector<ValueType> *result) {
+  table_latch_.RLock();
+  HashTableDirectoryPage *directory = FetchDirectoryPage();
+  page_id_t bucket_page_id = directory->GetBucketPageId(Hash(key) & directory->GetGlobalDepthMask());
+  Page *page = FetchBucketPage(bucket_page_id);
+  page->RLatch();
+  bool found = reinterpret_cast<BucketPage *>(page->GetData())->GetValue(key, comparator_, result);
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  return found;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.RLock();
+  HashTableDirectoryPage *directory = FetchDirectoryPage();
+  page_id_t bucket_page_id = directory->GetBucketPageId(Hash(key) & directory->GetGlobalDepthMask());
+  Page *page = FetchBucketPage(bucket_page_id);
+  auto *bucket = reinterpret_cast<BucketPage *>(page->GetData());
+  bool inserted = false;
+  bool split = false;
+  page->WLatch();
+  if (!bucket->IsFull()) {
+    inserted = bucket->Insert(key, value, comparator_);
+  } else {
+    split = !bucket->Contains(key, value, comparator_);
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, inserted);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  //bucket满了才需要独占latch去split
+  return split ? SplitInsert(key, value) : inserted;
+}
+
+/*
+ * The bucket is re-checked under the exclusive latch: another insert may have
+ * split it or a remove may have freed a slot in between.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::SplitInsert(const KeyType &key, const ValueType &value) {
+  table_latch_.WLock();
+  HashTableDirectoryPage *directory = FetchDirectoryPage();
+  uint32_t hash = Hash(key);
+  bool inserted = false;
+  while (true) {
+    uint32_t bucket_idx = hash & directory->GetGlobalDepthMask();
+    page_id_t bucket_page_id = directory->GetBucketPageId(bucket_idx);
+    Page *page = FetchBucketPage(bucket_page_id);
+    auto *bucket = reinterpret_cast<BucketPage *>(page->GetData());
+    if (!bucket->IsFull() || bucket->Contains(key, value, comparator_)) {
+      inserted = bucket->Insert(key, value, comparator_);
+      buffer_pool_manager_->UnpinPage(bucket_page_id, inserted);
+      break;
+    }
+    uint32_t local_depth = directory->GetLocalDepth(bucket_idx);
+    if (local_depth == directory->GetGlobalDepth()) {
+      if (local_depth == HashTableDirectoryPage::MAX_DEPTH) {
+        // 目录已经最大：同一个hash的pair太多，split也分不开
+        buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+        break;
+      }
+      directory->IncrGlobalDepth();
+    }
+
+    page_id_t image_page_id;
+    Page *image_page = buffer_pool_manager_->NewPage(&image_page_id);
+    if (image_page == nullptr) {
+      buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+      buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+      table_latch_.WUnlock();
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "no frame left for a hash table bucket page");
+    }
+    auto *image = reinterpret_cast<BucketPage *>(image_page->GetData());
+    //新增的一位为1的pair搬到split image
+    uint32_t high_bit = 1U << local_depth;
+    for (uint32_t i = 0; i < BUCKET_ARRAY_SIZE && bucket->IsOccupied(i); i++) {
+      if (bucket->IsReadable(i) && (Hash(bucket->KeyAt(i)) & high_bit) != 0) {
+        image->Insert(bucket->KeyAt(i), bucket->ValueAt(i), comparator_);
+        bucket->RemoveAt(i);
+      }
+    }
+    for (uint32_t i = 0; i < directory->Size(); i++) {
+      if (directory->GetBucketPageId(i) == bucket_page_id) {
+        directory->SetLocalDepth(i, local_depth + 1);
+        if ((i & high_bit) != 0) {
+          directory->SetBucketPageId(i, image_page_id);
+        }
+      }
+    }
+    buffer_pool_manager_->UnpinPage(image_page_id, true);
+    buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+  table_latch_.WUnlock();
+  return inserted;
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.RLock();
+  HashTableDirectoryPage *directory = FetchDirectoryPage();
+  uint32_t bucket_idx = Hash(key) & directory->GetGlobalDepthMask();
+  page_id_t bucket_page_id = directory->GetBucketPageId(bucket_idx);
+  bool can_merge = directory->GetLocalDepth(bucket_idx) > 0;
+  Page *page = FetchBucketPage(bucket_page_id);
+  auto *bucket = reinterpret_cast<BucketPage *>(page->GetData());
+  page->WLatch();
+  bool removed = bucket->Remove(key, value, comparator_);
+  bool empty = bucket->IsEmpty();
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, removed);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  if (removed && empty && can_merge) {
+    Merge(key);
+  }
+  return removed;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_TYPE::Merge(const KeyType &key) {
+  table_latch_.WLock();
+  HashTableDirectoryPage *directory = FetchDirectoryPage();
+  uint32_t bucket_idx = Hash(key) & directory->GetGlobalDepthMask();
+  uint32_t local_depth = directory->GetLocalDepth(bucket_idx);
+  bool changed = false;
+  //只和local depth相同的split image合并
+  if (local_depth > 0 && directory->GetLocalDepth(directory->GetSplitImageIndex(bucket_idx)) == local_depth) {
+    page_id_t bucket_page_id = directory->GetBucketPageId(bucket_idx);
+    page_id_t image_page_id = directory->GetBucketPageId(directory->GetSplitImageIndex(bucket_idx));
+    Page *page = FetchBucketPage(bucket_page_id);
+    bool empty = reinterpret_cast<BucketPage *>(page->GetData())->IsEmpty();
+    buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+    if (empty) {
+      for (uint32_t i = 0; i < directory->Size(); i++) {
+        page_id_t page_id = directory->GetBucketPageId(i);
+        if (page_id == bucket_page_id || page_id == image_page_id) {
+          directory->SetBucketPageId(i, image_page_id);
+          directory->SetLocalDepth(i, local_depth - 1);
+        }
+      }
+      buffer_pool_manager_->DeletePage(bucket_page_id);
+      while (directory->CanShrink()) {
+        directory->DecrGlobalDepth();
+      }
+      changed = true;
+    }
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, changed);
+  table_latch_.WUnlock();
+}
+
+/*****************************************************************************
+ * GETGLOBALDEPTH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t EXTENDIBLE_HASH_TABLE_TYPE::GetGlobalDepth() {
+  table_latch_.RLock();
+  uint32_t global_depth = FetchDirectoryPage()->GetGlobalDepth();
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  return global_depth;
+}
+
+/*****************************************************************************
+ * VERIFY INTEGRITY
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_TYPE::VerifyIntegrity() {
+  table_latch_.RLock();
+  FetchDirectoryPage()->VerifyIntegrity();
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+}
+
+template class ExtendibleHashTable<int, int, IntComparator>;
+
+template class ExtendibleHashTable<GenericKey<4>, RID, GenericComparator<4>>;
+template class ExtendibleHashTable<GenericKey<8>, RID, GenericComparator<8>>;
+template class ExtendibleHashTable<GenericKey<16>, RID, GenericComparator<16>>;
+template class ExtendibleHashTable<GenericKey<32>, RID, GenericComparator<32>>;
+template class ExtendibleHashTable<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
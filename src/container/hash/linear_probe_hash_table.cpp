@@ -10,7 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
+#include <memory>
+#include <numeric>
 #include <string>
 #include <utility>
 #include <vector>
@@ -26,21 +29,108 @@ template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
                                       const KeyComparator &comparator, size_t num_buckets,
                                       HashFunction<KeyType> hash_fn)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {}
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
+  auto state = std::make_shared<State>();
+  state->current_ = NewTable(num_buckets);
+  header_page_id_ = state->current_->header_page_id_;
+  state_ = std::move(state);
+}
 
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) {
-  return false;
+  uint64_t hash = hash_fn_.GetHash(key);
+  size_t start = result->size();
+  std::vector<ValueType> values;
+  while (true) {
+    std::shared_ptr<const State> state = std::atomic_load(&state_);
+    result->resize(start);
+    values.clear();
+    if (state->old_ != nullptr) {
+      Find(*state->old_, hash, key, nullptr, result, nullptr);
+    }
+    Find(*state->current_, hash, key, nullptr, &values, nullptr);
+    //期间换了表：pair可能从没看的那张表搬进了新表，重来
+    if (std::atomic_load(&state_) == state) {
+      break;
+    }
+  }
+  AppendNew(values, start, result);
+  return result->size() > start;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+size_t HASH_TABLE_TYPE::GetValues(Transaction *transaction, const std::vector<KeyType> &keys,
+                                  std::vector<std::vector<ValueType>> *results) {
+  std::vector<uint64_t> hashes(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    hashes[i] = hash_fn_.GetHash(keys[i]);
+  }
+  std::vector<std::vector<ValueType>> values;
+  while (true) {
+    std::shared_ptr<const State> state = std::atomic_load(&state_);
+    results->assign(keys.size(), std::vector<ValueType>());
+    values.assign(keys.size(), std::vector<ValueType>());
+    if (state->old_ != nullptr) {
+      FindBatch(*state->old_, keys, hashes, results);
+    }
+    FindBatch(*state->current_, keys, hashes, &values);
+    if (std::atomic_load(&state_) == state) {
+      break;
+    }
+  }
+  size_t found = 0;
+  for (size_t i = 0; i < keys.size(); i++) {
+    AppendNew(values[i], 0, &(*results)[i]);
+    found += (*results)[i].empty() ? 0 : 1;
+  }
+  return found;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::AppendNew(const std::vector<ValueType> &values, size_t start, std::vector<ValueType> *result) {
+  //正在搬的pair可能两边都有，只报一次
+  size_t end = result->size();
+  for (const auto &value : values) {
+    if (std::find(result->begin() + start, result->begin() + end, value) == result->begin() + end) {
+      result->push_back(value);
+    }
+  }
 }
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  return false;
+  uint64_t hash = hash_fn_.GetHash(key);
+  while (true) {
+    table_latch_.RLock();
+    std::shared_ptr<const State> state = std::atomic_load(&state_);
+    Table *current = state->current_.get();
+    if (static_cast<double>(num_occupied_.load() + 1) > MAX_LOAD_FACTOR * static_cast<double>(current->size_)) {
+      table_latch_.RUnlock();
+      StartResize(current, 2 * current->size_);
+      continue;
+    }
+    bool migrated = MigrateSlots(*state, MIGRATE_SLOTS);
+    bool exists;
+    {
+      std::lock_guard<std::mutex> guard(KeyLatch(hash));
+      size_t slot;
+      exists = (state->old_ != nullptr && Find(*state->old_, hash, key, &value, nullptr, &slot)) ||
+               Find(*current, hash, key, &value, nullptr, &slot);
+      if (!exists) {
+        InsertInto(current, hash, key, value);
+      }
+    }
+    table_latch_.RUnlock();
+    if (migrated) {
+      FinishMigration(state->old_.get());
+    }
+    return !exists;
+  }
 }
 
 /*****************************************************************************
@@ -48,21 +138,369 @@ bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  return false;
+  uint64_t hash = hash_fn_.GetHash(key);
+  table_latch_.RLock();
+  std::shared_ptr<const State> state = std::atomic_load(&state_);
+  bool migrated = MigrateSlots(*state, MIGRATE_SLOTS);
+  bool found = true;
+  {
+    std::lock_guard<std::mutex> guard(KeyLatch(hash));
+    size_t slot;
+    if (state->old_ != nullptr && Find(*state->old_, hash, key, &value, nullptr, &slot)) {
+      RemoveAt(*state->old_, slot);
+    } else if (Find(*state->current_, hash, key, &value, nullptr, &slot)) {
+      RemoveAt(*state->current_, slot);
+    } else {
+      found = false;
+    }
+  }
+  table_latch_.RUnlock();
+  if (migrated) {
+    FinishMigration(state->old_.get());
+  }
+  return found;
 }
 
 /*****************************************************************************
  * RESIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Resize(size_t initial_size) {}
+void HASH_TABLE_TYPE::Resize(size_t initial_size) {
+  std::shared_ptr<const State> state = std::atomic_load(&state_);
+  //不缩小：新表至少和当前表一样大
+  StartResize(state->current_.get(), std::max(2 * initial_size, state->current_->size_));
+}
 
 /*****************************************************************************
  * GETSIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 size_t HASH_TABLE_TYPE::GetSize() {
-  return 0;
+  return std::atomic_load(&state_)->current_->size_;
+}
+
+/*****************************************************************************
+ * TABLES
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+HASH_TABLE_TYPE::Table::~Table() {
+  if (!retired_.load()) {
+    return;
+  }
+  for (page_id_t block_page_id : block_page_ids_) {
+    buffer_pool_manager_->DeletePage(block_page_id);
+  }
+  if (header_page_id_ != INVALID_PAGE_ID) {
+    buffer_pool_manager_->DeletePage(header_page_id_);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+std::shared_ptr<typename HASH_TABLE_TYPE::Table> HASH_TABLE_TYPE::NewTable(size_t num_buckets) {
+  auto table = std::make_shared<Table>();
+  table->buffer_pool_manager_ = buffer_pool_manager_;
+  table->size_ = std::max<size_t>(num_buckets, 1);
+  size_t num_blocks = (table->size_ - 1) / BLOCK_ARRAY_SIZE + 1;
+  if (num_blocks > HashTableHeaderPage::MAX_BLOCKS) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "too many buckets for one hash table header page");
+  }
+  Page *page = buffer_pool_manager_->NewPage(&table->header_page_id_);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no frame left for a hash table header page");
+  }
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(page->GetData());
+  header->SetPageId(table->header_page_id_);
+  header->SetSize(table->size_);
+  for (size_t i = 0; i < num_blocks; i++) {
+    page_id_t block_page_id;
+    //NewPage已经清零，全空的block不用再初始化
+    if (buffer_pool_manager_->NewPage(&block_page_id) == nullptr) {
+      buffer_pool_manager_->UnpinPage(table->header_page_id_, true);
+      // 已经分配的page随table一起删掉
+      table->retired_ = true;
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "no frame left for a hash table block page");
+    }
+    header->AddBlockPageId(block_page_id);
+    table->block_page_ids_.push_back(block_page_id);
+    buffer_pool_manager_->UnpinPage(block_page_id, true);
+  }
+  buffer_pool_manager_->UnpinPage(table->header_page_id_, true);
+  return table;
+}
+
+/*****************************************************************************
+ * PROBING
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename Fn>
+size_t HASH_TABLE_TYPE::Probe(const Table &table, uint64_t hash, uint8_t tag, Fn &&fn, BlockPage *home) {
+  size_t slot = hash % table.size_;
+  size_t visited = 0;
+  while (visited < table.size_) {
+    size_t block_index = slot / BLOCK_ARRAY_SIZE;
+    page_id_t block_page_id = table.block_page_ids_[block_index];
+    //第一个block是调用者已经pin住的home block
+    bool pinned = home != nullptr && visited == 0;
+    BlockPage *block = home;
+    if (!pinned) {
+      Page *page = buffer_pool_manager_->FetchPage(block_page_id);
+      if (page == nullptr) {
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "no frame left for a hash table block page");
+      }
+      block = reinterpret_cast<BlockPage *>(page->GetData());
+    }
+    //最后一个block可能只用了一部分
+    size_t block_end = std::min((block_index + 1) * BLOCK_ARRAY_SIZE, table.size_);
+    bool stop = false;
+    size_t end_slot = table.size_;
+    while (!stop && slot < block_end && visited < table.size_) {
+      auto offset = static_cast<slot_offset_t>(slot % BLOCK_ARRAY_SIZE);
+      size_t count = std::min<size_t>({BlockPage::GROUP_SIZE, block_end - slot, table.size_ - visited});
+      uint32_t window = (1U << count) - 1;
+      //探测链在这一组里的第一个空slot结束，它之后的tag不算
+      uint32_t empty = block->MatchEmpty(offset) & window;
+      uint32_t limit = empty == 0 ? count : __builtin_ctz(empty);
+      uint32_t match = block->MatchTag(offset, tag) & ((1U << limit) - 1);
+      for (; match != 0 && !stop; match &= match - 1) {
+        uint32_t i = __builtin_ctz(match);
+        stop = !fn(block, static_cast<slot_offset_t>(offset + i), slot + i);
+      }
+      if (!stop && empty != 0) {
+        end_slot = slot + limit;
+        stop = true;
+      }
+      slot += count;
+      visited += count;
+    }
+    if (!pinned) {
+      buffer_pool_manager_->UnpinPage(block_page_id, false);
+    }
+    if (stop) {
+      return end_slot;
+    }
+    if (slot == table.size_) {
+      slot = 0;
+    }
+  }
+  return table.size_;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::Find(const Table &table, uint64_t hash, const KeyType &key, const ValueType *value,
+                           std::vector<ValueType> *result, size_t *slot, BlockPage *home) {
+  bool found = false;
+  auto match = [&](BlockPage *block, slot_offset_t offset, size_t current) {
+    KeyType slot_key;
+    ValueType slot_value;
+    if (!block->ReadSlot(offset, &slot_key, &slot_value) || comparator_(slot_key, key) != 0) {
+      return true;
+    }
+    if (value == nullptr) {
+      result->push_back(slot_value);
+      found = true;
+      return true;
+    }
+    if (slot_value == *value) {
+      *slot = current;
+      found = true;
+      return false;
+    }
+    return true;
+  };
+  //tag一致才读出整个pair比较key
+  Probe(table, hash, BlockPage::HashTag(hash), match, home);
+  return found;
+}
+
+/*
+ * Group prefetching: the keys are sorted by home slot and cut into runs of
+ * the same home block, which is fetched once. Within a run, the tags and the
+ * first pair of PREFETCH_GROUP probes are prefetched, then the probes run on
+ * memory that is (mostly) in the cache already. Only a probe sequence that
+ * leaves its home block fetches more pages.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::FindBatch(const Table &table, const std::vector<KeyType> &keys,
+                                const std::vector<uint64_t> &hashes, std::vector<std::vector<ValueType>> *results) {
+  std::vector<size_t> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&](size_t a, size_t b) { return hashes[a] % table.size_ < hashes[b] % table.size_; });
+  size_t begin = 0;
+  while (begin < order.size()) {
+    size_t block_index = hashes[order[begin]] % table.size_ / BLOCK_ARRAY_SIZE;
+    size_t end = begin + 1;
+    while (end < order.size() && hashes[order[end]] % table.size_ / BLOCK_ARRAY_SIZE == block_index) {
+      end++;
+    }
+    page_id_t block_page_id = table.block_page_ids_[block_index];
+    Page *page = buffer_pool_manager_->FetchPage(block_page_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "no frame left for a hash table block page");
+    }
+    auto *block = reinterpret_cast<BlockPage *>(page->GetData());
+    for (size_t group = begin; group < end; group += PREFETCH_GROUP) {
+      size_t group_end = std::min(group + PREFETCH_GROUP, end);
+      for (size_t i = group; i < group_end; i++) {
+        block->Prefetch(static_cast<slot_offset_t>(hashes[order[i]] % table.size_ % BLOCK_ARRAY_SIZE));
+      }
+      for (size_t i = group; i < group_end; i++) {
+        size_t key_index = order[i];
+        Find(table, hashes[key_index], keys[key_index], nullptr, &(*results)[key_index], nullptr, block);
+      }
+    }
+    buffer_pool_manager_->UnpinPage(block_page_id, false);
+    begin = end;
+  }
+}
+
+/*
+ * Writers of other keys race for the same free slots: the one whose block
+ * Insert fails probes again.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::InsertInto(Table *table, uint64_t hash, const KeyType &key, const ValueType &value) {
+  while (true) {
+    //第一个tombstone，否则探测链末尾的空slot
+    size_t tombstone = table->size_;
+    size_t empty =
+        Probe(*table, hash, BlockPage::TAG_TOMBSTONE, [&](BlockPage *block, slot_offset_t offset, size_t current) {
+          tombstone = current;
+          return false;
+        });
+    bool reuse = tombstone != table->size_;
+    size_t slot = reuse ? tombstone : empty;
+    BUSTUB_ASSERT(slot < table->size_, "hash table is full");
+    page_id_t block_page_id = table->block_page_ids_[slot / BLOCK_ARRAY_SIZE];
+    Page *page = buffer_pool_manager_->FetchPage(block_page_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "no frame left for a hash table block page");
+    }
+    bool inserted = reinterpret_cast<BlockPage *>(page->GetData())
+                        ->Insert(static_cast<slot_offset_t>(slot % BLOCK_ARRAY_SIZE), key, value,
+                                 BlockPage::HashTag(hash));
+    buffer_pool_manager_->UnpinPage(block_page_id, inserted);
+    if (inserted) {
+      if (!reuse) {
+        num_occupied_++;
+      }
+      return;
+    }
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::RemoveAt(const Table &table, size_t slot) {
+  page_id_t block_page_id = table.block_page_ids_[slot / BLOCK_ARRAY_SIZE];
+  Page *page = buffer_pool_manager_->FetchPage(block_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no frame left for a hash table block page");
+  }
+  reinterpret_cast<BlockPage *>(page->GetData())->Remove(static_cast<slot_offset_t>(slot % BLOCK_ARRAY_SIZE));
+  buffer_pool_manager_->UnpinPage(block_page_id, true);
+}
+
+/*****************************************************************************
+ * MIGRATION
+ *****************************************************************************/
+/*
+ * Each writer claims the next count slots of the old table. An entry is
+ * moved under the latch of its key, so it cannot be removed (or inserted
+ * again) meanwhile, and it is inserted into the new table before it is
+ * removed from the old one: a lookup going through the old table and then
+ * the new one sees it at least once.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::MigrateSlots(const State &state, size_t count) {
+  if (state.old_ == nullptr) {
+    return false;
+  }
+  const Table &old = *state.old_;
+  size_t begin = migrate_cursor_.fetch_add(count);
+  if (begin >= old.size_) {
+    return false;
+  }
+  size_t end = std::min(old.size_, begin + count);
+  for (size_t slot = begin; slot < end;) {
+    size_t block_index = slot / BLOCK_ARRAY_SIZE;
+    page_id_t block_page_id = old.block_page_ids_[block_index];
+    Page *page = buffer_pool_manager_->FetchPage(block_page_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "no frame left for a hash table block page");
+    }
+    auto *block = reinterpret_cast<BlockPage *>(page->GetData());
+    size_t block_end = std::min(end, (block_index + 1) * BLOCK_ARRAY_SIZE);
+    for (; slot < block_end; slot++) {
+      auto offset = static_cast<slot_offset_t>(slot % BLOCK_ARRAY_SIZE);
+      KeyType key;
+      ValueType value;
+      if (!block->ReadSlot(offset, &key, &value)) {
+        continue;
+      }
+      uint64_t hash = hash_fn_.GetHash(key);
+      std::lock_guard<std::mutex> guard(KeyLatch(hash));
+      // 拿到latch之前可能已经被remove了；旧表不再有insert，slot不会被别的pair占用
+      if (!block->ReadSlot(offset, &key, &value)) {
+        continue;
+      }
+      InsertInto(state.current_.get(), hash, key, value);
+      block->Remove(offset);
+    }
+    buffer_pool_manager_->UnpinPage(block_page_id, true);
+  }
+  return migrated_.fetch_add(end - begin) + (end - begin) == old.size_;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::FinishMigration(const Table *old) {
+  std::lock_guard<std::mutex> guard(resize_latch_);
+  std::shared_ptr<const State> state = std::atomic_load(&state_);
+  if (state->old_.get() != old) {
+    return;
+  }
+  auto next = std::make_shared<State>();
+  next->current_ = state->current_;
+  //最后一个拿着旧State的操作结束时，旧表的page才被删掉
+  state->old_->retired_ = true;
+  table_latch_.WLock();
+  // 独占latch等到了所有writer离开：认领过的slot都已经搬完
+  BUSTUB_ASSERT(migrated_.load() == old->size_, "old table is not migrated");
+  std::atomic_store(&state_, std::shared_ptr<const State>(std::move(next)));
+  table_latch_.WUnlock();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::StartResize(const Table *current, size_t num_buckets) {
+  std::unique_lock<std::mutex> guard(resize_latch_);
+  std::shared_ptr<const State> state = std::atomic_load(&state_);
+  if (state->current_.get() != current) {
+    // 别的writer已经resize过了
+    return;
+  }
+  if (state->old_ != nullptr) {
+    //上一次resize还没搬完（表增长得比搬迁快），先搬完剩下的
+    table_latch_.RLock();
+    MigrateSlots(*state, state->old_->size_);
+    table_latch_.RUnlock();
+    guard.unlock();
+    FinishMigration(state->old_.get());
+    guard.lock();
+    state = std::atomic_load(&state_);
+    if (state->current_.get() != current || state->old_ != nullptr) {
+      return;
+    }
+  }
+  //分配新表的page I/O在latch之外
+  auto next = std::make_shared<State>();
+  next->current_ = NewTable(num_buckets);
+  next->old_ = state->current_;
+  table_latch_.WLock();
+  migrate_cursor_ = 0;
+  migrated_ = 0;
+  num_occupied_ = 0;
+  header_page_id_ = next->current_->header_page_id_;
+  std::atomic_store(&state_, std::shared_ptr<const State>(std::move(next)));
+  table_latch_.WUnlock();
 }
 
 template class LinearProbeHashTable<int, int, IntComparator>;
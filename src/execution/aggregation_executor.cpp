@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "execution/executors/aggregation_executor.h"
@@ -18,12 +19,67 @@ namespace bustub {
 
 AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
                                          std::unique_ptr<AbstractExecutor> &&child)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_(std::move(child)),
+      aht_(plan->GetAggregates(), plan->GetAggregateTypes()),
+      aht_iterator_(aht_.Begin()) {}
 
 const AbstractExecutor *AggregationExecutor::GetChildExecutor() const { return child_.get(); }
 
-void AggregationExecutor::Init() {}
+void AggregationExecutor::Init() {
+  child_->Init();
+  const Schema *child_schema = child_->GetOutputSchema();
+  const auto &group_bys = plan_->GetGroupBys();
+  const auto &aggregates = plan_->GetAggregates();
+  // 按列求值：每个表达式对整个batch调用一次
+  std::vector<std::vector<Value>> key_columns(group_bys.size());
+  std::vector<std::vector<Value>> val_columns(aggregates.size());
+  TupleBatch batch;
+  while (child_->NextBatch(&batch)) {
+    for (uint32_t i = 0; i < group_bys.size(); i++) {
+      group_bys[i]->EvaluateBatch(batch, child_schema, &key_columns[i]);
+    }
+    for (uint32_t i = 0; i < aggregates.size(); i++) {
+      aggregates[i]->EvaluateBatch(batch, child_schema, &val_columns[i]);
+    }
+    AggregateKey key;
+    AggregateValue val;
+    key.group_bys_.resize(group_bys.size());
+    val.aggregates_.resize(aggregates.size());
+    for (uint32_t row = 0; row < batch.Size(); row++) {
+      for (uint32_t i = 0; i < group_bys.size(); i++) {
+        key.group_bys_[i] = key_columns[i][row];
+      }
+      for (uint32_t i = 0; i < aggregates.size(); i++) {
+        val.aggregates_[i] = val_columns[i][row];
+      }
+      aht_.InsertCombine(key, val);
+    }
+  }
+  aht_iterator_ = aht_.Begin();
+  ResetNextFromBatch();
+}
 
-bool AggregationExecutor::Next(Tuple *tuple, RID *rid) { return false; }
+bool AggregationExecutor::Next(Tuple *tuple, RID *rid) { return NextFromBatch(tuple, rid); }
+
+bool AggregationExecutor::NextBatch(TupleBatch *batch) {
+  const Schema *out_schema = GetOutputSchema();
+  batch->Reset(out_schema->GetColumnCount());
+  std::vector<Value> values(out_schema->GetColumnCount());
+  for (; !batch->IsFull() && aht_iterator_ != aht_.End(); ++aht_iterator_) {
+    const auto &group_bys = aht_iterator_.Key().group_bys_;
+    const auto &aggregates = aht_iterator_.Val().aggregates_;
+    if (plan_->GetHaving() != nullptr &&
+        !plan_->GetHaving()->EvaluateAggregate(group_bys, aggregates).GetAs<bool>()) {
+      continue;
+    }
+    for (uint32_t i = 0; i < values.size(); i++) {
+      values[i] = out_schema->GetColumn(i).GetExpr()->EvaluateAggregate(group_bys, aggregates);
+    }
+    batch->AppendRow(values, RID());
+  }
+  return batch->Size() > 0;
+}
 
 }  // namespace bustub
@@ -0,0 +1,220 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_executor.cpp
+//
+// Identification: src/execution/hash_join_executor.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "execution/executors/hash_join_executor.h"
+
+namespace bustub {
+
+HashJoinExecutor::HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
+                                   std::unique_ptr<AbstractExecutor> &&left_executor,
+                                   std::unique_ptr<AbstractExecutor> &&right_executor)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      left_executor_(std::move(left_executor)),
+      right_executor_(std::move(right_executor)) {}
+
+TypeId HashJoinExecutor::JoinKeyType(TypeId left, TypeId right) {
+  if (left == right) {
+    return left;
+  }
+  auto is_numeric = [](TypeId type) { return type >= TypeId::TINYINT && type <= TypeId::DECIMAL; };
+  if (!is_numeric(left) || !is_numeric(right)) {
+    throw Exception(ExceptionType::MISMATCH_TYPE, "hash join keys of incomparable types");
+  }
+  return left == TypeId::DECIMAL || right == TypeId::DECIMAL ? TypeId::DECIMAL : TypeId::BIGINT;
+}
+
+bool HashJoinExecutor::ReadBatch(AbstractExecutor *child, const AbstractExpression *key_expr, JoinRows *rows) {
+  if (!child->NextBatch(&read_batch_)) {
+    return false;
+  }
+  const Schema *schema = child->GetOutputSchema();
+  key_expr->EvaluateBatch(read_batch_, schema, &read_keys_);
+  for (uint32_t i = 0; i < read_batch_.Size(); i++) {
+    if (read_keys_[i].IsNull()) {
+      continue;
+    }
+    if (read_keys_[i].GetTypeId() != key_type_) {
+      read_keys_[i] = read_keys_[i].CastAs(key_type_);
+    }
+    rows->tuples_.push_back(read_batch_.GetTuple(i, schema));
+    rows->hashes_.push_back(HashUtil::HashValue(&read_keys_[i]));
+    rows->keys_.push_back(std::move(read_keys_[i]));
+  }
+  return true;
+}
+
+void HashJoinExecutor::Init() {
+  left_executor_->Init();
+  right_executor_->Init();
+  build_ = JoinRows();
+  probe_ = JoinRows();
+  const AbstractExpression *left_key = plan_->LeftJoinKeyExpression();
+  const AbstractExpression *right_key = plan_->RightJoinKeyExpression();
+  key_type_ = JoinKeyType(left_key->GetReturnType(), right_key->GetReturnType());
+  while (ReadBatch(left_executor_.get(), left_key, &build_)) {
+  }
+  // 右边只读到比左边多为止，多出来的部分在probe时再读
+  probe_child_ = right_executor_.get();
+  while (probe_.tuples_.size() <= build_.tuples_.size()) {
+    if (!ReadBatch(right_executor_.get(), right_key, &probe_)) {
+      probe_child_ = nullptr;
+      break;
+    }
+  }
+  build_is_left_ = true;
+  if (probe_child_ == nullptr && probe_.tuples_.size() < build_.tuples_.size()) {
+    std::swap(build_, probe_);
+    build_is_left_ = false;
+  }
+  if (build_.tuples_.empty()) {
+    // 没有可连接的行，probe边不用再读
+    probe_child_ = nullptr;
+    probe_ = JoinRows();
+  }
+
+  // 每行在hash表里占一个entry、一个key和至多一个bucket
+  size_t table_size = build_.tuples_.size() * (sizeof(Entry) + sizeof(Value) + sizeof(uint32_t));
+  radix_bits_ = 0;
+  while ((table_size >> radix_bits_) > L2_CACHE_SIZE) {
+    radix_bits_++;
+  }
+  PartitionRows();
+
+  cur_partition_ = 0;
+  BuildTable(partitions_[0].build_rows_);
+  probe_pos_ = 0;
+  entry_pos_ = 0;
+  entry_end_ = 0;
+  ResetNextFromBatch();
+}
+
+void HashJoinExecutor::PartitionRows() {
+  partitions_.assign(static_cast<size_t>(1) << radix_bits_, Partition());
+  if (radix_bits_ == 0) {
+    partitions_[0].build_rows_.resize(build_.tuples_.size());
+    std::iota(partitions_[0].build_rows_.begin(), partitions_[0].build_rows_.end(), 0);
+    partitions_[0].probe_rows_.resize(probe_.tuples_.size());
+    std::iota(partitions_[0].probe_rows_.begin(), partitions_[0].probe_rows_.end(), 0);
+    return;
+  }
+  // 分区要用到probe边的全部行
+  const AbstractExpression *probe_key =
+      build_is_left_ ? plan_->RightJoinKeyExpression() : plan_->LeftJoinKeyExpression();
+  while (probe_child_ != nullptr && ReadBatch(probe_child_, probe_key, &probe_)) {
+  }
+  probe_child_ = nullptr;
+  // 高位分区，低位分bucket，两者互不相关
+  size_t shift = sizeof(hash_t) * 8 - radix_bits_;
+  for (uint32_t i = 0; i < build_.hashes_.size(); i++) {
+    partitions_[build_.hashes_[i] >> shift].build_rows_.push_back(i);
+  }
+  for (uint32_t i = 0; i < probe_.hashes_.size(); i++) {
+    partitions_[probe_.hashes_[i] >> shift].probe_rows_.push_back(i);
+  }
+}
+
+void HashJoinExecutor::BuildTable(const std::vector<uint32_t> &build_rows) {
+  size_t num_buckets = 1;
+  while (num_buckets < build_rows.size()) {
+    num_buckets <<= 1;
+  }
+  bucket_mask_ = num_buckets - 1;
+  // 先数每个bucket的行数，前缀和得到各bucket的起点，再把entry放进去
+  bucket_offsets_.assign(num_buckets + 1, 0);
+  for (uint32_t row : build_rows) {
+    bucket_offsets_[(build_.hashes_[row] & bucket_mask_) + 1]++;
+  }
+  for (size_t b = 0; b < num_buckets; b++) {
+    bucket_offsets_[b + 1] += bucket_offsets_[b];
+  }
+  entries_.resize(build_rows.size());
+  entry_keys_.resize(build_rows.size());
+  std::vector<uint32_t> next(bucket_offsets_.begin(), bucket_offsets_.end() - 1);
+  for (uint32_t row : build_rows) {
+    uint32_t pos = next[build_.hashes_[row] & bucket_mask_]++;
+    entries_[pos] = {build_.hashes_[row], row};
+    entry_keys_[pos] = build_.keys_[row];
+  }
+}
+
+bool HashJoinExecutor::NextProbeRow() {
+  while (true) {
+    const auto &probe_rows = partitions_[cur_partition_].probe_rows_;
+    if (probe_pos_ < probe_rows.size()) {
+      probe_row_ = probe_rows[probe_pos_++];
+      size_t bucket = probe_.hashes_[probe_row_] & bucket_mask_;
+      entry_pos_ = bucket_offsets_[bucket];
+      entry_end_ = bucket_offsets_[bucket + 1];
+      return true;
+    }
+    if (cur_partition_ + 1 < partitions_.size()) {
+      cur_partition_++;
+      BuildTable(partitions_[cur_partition_].build_rows_);
+      probe_pos_ = 0;
+      continue;
+    }
+    // 没有分区时，probe边剩下的行一个batch一个batch地读
+    if (probe_child_ == nullptr) {
+      return false;
+    }
+    probe_.tuples_.clear();
+    probe_.keys_.clear();
+    probe_.hashes_.clear();
+    if (!ReadBatch(probe_child_, plan_->RightJoinKeyExpression(), &probe_)) {
+      probe_child_ = nullptr;
+      return false;
+    }
+    auto &rows = partitions_[cur_partition_].probe_rows_;
+    rows.resize(probe_.tuples_.size());
+    std::iota(rows.begin(), rows.end(), 0);
+    probe_pos_ = 0;
+  }
+}
+
+bool HashJoinExecutor::Next(Tuple *tuple, RID *rid) { return NextFromBatch(tuple, rid); }
+
+bool HashJoinExecutor::NextBatch(TupleBatch *batch) {
+  const Schema *out_schema = GetOutputSchema();
+  const Schema *left_schema = left_executor_->GetOutputSchema();
+  const Schema *right_schema = right_executor_->GetOutputSchema();
+  batch->Reset(out_schema->GetColumnCount());
+  std::vector<Value> values(out_schema->GetColumnCount());
+  while (!batch->IsFull()) {
+    if (entry_pos_ == entry_end_) {
+      if (!NextProbeRow()) {
+        break;
+      }
+      continue;
+    }
+    uint32_t pos = entry_pos_++;
+    if (entries_[pos].hash_ != probe_.hashes_[probe_row_] ||
+        entry_keys_[pos].CompareEquals(probe_.keys_[probe_row_]) != CmpBool::CmpTrue) {
+      continue;
+    }
+    const Tuple *build_tuple = &build_.tuples_[entries_[pos].row_];
+    const Tuple *probe_tuple = &probe_.tuples_[probe_row_];
+    const Tuple *left_tuple = build_is_left_ ? build_tuple : probe_tuple;
+    const Tuple *right_tuple = build_is_left_ ? probe_tuple : build_tuple;
+    for (uint32_t i = 0; i < values.size(); i++) {
+      values[i] = out_schema->GetColumn(i).GetExpr()->EvaluateJoin(left_tuple, left_schema, right_tuple, right_schema);
+    }
+    batch->AppendRow(values, RID());
+  }
+  return batch->Size() > 0;
+}
+
+}  // namespace bustub
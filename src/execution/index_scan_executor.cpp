@@ -11,12 +11,126 @@
 //===----------------------------------------------------------------------===//
 #include "execution/executors/index_scan_executor.h"
 
+#include "execution/expressions/column_value_expression.h"
+#include "type/value_factory.h"
+
 namespace bustub {
 IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
+
+void IndexScanExecutor::Init() {
+  Catalog *catalog = exec_ctx_->GetCatalog();
+  index_info_ = catalog->GetIndex(plan_->GetIndexOid());
+  table_info_ = catalog->GetTable(index_info_->table_name_);
+  Index *index = index_info_->index_.get();
+  const Schema &schema = table_info_->schema_;
+
+  // key列和included列由索引提供，其余的列要读表
+  std::vector<bool> covered(schema.GetColumnCount(), false);
+  if (index->IsCovering()) {
+    for (uint32_t attr : index->GetKeyAttrs()) {
+      covered[attr] = true;
+    }
+    for (uint32_t attr : index->GetIncludedAttrs()) {
+      covered[attr] = true;
+    }
+  }
+  index_only_ = index->IsCovering() && IsCovered(plan_->GetPredicate(), covered);
+  for (const auto &column : GetOutputSchema()->GetColumns()) {
+    index_only_ = index_only_ && IsCovered(column.GetExpr(), covered);
+  }
+
+  const Schema *key_schema = &index_info_->key_schema_;
+  std::vector<Value> key_values;
+  for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+    key_values.push_back(plan_->GetKeyValues()[i].CastAs(key_schema->GetColumn(i).GetType()));
+  }
+  Tuple key(key_values, key_schema);
+  rids_.clear();
+  included_.clear();
+  next_match_ = 0;
+  if (index_only_) {
+    index->ScanKey(key, &rids_, &included_, exec_ctx_->GetTransaction());
+    covered_row_.clear();
+    for (const auto &column : schema.GetColumns()) {
+      covered_row_.push_back(ValueFactory::GetZeroValueByType(column.GetType()));
+    }
+    const std::vector<uint32_t> &key_attrs = index->GetKeyAttrs();
+    for (uint32_t i = 0; i < key_attrs.size(); i++) {
+      covered_row_[key_attrs[i]] = plan_->GetKeyValues()[i].CastAs(schema.GetColumn(key_attrs[i]).GetType());
+    }
+  } else {
+    index->ScanKey(key, &rids_, exec_ctx_->GetTransaction());
+  }
+  ResetNextFromBatch();
+}
+
+bool IndexScanExecutor::IsCovered(const AbstractExpression *expr, const std::vector<bool> &covered) {
+  if (expr == nullptr) {
+    return true;
+  }
+  auto column_expr = dynamic_cast<const ColumnValueExpression *>(expr);
+  if (column_expr != nullptr) {
+    return covered[column_expr->GetColIdx()];
+  }
+  for (const auto *child : expr->GetChildren()) {
+    if (!IsCovered(child, covered)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool IndexScanExecutor::Next(Tuple *tuple, RID *rid) { return NextFromBatch(tuple, rid); }
 
-void IndexScanExecutor::Init() {}
+bool IndexScanExecutor::FillScanBatch() {
+  const Schema *table_schema = &table_info_->schema_;
+  scan_batch_.Reset(table_schema->GetColumnCount());
+  Tuple tuple;
+  while (!scan_batch_.IsFull() && next_match_ < rids_.size()) {
+    size_t i = next_match_++;
+    if (index_only_) {
+      const Schema *included_schema = index_info_->index_->GetIncludedSchema();
+      const std::vector<uint32_t> &included_attrs = index_info_->index_->GetIncludedAttrs();
+      for (uint32_t j = 0; j < included_attrs.size(); j++) {
+        covered_row_[included_attrs[j]] = included_[i].GetValue(included_schema, j);
+      }
+      scan_batch_.AppendRow(covered_row_, rids_[i]);
+      continue;
+    }
+    // 索引项指向的tuple可能已经被删除
+    if (table_info_->table_->GetTuple(rids_[i], &tuple, exec_ctx_->GetTransaction())) {
+      scan_batch_.AppendTuple(tuple, table_schema);
+    }
+  }
+  return scan_batch_.Size() > 0;
+}
 
-bool IndexScanExecutor::Next(Tuple *tuple, RID *rid) { return false; }
+bool IndexScanExecutor::NextBatch(TupleBatch *batch) {
+  const Schema *out_schema = GetOutputSchema();
+  const Schema *table_schema = &table_info_->schema_;
+  // 谓词可能把整批都过滤掉，继续读下一批
+  while (FillScanBatch()) {
+    if (plan_->GetPredicate() != nullptr) {
+      plan_->GetPredicate()->EvaluateBatch(scan_batch_, table_schema, &predicate_values_);
+      scan_batch_.Select(predicate_values_);
+      if (scan_batch_.Size() == 0) {
+        continue;
+      }
+    }
+    out_columns_.resize(out_schema->GetColumnCount());
+    for (uint32_t i = 0; i < out_columns_.size(); i++) {
+      out_schema->GetColumn(i).GetExpr()->EvaluateBatch(scan_batch_, table_schema, &out_columns_[i]);
+    }
+    out_rids_.clear();
+    for (uint32_t i = 0; i < scan_batch_.Size(); i++) {
+      out_rids_.push_back(scan_batch_.GetRid(i));
+    }
+    batch->SetColumns(&out_columns_, &out_rids_);
+    return true;
+  }
+  batch->Reset(out_schema->GetColumnCount());
+  return false;
+}
 
 }  // namespace bustub
@@ -10,16 +10,41 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <memory>
+#include <utility>
+
 #include "execution/executors/limit_executor.h"
 
 namespace bustub {
 
 LimitExecutor::LimitExecutor(ExecutorContext *exec_ctx, const LimitPlanNode *plan,
                              std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
+
+void LimitExecutor::Init() {
+  child_executor_->Init();
+  skipped_ = 0;
+  emitted_ = 0;
+  ResetNextFromBatch();
+}
 
-void LimitExecutor::Init() {}
+bool LimitExecutor::Next(Tuple *tuple, RID *rid) { return NextFromBatch(tuple, rid); }
 
-bool LimitExecutor::Next(Tuple *tuple, RID *rid) { return false; }
+bool LimitExecutor::NextBatch(TupleBatch *batch) {
+  while (emitted_ < plan_->GetLimit() && child_executor_->NextBatch(batch)) {
+    auto skip = static_cast<uint32_t>(std::min<size_t>(batch->Size(), plan_->GetOffset() - skipped_));
+    auto take = static_cast<uint32_t>(std::min<size_t>(batch->Size() - skip, plan_->GetLimit() - emitted_));
+    skipped_ += skip;
+    if (take == 0) {
+      continue;
+    }
+    batch->Slice(skip, take);
+    emitted_ += take;
+    return true;
+  }
+  batch->Reset(GetOutputSchema()->GetColumnCount());
+  return false;
+}
 
 }  // namespace bustub
@@ -10,16 +10,93 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include "execution/executors/nested_index_join_executor.h"
+#include "execution/expressions/column_value_expression.h"
 
 namespace bustub {
 
 NestIndexJoinExecutor::NestIndexJoinExecutor(ExecutorContext *exec_ctx, const NestedIndexJoinPlanNode *plan,
                                              std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
+
+void NestIndexJoinExecutor::Init() {
+  child_executor_->Init();
+  Catalog *catalog = exec_ctx_->GetCatalog();
+  inner_table_info_ = catalog->GetTable(plan_->GetInnerTableOid());
+  index_info_ = catalog->GetIndex(plan_->GetIndexName(), inner_table_info_->name_);
+  // 谓词是 outer.col = inner.col，哪一边是outer看tuple index
+  outer_key_expr_ = plan_->Predicate()->GetChildAt(0);
+  auto column_expr = dynamic_cast<const ColumnValueExpression *>(outer_key_expr_);
+  if (column_expr != nullptr && column_expr->GetTupleIdx() != 0) {
+    outer_key_expr_ = plan_->Predicate()->GetChildAt(1);
+  }
+  outer_batch_.Reset(0);
+  outer_idx_ = 0;
+  matches_.clear();
+  match_idx_ = 0;
+  ResetNextFromBatch();
+}
+
+bool NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) { return NextFromBatch(tuple, rid); }
 
-void NestIndexJoinExecutor::Init() {}
+bool NestIndexJoinExecutor::ProbeNextBatch() {
+  if (!child_executor_->NextBatch(&outer_batch_)) {
+    return false;
+  }
+  const Schema *key_schema = &index_info_->key_schema_;
+  TypeId key_type = key_schema->GetColumn(0).GetType();
+  std::vector<Value> key_values;
+  outer_key_expr_->EvaluateBatch(outer_batch_, child_executor_->GetOutputSchema(), &key_values);
+  std::vector<Tuple> keys;
+  keys.reserve(key_values.size());
+  for (const auto &value : key_values) {
+    keys.emplace_back(std::vector<Value>{value.CastAs(key_type)}, key_schema);
+  }
+  index_info_->index_->ScanKeys(keys, &matches_, exec_ctx_->GetTransaction());
+  return true;
+}
 
-bool NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) { return false; }
+bool NestIndexJoinExecutor::NextBatch(TupleBatch *batch) {
+  const Schema *out_schema = GetOutputSchema();
+  const Schema *outer_schema = child_executor_->GetOutputSchema();
+  const Schema *inner_schema = &inner_table_info_->schema_;
+  batch->Reset(out_schema->GetColumnCount());
+  std::vector<Value> values(out_schema->GetColumnCount());
+  Tuple inner_tuple;
+  while (!batch->IsFull()) {
+    if (outer_idx_ == outer_batch_.Size() || match_idx_ == matches_[outer_idx_].size()) {
+      if (outer_idx_ < outer_batch_.Size()) {
+        outer_idx_++;
+      }
+      if (outer_idx_ == outer_batch_.Size()) {
+        // 到底了，batch已被清空
+        outer_idx_ = 0;
+        if (!ProbeNextBatch()) {
+          break;
+        }
+      }
+      outer_tuple_ = outer_batch_.GetTuple(outer_idx_, outer_schema);
+      match_idx_ = 0;
+      continue;
+    }
+    const RID &inner_rid = matches_[outer_idx_][match_idx_++];
+    if (!inner_table_info_->table_->GetTuple(inner_rid, &inner_tuple, exec_ctx_->GetTransaction())) {
+      continue;
+    }
+    if (!plan_->Predicate()->EvaluateJoin(&outer_tuple_, outer_schema, &inner_tuple, inner_schema).GetAs<bool>()) {
+      continue;
+    }
+    for (uint32_t i = 0; i < values.size(); i++) {
+      values[i] =
+          out_schema->GetColumn(i).GetExpr()->EvaluateJoin(&outer_tuple_, outer_schema, &inner_tuple, inner_schema);
+    }
+    batch->AppendRow(values, RID());
+  }
+  return batch->Size() > 0;
+}
 
 }  // namespace bustub
@@ -10,6 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include "execution/executors/nested_loop_join_executor.h"
 
 namespace bustub {
@@ -17,10 +21,65 @@ namespace bustub {
 NestedLoopJoinExecutor::NestedLoopJoinExecutor(ExecutorContext *exec_ctx, const NestedLoopJoinPlanNode *plan,
                                                std::unique_ptr<AbstractExecutor> &&left_executor,
                                                std::unique_ptr<AbstractExecutor> &&right_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      left_executor_(std::move(left_executor)),
+      right_executor_(std::move(right_executor)) {}
+
+void NestedLoopJoinExecutor::Init() {
+  left_executor_->Init();
+  right_executor_->Init();
+  const Schema *right_schema = right_executor_->GetOutputSchema();
+  right_tuples_.clear();
+  TupleBatch batch;
+  while (right_executor_->NextBatch(&batch)) {
+    for (uint32_t i = 0; i < batch.Size(); i++) {
+      right_tuples_.push_back(batch.GetTuple(i, right_schema));
+    }
+  }
+  left_batch_.Reset(0);
+  left_idx_ = 0;
+  right_idx_ = 0;
+  ResetNextFromBatch();
+}
 
-void NestedLoopJoinExecutor::Init() {}
+bool NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) { return NextFromBatch(tuple, rid); }
 
-bool NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) { return false; }
+bool NestedLoopJoinExecutor::NextBatch(TupleBatch *batch) {
+  const Schema *out_schema = GetOutputSchema();
+  const Schema *left_schema = left_executor_->GetOutputSchema();
+  const Schema *right_schema = right_executor_->GetOutputSchema();
+  batch->Reset(out_schema->GetColumnCount());
+  std::vector<Value> values(out_schema->GetColumnCount());
+  while (!batch->IsFull()) {
+    // 当前左边的行和右边都连接过了，换下一行
+    if (left_idx_ == left_batch_.Size() || right_idx_ == right_tuples_.size()) {
+      if (left_idx_ < left_batch_.Size()) {
+        left_idx_++;
+      }
+      if (left_idx_ == left_batch_.Size()) {
+        // 到底了，batch已被清空
+        left_idx_ = 0;
+        if (!left_executor_->NextBatch(&left_batch_)) {
+          break;
+        }
+      }
+      left_tuple_ = left_batch_.GetTuple(left_idx_, left_schema);
+      right_idx_ = 0;
+      continue;
+    }
+    const Tuple &right_tuple = right_tuples_[right_idx_++];
+    if (plan_->Predicate() != nullptr &&
+        !plan_->Predicate()->EvaluateJoin(&left_tuple_, left_schema, &right_tuple, right_schema).GetAs<bool>()) {
+      continue;
+    }
+    for (uint32_t i = 0; i < values.size(); i++) {
+      values[i] = out_schema->GetColumn(i).GetExpr()->EvaluateJoin(&left_tuple_, left_schema, &right_tuple,
+                                                                   right_schema);
+    }
+    batch->AppendRow(values, RID());
+  }
+  return batch->Size() > 0;
+}
 
 }  // namespace bustub
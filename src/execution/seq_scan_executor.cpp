@@ -13,10 +13,63 @@
 
 namespace bustub {
 
-SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan) : AbstractExecutor(exec_ctx) {}
+SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
 
-void SeqScanExecutor::Init() {}
+void SeqScanExecutor::Init() {
+  TableMetadata *table_info = exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid());
+  table_heap_ = table_info->table_.get();
+  table_schema_ = &table_info->schema_;
+  page_ids_ = table_heap_->GetPageIds();
+  next_page_ = 0;
+  page_tuples_.clear();
+  page_tuple_idx_ = 0;
+  ResetNextFromBatch();
+}
 
-bool SeqScanExecutor::Next(Tuple *tuple, RID *rid) { return false; }
+bool SeqScanExecutor::Next(Tuple *tuple, RID *rid) { return NextFromBatch(tuple, rid); }
+
+bool SeqScanExecutor::FillScanBatch() {
+  scan_batch_.Reset(table_schema_->GetColumnCount());
+  while (!scan_batch_.IsFull()) {
+    if (page_tuple_idx_ == page_tuples_.size()) {
+      if (next_page_ == page_ids_.size()) {
+        break;
+      }
+      page_tuples_.clear();
+      page_tuple_idx_ = 0;
+      table_heap_->GetPageTuples(page_ids_[next_page_++], &page_tuples_, exec_ctx_->GetTransaction());
+      continue;
+    }
+    scan_batch_.AppendTuple(page_tuples_[page_tuple_idx_++], table_schema_);
+  }
+  return scan_batch_.Size() > 0;
+}
+
+bool SeqScanExecutor::NextBatch(TupleBatch *batch) {
+  const Schema *out_schema = GetOutputSchema();
+  // 谓词可能把整批都过滤掉，继续读下一批
+  while (FillScanBatch()) {
+    if (plan_->GetPredicate() != nullptr) {
+      plan_->GetPredicate()->EvaluateBatch(scan_batch_, table_schema_, &predicate_values_);
+      scan_batch_.Select(predicate_values_);
+      if (scan_batch_.Size() == 0) {
+        continue;
+      }
+    }
+    out_columns_.resize(out_schema->GetColumnCount());
+    for (uint32_t i = 0; i < out_columns_.size(); i++) {
+      out_schema->GetColumn(i).GetExpr()->EvaluateBatch(scan_batch_, table_schema_, &out_columns_[i]);
+    }
+    out_rids_.clear();
+    for (uint32_t i = 0; i < scan_batch_.Size(); i++) {
+      out_rids_.push_back(scan_batch_.GetRid(i));
+    }
+    batch->SetColumns(&out_columns_, &out_rids_);
+    return true;
+  }
+  batch->Reset(out_schema->GetColumnCount());
+  return false;
+}
 
 }  // namespace bustub
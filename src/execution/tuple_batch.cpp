@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.cpp
+//
+// Identification: src/execution/tuple_batch.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/tuple_batch.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+void TupleBatch::Reset(uint32_t num_columns) {
+  columns_.resize(num_columns);
+  for (auto &column : columns_) {
+    column.clear();
+    column.reserve(BATCH_SIZE);
+  }
+  rids_.clear();
+  rids_.reserve(BATCH_SIZE);
+  selection_.clear();
+  selection_.reserve(BATCH_SIZE);
+}
+
+Tuple TupleBatch::GetTuple(uint32_t idx, const Schema *schema) const {
+  std::vector<Value> values;
+  values.reserve(columns_.size());
+  for (const auto &column : columns_) {
+    values.push_back(column[selection_[idx]]);
+  }
+  return Tuple(values, schema);
+}
+
+void TupleBatch::AppendRow(const std::vector<Value> &values, const RID &rid) {
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    columns_[i].push_back(values[i]);
+  }
+  selection_.push_back(static_cast<uint32_t>(rids_.size()));
+  rids_.push_back(rid);
+}
+
+void TupleBatch::AppendTuple(const Tuple &tuple, const Schema *schema, const RID &rid) {
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    columns_[i].push_back(tuple.GetValue(schema, i));
+  }
+  selection_.push_back(static_cast<uint32_t>(rids_.size()));
+  rids_.push_back(rid);
+}
+
+void TupleBatch::SetColumns(std::vector<std::vector<Value>> *columns, std::vector<RID> *rids) {
+  // swap而不是move，旧的vector换出去给调用者下次复用
+  columns_.swap(*columns);
+  rids_.swap(*rids);
+  selection_.resize(rids_.size());
+  for (uint32_t i = 0; i < selection_.size(); i++) {
+    selection_[i] = i;
+  }
+}
+
+void TupleBatch::Select(const std::vector<Value> &predicate) {
+  uint32_t kept = 0;
+  for (uint32_t i = 0; i < selection_.size(); i++) {
+    if (!predicate[i].IsNull() && predicate[i].GetAs<bool>()) {
+      selection_[kept++] = selection_[i];
+    }
+  }
+  selection_.resize(kept);
+}
+
+void TupleBatch::Slice(uint32_t offset, uint32_t count) {
+  offset = std::min(offset, Size());
+  count = std::min(count, Size() - offset);
+  selection_.erase(selection_.begin(), selection_.begin() + offset);
+  selection_.resize(count);
+}
+
+}  // namespace bustub
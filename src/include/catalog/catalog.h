@@ -1,15 +1,20 @@
 #pragma once
 
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
+#include "common/exception.h"
 #include "storage/index/b_plus_tree_index.h"
+#include "storage/index/in_memory_b_plus_tree_index.h"
 #include "storage/index/index.h"
+#include "storage/index/varlen_b_plus_tree_index.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
@@ -51,6 +56,8 @@ struct IndexInfo {
   index_oid_t index_oid_;
   std::string table_name_;
   const size_t key_size_;
+  /** statistics of the index, refreshed by Catalog::CollectIndexStats */
+  IndexStats stats_;
 };
 
 /**
@@ -77,17 +84,24 @@ class Catalog {
    */
   TableMetadata *CreateTable(Transaction *txn, const std::string &table_name, const Schema &schema) {
     BUSTUB_ASSERT(names_.count(table_name) == 0, "Table names should be unique!");
-    return nullptr;
+    table_oid_t table_oid = next_table_oid_++;
+    auto table = std::make_unique<TableHeap>(bpm_, lock_manager_, log_manager_, txn);
+    auto *table_metadata = new TableMetadata(schema, table_name, std::move(table), table_oid);
+    tables_.emplace(table_oid, std::unique_ptr<TableMetadata>(table_metadata));
+    names_.emplace(table_name, table_oid);
+    return table_metadata;
   }
 
-  /** @return table metadata by name */
-  TableMetadata *GetTable(const std::string &table_name) { return nullptr; }
+  /** @return table metadata by name, throws std::out_of_range if there is no such table */
+  TableMetadata *GetTable(const std::string &table_name) { return tables_.at(names_.at(table_name)).get(); }
 
-  /** @return table metadata by oid */
-  TableMetadata *GetTable(table_oid_t table_oid) { return nullptr; }
+  /** @return table metadata by oid, throws std::out_of_range if there is no such table */
+  TableMetadata *GetTable(table_oid_t table_oid) { return tables_.at(table_oid).get(); }
 
   /**
    * Create a new index, populate existing data of the table and return its metadata.
+   * CreateIndex<VarlenKey, RID, VarlenComparator> creates a VarlenBPlusTreeIndex, whose keys are as long as their
+   * values (VARCHAR key columns); keysize and num_threads are ignored, in_memory throws an Exception.
    * @param txn the transaction in which the table is being created
    * @param index_name the name of the new index
    * @param table_name the name of the table
@@ -95,25 +109,107 @@ class Catalog {
    * @param key_schema the schema of the key
    * @param key_attrs key attributes
    * @param keysize size of the key
+   * @param num_threads number of threads scanning the table to build the index
+   * @param included_attrs non-key columns stored in the index; throws an Exception unless ValueType is a
+   * CoveringValue whose payload holds them, variable length columns cannot be included
+   * @param in_memory keep the index in memory (InMemoryBPlusTreeIndex) instead of in buffer pool pages
+   * @param is_unique whether keys are unique; if the table already holds a duplicate key, throws an Exception
    * @return a pointer to the metadata of the new table
    */
   template <class KeyType, class ValueType, class KeyComparator>
   IndexInfo *CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name,
                          const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs,
-                         size_t keysize) {
-    return nullptr;
+                         size_t keysize, size_t num_threads = 1,
+                         const std::vector<uint32_t> &included_attrs = {}, bool in_memory = false,
+                         bool is_unique = true) {
+    TableMetadata *table_metadata = GetTable(table_name);
+    // 叶子的value是定长的，included列放不下要在建索引之前报错，而不是等到第一次插入
+    if (!included_attrs.empty()) {
+      if constexpr (!IndexValue<ValueType>::COVERING) {
+        throw Exception(ExceptionType::INVALID, "index " + index_name + " stores RIDs only, it cannot include columns");
+      }
+      uint32_t included_length = 0;
+      for (uint32_t attr : included_attrs) {
+        const Column &column = schema.GetColumn(attr);
+        if (!column.IsInlined()) {
+          throw Exception(ExceptionType::INVALID, "index " + index_name + " cannot include variable length column " +
+                                                      column.GetName());
+        }
+        included_length += column.GetFixedLength();
+      }
+      if (included_length > IndexValue<ValueType>::PAYLOAD_SIZE) {
+        throw Exception(ExceptionType::OUT_OF_RANGE,
+                        "included columns of index " + index_name + " do not fit into the covering value payload");
+      }
+    }
+    if constexpr (std::is_same_v<KeyType, VarlenKey>) {
+      static_assert(std::is_same_v<ValueType, RID>, "variable length key indexes store RIDs only");
+      if (in_memory) {
+        throw Exception(ExceptionType::NOT_IMPLEMENTED,
+                        "variable length key index " + index_name + " cannot be kept in memory");
+      }
+    }
+    // the index owns its metadata
+    auto *index_metadata = new IndexMetadata(index_name, table_name, &schema, key_attrs, is_unique, included_attrs);
+    std::unique_ptr<Index> index;
+    if constexpr (std::is_same_v<KeyType, VarlenKey>) {
+      // keysize does not matter, the keys take as many bytes as their values need
+      auto varlen_index = std::make_unique<VarlenBPlusTreeIndex>(index_metadata, bpm_);
+      varlen_index->BuildFromTable(table_metadata->table_.get(), schema, txn);
+      index = std::move(varlen_index);
+    } else if (in_memory) {
+      auto in_memory_index = std::make_unique<InMemoryBPlusTreeIndex<KeyType, ValueType, KeyComparator>>(index_metadata);
+      in_memory_index->BuildFromTable(table_metadata->table_.get(), schema, num_threads, txn);
+      index = std::move(in_memory_index);
+    } else {
+      auto bpm_index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(index_metadata, bpm_);
+      // sort the existing tuples by key and bulk load them, instead of inserting them one by one
+      bpm_index->BuildFromTable(table_metadata->table_.get(), schema, num_threads, txn);
+      index = std::move(bpm_index);
+    }
+
+    index_oid_t index_oid = next_index_oid_++;
+    auto *index_info = new IndexInfo(key_schema, index_name, std::move(index), index_oid, table_name, keysize);
+    indexes_.emplace(index_oid, std::unique_ptr<IndexInfo>(index_info));
+    index_names_[table_name].emplace(index_name, index_oid);
+    CollectIndexStats(index_info);
+    return index_info;
   }
 
-  IndexInfo *GetIndex(const std::string &index_name, const std::string &table_name) { return nullptr; }
+  /**
+   * Refresh the statistics kept in index_info->stats_.
+   * @param index_info the index
+   * @param num_buckets number of buckets of the key histogram
+   * @param leaf_sample_rate only every leaf_sample_rate-th leaf is read, 1 reads them all
+   */
+  void CollectIndexStats(IndexInfo *index_info, size_t num_buckets = 16, int leaf_sample_rate = 1) {
+    index_info->index_->CollectStats(&index_info->stats_, num_buckets, leaf_sample_rate);
+  }
 
-  IndexInfo *GetIndex(index_oid_t index_oid) { return nullptr; }
+  /** @return index metadata by name, throws std::out_of_range if there is no such index */
+  IndexInfo *GetIndex(const std::string &index_name, const std::string &table_name) {
+    return indexes_.at(index_names_.at(table_name).at(index_name)).get();
+  }
 
-  std::vector<IndexInfo *> GetTableIndexes(const std::string &table_name) { return std::vector<IndexInfo *>(); }
+  /** @return index metadata by oid, throws std::out_of_range if there is no such index */
+  IndexInfo *GetIndex(index_oid_t index_oid) { return indexes_.at(index_oid).get(); }
+
+  std::vector<IndexInfo *> GetTableIndexes(const std::string &table_name) {
+    std::vector<IndexInfo *> index_infos;
+    auto iter = index_names_.find(table_name);
+    if (iter == index_names_.end()) {
+      return index_infos;
+    }
+    for (const auto &entry : iter->second) {
+      index_infos.push_back(indexes_.at(entry.second).get());
+    }
+    return index_infos;
+  }
 
  private:
-  [[maybe_unused]] BufferPoolManager *bpm_;
-  [[maybe_unused]] LockManager *lock_manager_;
-  [[maybe_unused]] LogManager *log_manager_;
+  BufferPoolManager *bpm_;
+  LockManager *lock_manager_;
+  LogManager *log_manager_;
 
   /** tables_ : table identifiers -> table metadata. Note that tables_ owns all table metadata. */
   std::unordered_map<table_oid_t, std::unique_ptr<TableMetadata>> tables_;
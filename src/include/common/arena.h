@@ -0,0 +1,73 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arena.h
+//
+// Identification: src/include/common/arena.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * Bump allocator: memory is carved out of large blocks and only given back,
+ * all at once, when the arena is destroyed. Destructors of the objects placed
+ * in it are never run, so it only suits trivially destructible objects.
+ */
+class Arena {
+ public:
+  explicit Arena(size_t block_size = 64 * 1024) : block_size_(block_size) {}
+
+  DISALLOW_COPY_AND_MOVE(Arena);
+
+  /**
+   * @param size number of bytes
+   * @param align alignment of the returned address, a power of two
+   * @return uninitialized memory, valid until the arena is destroyed
+   */
+  void *Allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+    std::lock_guard<std::mutex> guard(latch_);
+    size_t padding = (align - reinterpret_cast<uintptr_t>(ptr_) % align) % align;
+    if (ptr_ == nullptr || padding + size > remaining_) {
+      //当前block不够用，申请新的block；超大的请求单独占一个block
+      size_t block_size = std::max(block_size_, size + align);
+      blocks_.emplace_back(new char[block_size]);
+      ptr_ = blocks_.back().get();
+      remaining_ = block_size;
+      memory_usage_ += block_size;
+      padding = (align - reinterpret_cast<uintptr_t>(ptr_) % align) % align;
+    }
+    char *result = ptr_ + padding;
+    ptr_ += padding + size;
+    remaining_ -= padding + size;
+    return result;
+  }
+
+  // bytes of the blocks allocated so far
+  size_t MemoryUsage() {
+    std::lock_guard<std::mutex> guard(latch_);
+    return memory_usage_;
+  }
+
+ private:
+  const size_t block_size_;
+  std::mutex latch_;
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  char *ptr_{nullptr};
+  size_t remaining_{0};
+  size_t memory_usage_{0};
+};
+
+}  // namespace bustub
@@ -13,10 +13,16 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
 
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
 #include "common/macros.h"
 #include "type/value.h"
 
@@ -27,24 +33,118 @@ using hash_t = std::size_t;
 class HashUtil {
  private:
   static const hash_t prime_factor = 10000019;
+  static constexpr uint64_t WY_SECRET[4] = {0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL, 0x8ebc6af09c88c6e3ULL,
+                                            0x589965cc75374cc3ULL};
+  // reflected Castagnoli polynomial
+  static constexpr uint32_t CRC32C_POLY = 0x82f63b78;
+
+  // 64x64->128 bit multiply, the two halves folded by xor
+  static inline uint64_t WyMix(uint64_t a, uint64_t b) {
+    __uint128_t r = static_cast<__uint128_t>(a) * b;
+    return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+  }
+  static inline uint64_t Read8(const uint8_t *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+  }
+  static inline uint64_t Read4(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+  }
 
  public:
-  static inline hash_t HashBytes(const char *bytes, size_t length) {
-    // https://github.com/greenplum-db/gpos/blob/b53c1acd6285de94044ff91fbee91589543feba1/libgpos/src/utils.cpp#L126
-    hash_t hash = length;
-    for (size_t i = 0; i < length; ++i) {
-      hash = ((hash << 5) ^ (hash >> 27)) ^ bytes[i];
+  /*
+   * wyhash (final version 4, https://github.com/wangyi-fudan/wyhash) for byte
+   * strings of any length: 48 bytes per round as three independent 64x64->128
+   * bit multiply-xor lanes, short inputs read with at most four loads.
+   */
+  static inline hash_t HashBytes(const char *bytes, size_t length, uint64_t seed = 0) {
+    const auto *p = reinterpret_cast<const uint8_t *>(bytes);
+    seed ^= WyMix(seed ^ WY_SECRET[0], WY_SECRET[1]);
+    uint64_t a;
+    uint64_t b;
+    if (length <= 16) {
+      if (length >= 4) {
+        a = (Read4(p) << 32) | Read4(p + ((length >> 3) << 2));
+        b = (Read4(p + length - 4) << 32) | Read4(p + length - 4 - ((length >> 3) << 2));
+      } else if (length > 0) {
+        a = (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[length >> 1]) << 8) | p[length - 1];
+        b = 0;
+      } else {
+        a = b = 0;
+      }
+    } else {
+      size_t i = length;
+      if (i > 48) {
+        uint64_t see1 = seed;
+        uint64_t see2 = seed;
+        do {
+          seed = WyMix(Read8(p) ^ WY_SECRET[1], Read8(p + 8) ^ seed);
+          see1 = WyMix(Read8(p + 16) ^ WY_SECRET[2], Read8(p + 24) ^ see1);
+          see2 = WyMix(Read8(p + 32) ^ WY_SECRET[3], Read8(p + 40) ^ see2);
+          p += 48;
+          i -= 48;
+        } while (i > 48);
+        seed ^= see1 ^ see2;
+      }
+      while (i > 16) {
+        seed = WyMix(Read8(p) ^ WY_SECRET[1], Read8(p + 8) ^ seed);
+        i -= 16;
+        p += 16;
+      }
+      //最后16字节，可能和上一轮重叠
+      a = Read8(p + i - 16);
+      b = Read8(p + i - 8);
     }
-    return hash;
+    a ^= WY_SECRET[1];
+    b ^= seed;
+    __uint128_t r = static_cast<__uint128_t>(a) * b;
+    return WyMix(static_cast<uint64_t>(r) ^ WY_SECRET[0] ^ length, static_cast<uint64_t>(r >> 64) ^ WY_SECRET[1]);
   }
 
-  static inline hash_t CombineHashes(hash_t l, hash_t r) {
-    hash_t both[2];
-    both[0] = l;
-    both[1] = r;
-    return HashBytes(reinterpret_cast<char *>(both), sizeof(hash_t) * 2);
+  /** @return the CRC32C (Castagnoli) of the bytes, with the SSE4.2 crc32 instruction when there is one */
+  static inline uint32_t Crc32c(const char *bytes, size_t length, uint32_t crc = 0) {
+    crc = ~crc;
+#if defined(__SSE4_2__)
+    uint64_t crc64 = crc;
+    for (; length >= 8; bytes += 8, length -= 8) {
+      crc64 = _mm_crc32_u64(crc64, Read8(reinterpret_cast<const uint8_t *>(bytes)));
+    }
+    crc = static_cast<uint32_t>(crc64);
+    for (; length > 0; bytes++, length--) {
+      crc = _mm_crc32_u8(crc, static_cast<uint8_t>(*bytes));
+    }
+#else
+    for (; length > 0; bytes++, length--) {
+      crc ^= static_cast<uint8_t>(*bytes);
+      for (int bit = 0; bit < 8; bit++) {
+        crc = (crc >> 1) ^ (CRC32C_POLY & (0U - (crc & 1)));
+      }
+    }
+#endif
+    return ~crc;
   }
 
+  /*
+   * Hash of a fixed-width key: its CRC32C, spread over the 64 bits by the
+   * murmur3 finalizer (a CRC is linear, its bits alone are no hash). Only 32
+   * bits of entropy, enough for any table of pages.
+   */
+  static inline hash_t HashCrc32c(const char *bytes, size_t length) {
+    uint64_t hash = Crc32c(bytes, length);
+    hash |= hash << 32;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+  }
+
+  static inline hash_t CombineHashes(hash_t l, hash_t r) { return WyMix(l ^ WY_SECRET[0], r ^ WY_SECRET[1]); }
+
   static inline hash_t SumHashes(hash_t l, hash_t r) { return (l % prime_factor + r % prime_factor) % prime_factor; }
 
   template <typename T>
@@ -0,0 +1,146 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// chained_hash_table.h
+//
+// Identification: src/include/container/hash/chained_hash_table.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rwlatch.h"
+#include "concurrency/transaction.h"
+#include "container/hash/hash_function.h"
+#include "container/hash/hash_table.h"
+#include "storage/page/hash_table_chain_page.h"
+#include "storage/page/hash_table_header_page.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+#define CHAINED_HASH_TABLE_TYPE ChainedHashTable<KeyType, ValueType, KeyComparator>
+
+/**
+ * Chained hash table backed by a buffer pool manager, grown by linear
+ * hashing. Non-unique keys are supported. Supports insert and delete.
+ *
+ * The header page lists the head page of every bucket. A bucket is a chain
+ * of HashTableChainPage, filled up to their counters, a new page is linked
+ * at the end when all are full. The pairs of a key all sit in the chain of
+ * its bucket, so many duplicates of a key make that one chain longer, but
+ * never the probes of other keys, as a cluster does in linear probing.
+ *
+ * No table-wide resize: once the chains are longer than MAX_CHAIN_LENGTH
+ * pages on average, the bucket at the split pointer is split, its pairs are
+ * rehashed between itself and one new bucket at the end. The split pointer
+ * walks the buckets of the current round, which doubles their number when
+ * it reaches the end; bucket b of the round is addressed by hash modulo
+ * initial_buckets << level, or modulo the double if b was split already.
+ * Overflow pages emptied by removes are freed, the table does not shrink.
+ *
+ * Concurrency: lookups, inserts and removes hold table_latch_ shared and
+ * latch the head page of their bucket (read or write), which protects the
+ * whole chain. Splits take table_latch_ exclusively.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class ChainedHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
+ public:
+  /**
+   * Creates a new ChainedHashTable
+   *
+   * @param buffer_pool_manager buffer pool manager to be used
+   * @param comparator comparator for keys
+   * @param num_buckets initial number of buckets
+   * @param hash_fn the hash function
+   */
+  explicit ChainedHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                            const KeyComparator &comparator, size_t num_buckets, HashFunction<KeyType> hash_fn);
+
+  /**
+   * Inserts a key-value pair into the hash table.
+   * @param transaction the current transaction
+   * @param key the key to create
+   * @param value the value to be associated with the key
+   * @return true if insert succeeded, false otherwise
+   */
+  bool Insert(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Deletes the associated value for the given key.
+   * @param transaction the current transaction
+   * @param key the key to delete
+   * @param value the value to delete
+   * @return true if remove succeeded, false otherwise
+   */
+  bool Remove(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Performs a point query on the hash table.
+   * @param transaction the current transaction
+   * @param key the key to look up
+   * @param[out] result the value(s) associated with a given key
+   * @return the value(s) associated with the given key
+   */
+  bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) override;
+
+  /**
+   * @return the number of buckets of the hash table
+   */
+  size_t GetSize();
+
+  /**
+   * @return the number of chain pages per bucket
+   */
+  double GetAverageChainLength();
+
+ private:
+  using ChainPage = HASH_TABLE_CHAIN_TYPE;
+
+  // average number of pages per chain over which an insert splits a bucket
+  static constexpr double MAX_CHAIN_LENGTH = 1.5;
+
+  // bucket of hash under the current level and split pointer; table_latch_ held
+  size_t BucketOf(uint64_t hash) const;
+  // table_latch_ held
+  bool NeedsSplit() const;
+
+  // pinned, the caller unpins
+  Page *FetchChainPage(page_id_t page_id);
+  // a new, empty, unlinked chain page, unpinned
+  page_id_t NewChainPage();
+
+  // split the bucket at the split pointer if the chains are still too long, table_latch_ not held
+  void Split();
+  // make the chain on pages hold exactly pairs: the pages are refilled in order, pages are added or freed as needed;
+  // the first page is kept even if it ends up empty. table_latch_ held exclusively
+  void WriteChain(std::vector<page_id_t> pages, const std::vector<MappingType> &pairs);
+
+  // member variable
+  page_id_t header_page_id_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+
+  // Readers are lookups, inserts and removes, writer splits
+  ReaderWriterLatch table_latch_;
+
+  // head page of each bucket, as in the header page; only splits append to it
+  std::vector<page_id_t> bucket_page_ids_;
+  size_t initial_buckets_;
+  // split round: the round starts with initial_buckets_ << level_ buckets, the ones before next_ are split
+  size_t level_{0};
+  size_t next_{0};
+  // chain pages of all buckets, heads included
+  std::atomic<size_t> num_pages_{0};
+
+  // Hash function
+  HashFunction<KeyType> hash_fn_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,147 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// cuckoo_hash_table.h
+//
+// Identification: src/include/container/hash/cuckoo_hash_table.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rwlatch.h"
+#include "concurrency/transaction.h"
+#include "container/hash/hash_function.h"
+#include "container/hash/hash_table.h"
+#include "storage/page/hash_table_cuckoo_page.h"
+#include "storage/page/hash_table_header_page.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+#define CUCKOO_HASH_TABLE_TYPE CuckooHashTable<KeyType, ValueType, KeyComparator>
+
+/**
+ * Bucketized cuckoo hash table backed by a buffer pool manager. Non-unique
+ * keys are supported, up to 2 * CUCKOO_SLOTS values per key. Supports insert
+ * and delete. The table grows once an insert finds no room.
+ *
+ * Every key has two candidate buckets of CUCKOO_SLOTS pairs, picked by the
+ * low and the high half of its hash, and it is always in one of them. A
+ * lookup or a remove reads at most these two buckets, that is at most two
+ * pages: the page ids of the buckets are cached, the header page is only
+ * written. Unlike linear probing, the cost of a lookup does not depend on
+ * the load factor.
+ *
+ * An insert uses a free slot of either bucket if there is one. Otherwise it
+ * searches, breadth first over up to MAX_SEARCH_BUCKETS buckets, the shortest
+ * chain of pairs that can each move to their other bucket and ends in a
+ * bucket with a free slot. The moves are made only once the chain is found,
+ * from its end, so no pair is ever without a slot. If there is no such chain,
+ * the table doubles: every pair is rehashed into new pages and the old ones
+ * are deleted.
+ *
+ * Concurrency: lookups and removes hold table_latch_ shared and latch the
+ * pages of the two buckets one after the other (read or write). Inserts move
+ * pairs between buckets and hold table_latch_ exclusively.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class CuckooHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
+ public:
+  /**
+   * Creates a new CuckooHashTable
+   *
+   * @param buffer_pool_manager buffer pool manager to be used
+   * @param comparator comparator for keys
+   * @param num_buckets initial number of buckets, rounded up to whole pages
+   * @param hash_fn the hash function
+   */
+  explicit CuckooHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                           const KeyComparator &comparator, size_t num_buckets, HashFunction<KeyType> hash_fn);
+
+  /**
+   * Inserts a key-value pair into the hash table.
+   * @param transaction the current transaction
+   * @param key the key to create
+   * @param value the value to be associated with the key
+   * @return true if insert succeeded, false if the pair exists or key already has 2 * CUCKOO_SLOTS values
+   */
+  bool Insert(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Deletes the associated value for the given key.
+   * @param transaction the current transaction
+   * @param key the key to delete
+   * @param value the value to delete
+   * @return true if remove succeeded, false otherwise
+   */
+  bool Remove(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Performs a point query on the hash table.
+   * @param transaction the current transaction
+   * @param key the key to look up
+   * @param[out] result the value(s) associated with a given key
+   * @return the value(s) associated with the given key
+   */
+  bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) override;
+
+  /**
+   * @return the number of buckets of the hash table
+   */
+  size_t GetSize();
+
+ private:
+  using CuckooPage = HASH_TABLE_CUCKOO_TYPE;
+
+  // buckets an insert searches for a free slot before it grows the table
+  static constexpr size_t MAX_SEARCH_BUCKETS = 256;
+
+  // the header page and, cached, the bucket pages
+  struct Table {
+    page_id_t header_page_id_{INVALID_PAGE_ID};
+    size_t num_buckets_{0};
+    std::vector<page_id_t> bucket_page_ids_;
+  };
+
+  // allocate the header page and the pages of at least num_buckets buckets
+  Table NewTable(size_t num_buckets);
+  void DeleteTable(const Table &table);
+
+  // the two candidate buckets of hash, always different
+  void Buckets(const Table &table, uint64_t hash, size_t *first, size_t *second) const;
+
+  // pinned, the caller unpins
+  Page *FetchBucketPage(const Table &table, size_t bucket);
+
+  // the bucket of a pair in bucket, other than bucket
+  size_t OtherBucket(const Table &table, const KeyType &key, size_t bucket);
+
+  // slot CUCKOO_SLOTS: any free slot of the bucket
+  void WritePair(const Table &table, size_t bucket, uint32_t slot, const MappingType &pair);
+
+  // put pair into one of its buckets, moving other pairs if needed; false (and table unchanged) if there is no room
+  bool Place(const Table &table, const MappingType &pair);
+
+  // rehash table_ and pair into a table twice as large (or larger, until everything fits); table_latch_ held
+  void Grow(const MappingType &pair);
+
+  // member variable
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+
+  // Readers are lookups and removes, writers are inserts
+  ReaderWriterLatch table_latch_;
+
+  Table table_;
+
+  // Hash function
+  HashFunction<KeyType> hash_fn_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table.h
+//
+// Identification: src/include/container/hash/extendible_hash_table.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rwlatch.h"
+#include "concurrency/transaction.h"
+#include "container/hash/hash_function.h"
+#include "container/hash/hash_table.h"
+#include "storage/page/hash_table_bucket_page.h"
+#include "storage/page/hash_table_directory_page.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+#define EXTENDIBLE_HASH_TABLE_TYPE ExtendibleHashTable<KeyType, ValueType, KeyComparator>
+
+/**
+ * Implementation of extendible hashing that is backed by a buffer pool
+ * manager. Non-unique keys are supported. Supports insert and delete.
+ *
+ * A directory page maps the low GlobalDepth bits of the hash to bucket
+ * pages. A full bucket splits on its own: only its entries are rehashed into
+ * one new page, and the directory doubles (a copy of its slots, no bucket is
+ * touched) only when the bucket was already at the global depth. An emptied
+ * bucket merges back into its split image and the directory shrinks when it
+ * can.
+ *
+ * Concurrency: table_latch_ is held shared by lookups, inserts and removes,
+ * which latch only the bucket page they use (read or write). Splits and
+ * merges change the directory and take table_latch_ exclusively; they only
+ * run once a bucket turned out to be full or empty.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class ExtendibleHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
+ public:
+  /**
+   * Creates a new ExtendibleHashTable: a directory of global depth 0 and one bucket.
+   *
+   * @param buffer_pool_manager buffer pool manager to be used
+   * @param comparator comparator for keys
+   * @param hash_fn the hash function
+   */
+  explicit ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                               const KeyComparator &comparator, HashFunction<KeyType> hash_fn);
+
+  /**
+   * Inserts a key-value pair into the hash table.
+   * @param transaction the current transaction
+   * @param key the key to create
+   * @param value the value to be associated with the key
+   * @return true if insert succeeded, false if the pair exists or its bucket is full at the largest depth
+   */
+  bool Insert(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Deletes the associated value for the given key.
+   * @param transaction the current transaction
+   * @param key the key to delete
+   * @param value the value to delete
+   * @return true if remove succeeded, false otherwise
+   */
+  bool Remove(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Performs a point query on the hash table.
+   * @param transaction the current transaction
+   * @param key the key to look up
+   * @param[out] result the value(s) associated with a given key
+   * @return the value(s) associated with the given key
+   */
+  bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) override;
+
+  /**
+   * @return the global depth of the directory
+   */
+  uint32_t GetGlobalDepth();
+
+  /**
+   * Asserts the directory invariants, see HashTableDirectoryPage::VerifyIntegrity.
+   */
+  void VerifyIntegrity();
+
+ private:
+  using BucketPage = HASH_TABLE_BUCKET_TYPE;
+
+  // low 32 bits of the hash, the directory uses at most MAX_DEPTH of them
+  uint32_t Hash(const KeyType &key);
+
+  // pinned, the caller unpins
+  HashTableDirectoryPage *FetchDirectoryPage();
+  Page *FetchBucketPage(page_id_t bucket_page_id);
+
+  // insert into a full bucket: split it (growing the directory if needed) until the pair fits, table_latch_ not held
+  bool SplitInsert(const KeyType &key, const ValueType &value);
+  // merge the bucket of key with its split image if it is still empty, table_latch_ not held
+  void Merge(const KeyType &key);
+
+  // member variable
+  page_id_t directory_page_id_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+
+  // Readers includes inserts and removes, writer are splits and merges
+  ReaderWriterLatch table_latch_;
+
+  // Hash function
+  HashFunction<KeyType> hash_fn_;
+};
+
+}  // namespace bustub
@@ -14,23 +14,50 @@
 
 #include <cstdint>
 
+#include "common/util/hash_util.h"
 #include "murmur3/MurmurHash3.h"
 
 namespace bustub {
 
+/** Hash algorithms of HashFunction; the default stays murmur3, so existing tables keep their layout. */
+enum class HashAlgorithm {
+  MURMUR3,
+  // CRC32C instruction (SSE4.2), for fixed-width keys
+  CRC32C,
+  // wyhash, see HashUtil::HashBytes
+  WYHASH,
+};
+
 template <typename KeyType>
 class HashFunction {
  public:
+  explicit HashFunction(HashAlgorithm algorithm = HashAlgorithm::MURMUR3) : algorithm_(algorithm) {}
+
   /**
    * @param key the key to be hashed
    * @return the hashed value
    */
   virtual uint64_t GetHash(KeyType key) {
+    const auto *bytes = reinterpret_cast<const char *>(&key);
+    switch (algorithm_) {
+      case HashAlgorithm::CRC32C:
+        return HashUtil::HashCrc32c(bytes, sizeof(KeyType));
+      case HashAlgorithm::WYHASH:
+        return HashUtil::HashBytes(bytes, sizeof(KeyType));
+      case HashAlgorithm::MURMUR3:
+      default:
+        break;
+    }
     uint64_t hash[2];
     murmur3::MurmurHash3_x64_128(reinterpret_cast<const void *>(&key), static_cast<int>(sizeof(KeyType)), 0,
                                  reinterpret_cast<void *>(&hash));
     return hash[0];
   }
+
+  HashAlgorithm GetAlgorithm() const { return algorithm_; }
+
+ private:
+  HashAlgorithm algorithm_;
 };
 
 }  // namespace bustub
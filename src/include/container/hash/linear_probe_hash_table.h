@@ -12,6 +12,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <mutex>  // NOLINT
 #include <queue>
 #include <string>
 #include <vector>
@@ -32,6 +35,26 @@ namespace bustub {
  * Implementation of linear probing hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
  * table dynamically grows once full.
+ *
+ * Growing is incremental: Resize only allocates the new, larger table and
+ * makes it current. The old table stays next to it, and every insert and
+ * remove moves the entries of the next MIGRATE_SLOTS slots of the old table
+ * over, until it is empty and freed. No operation waits for the whole table
+ * to be rehashed. Meanwhile inserts go to the new table, lookups and removes
+ * check both, the old one first: an entry in flight is in the new table
+ * before it leaves the old one, so a lookup may see it twice (and reports it
+ * once), but never misses it.
+ *
+ * Concurrency: lookups take no latch. They read the slots through
+ * HashTableBlockPage::ReadSlot, and they start over if a resize swapped the
+ * tables while they ran. The tables are published together as one
+ * immutable State, so a lookup always sees a matching pair. A retired table
+ * is freed by the last operation that still holds it.
+ * Inserts and removes run in parallel. Operations on the same key are
+ * serialized by one of NUM_KEY_LATCHES latches, picked by the hash. The
+ * block pages are only locked stripe by stripe, for the time of one slot
+ * write. table_latch_ is held shared by writers and exclusively only to
+ * publish a new State at the start and the end of a resize.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
@@ -74,6 +97,20 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
    */
   bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) override;
 
+  /**
+   * Point queries for many keys at once, for joins and IN lists. All hashes
+   * are computed first, then the keys are grouped by home block: each block
+   * page is fetched once for its keys, and the home slots of PREFETCH_GROUP
+   * keys are prefetched before any of them is resolved, so that their cache
+   * misses overlap instead of stalling one probe after the other.
+   * @param transaction the current transaction
+   * @param keys the keys to look up
+   * @param[out] results (*results)[i] holds the values of keys[i], as GetValue would return them
+   * @return the number of keys with at least one value
+   */
+  size_t GetValues(Transaction *transaction, const std::vector<KeyType> &keys,
+                   std::vector<std::vector<ValueType>> *results);
+
   /**
    * Resizes the table to at least twice the initial size provided.
    * @param initial_size the initial size of the hash table
@@ -87,13 +124,90 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
   size_t GetSize();
 
  private:
+  using BlockPage = HASH_TABLE_BLOCK_TYPE;
+
+  // old table slots moved to the new table by each insert and remove during a resize
+  static constexpr size_t MIGRATE_SLOTS = 32;
+  // occupied slots (tombstones included) over which an insert starts a resize
+  static constexpr double MAX_LOAD_FACTOR = 0.75;
+
+  // keys of a batch lookup whose home slots are prefetched together
+  static constexpr size_t PREFETCH_GROUP = 16;
+
+  // latches serializing the writers of equal keys
+  static constexpr size_t NUM_KEY_LATCHES = 64;
+
+  // one table: its header page and, cached, its block pages
+  struct Table {
+    // a retired table deletes its pages once the last State holding it is gone
+    ~Table();
+
+    BufferPoolManager *buffer_pool_manager_{nullptr};
+    page_id_t header_page_id_{INVALID_PAGE_ID};
+    size_t size_{0};
+    std::vector<page_id_t> block_page_ids_;
+    std::atomic<bool> retired_{false};
+  };
+
+  // the table inserts go to, and the one being migrated if any; never changed once published
+  struct State {
+    std::shared_ptr<Table> current_;
+    std::shared_ptr<Table> old_;
+  };
+
+  // allocate the header page and the block pages of a table of num_buckets slots
+  std::shared_ptr<Table> NewTable(size_t num_buckets);
+
+  std::mutex &KeyLatch(uint64_t hash) { return key_latches_[(hash >> 32) % NUM_KEY_LATCHES]; }
+
+  /*
+   * Walk the probe sequence of hash in table, from its home slot up to the
+   * first slot never occupied, one block and one group of tags at a time.
+   * fn(block, offset, slot) is called for the slots tagged tag and returns
+   * false to stop. Returns the slot never occupied the walk ended on,
+   * table.size_ if fn stopped it or the table has none. home, if not
+   * nullptr, is the home block of hash, pinned by the caller.
+   */
+  template <typename Fn>
+  size_t Probe(const Table &table, uint64_t hash, uint8_t tag, Fn &&fn, BlockPage *home = nullptr);
+
+  bool Find(const Table &table, uint64_t hash, const KeyType &key, const ValueType *value,
+            std::vector<ValueType> *result, size_t *slot, BlockPage *home = nullptr);
+  // Find the values of every key in table, see GetValues
+  void FindBatch(const Table &table, const std::vector<KeyType> &keys, const std::vector<uint64_t> &hashes,
+                 std::vector<std::vector<ValueType>> *results);
+  // append to result the values not already in result from index start on: a pair in flight is in both tables
+  static void AppendNew(const std::vector<ValueType> &values, size_t start, std::vector<ValueType> *result);
+  // insert into the first free slot of the probe sequence, there always is one below the max load factor
+  void InsertInto(Table *table, uint64_t hash, const KeyType &key, const ValueType &value);
+  void RemoveAt(const Table &table, size_t slot);
+
+  // writers only, table_latch_ held shared, no key latch held: migrate up to count slots of state.old_,
+  // returns true if that completed the migration
+  bool MigrateSlots(const State &state, size_t count);
+  // writers only, nothing held: drop old from the State once it is migrated
+  void FinishMigration(const Table *old);
+  // writers only, nothing held: make a table of num_buckets slots current unless current was replaced already
+  void StartResize(const Table *current, size_t num_buckets);
+
   // member variable
   page_id_t header_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
-  // Readers includes inserts and removes, writer is only resize
+  // Readers are inserts and removes, writer publishes a new State
   ReaderWriterLatch table_latch_;
+  // one resize at a time
+  std::mutex resize_latch_;
+  std::mutex key_latches_[NUM_KEY_LATCHES];
+
+  // read with std::atomic_load, replaced with std::atomic_store under table_latch_ held exclusively
+  std::shared_ptr<const State> state_;
+  // next slot of the old table to migrate, and slots migrated so far
+  std::atomic<size_t> migrate_cursor_{0};
+  std::atomic<size_t> migrated_{0};
+  // occupied slots of the current table, an estimate under concurrent inserts
+  std::atomic<size_t> num_occupied_{0};
 
   // Hash function
   HashFunction<KeyType> hash_fn_;
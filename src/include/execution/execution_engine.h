@@ -20,6 +20,7 @@
 #include "execution/executor_context.h"
 #include "execution/executor_factory.h"
 #include "execution/plans/abstract_plan.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 namespace bustub {
 class ExecutionEngine {
@@ -37,13 +38,15 @@ class ExecutionEngine {
     // prepare
     executor->Init();
 
-    // execute
+    // execute, a batch at a time
     try {
-      Tuple tuple;
-      RID rid;
-      while (executor->Next(&tuple, &rid)) {
-        if (result_set != nullptr) {
-          result_set->push_back(tuple);
+      const Schema *schema = executor->GetOutputSchema();
+      TupleBatch batch;
+      while (executor->NextBatch(&batch)) {
+        if (result_set != nullptr && schema != nullptr) {
+          for (uint32_t i = 0; i < batch.Size(); i++) {
+            result_set->push_back(batch.GetTuple(i, schema));
+          }
         }
       }
     } catch (Exception &e) {
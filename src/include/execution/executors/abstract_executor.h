@@ -13,11 +13,16 @@
 #pragma once
 
 #include "execution/executor_context.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 /**
- * AbstractExecutor implements the Volcano tuple-at-a-time iterator model.
+ * AbstractExecutor implements the Volcano tuple-at-a-time iterator model, and a batch-at-a-time variant of it.
+ *
+ * Executors implement at least one of Next() and NextBatch(). The default NextBatch() fills a batch by calling
+ * Next(), so executors that only produce tuples can sit under batched ones. The other way round, a batched
+ * executor implements Next() with NextFromBatch().
  */
 class AbstractExecutor {
  public:
@@ -44,6 +49,24 @@ class AbstractExecutor {
    */
   virtual bool Next(Tuple *tuple, RID *rid) = 0;
 
+  /**
+   * Produces the next batch of tuples from this executor, one column per column of the output schema.
+   * @param[out] batch the batch to fill, its previous content is dropped
+   * @return true if at least one tuple was produced, false if there are no more tuples
+   */
+  virtual bool NextBatch(TupleBatch *batch) {
+    const Schema *schema = GetOutputSchema();
+    // insert/update/delete没有输出schema，batch只有行数
+    batch->Reset(schema == nullptr ? 0 : schema->GetColumnCount());
+    Tuple tuple;
+    RID rid;
+    while (!batch->IsFull() && Next(&tuple, &rid)) {
+      // Next()输出的tuple不一定带rid，以rid参数为准
+      batch->AppendTuple(tuple, schema, rid);
+    }
+    return batch->Size() > 0;
+  }
+
   /** @return the schema of the tuples that this executor produces */
   virtual const Schema *GetOutputSchema() = 0;
 
@@ -51,6 +74,32 @@ class AbstractExecutor {
   ExecutorContext *GetExecutorContext() { return exec_ctx_; }
 
  protected:
+  /**
+   * Next() of executors that implement NextBatch(): hands out the rows of one batch after the other. Init()
+   * must call ResetNextFromBatch().
+   */
+  bool NextFromBatch(Tuple *tuple, RID *rid) {
+    while (next_batch_idx_ >= next_batch_.Size()) {
+      if (!NextBatch(&next_batch_)) {
+        return false;
+      }
+      next_batch_idx_ = 0;
+    }
+    *tuple = next_batch_.GetTuple(next_batch_idx_, GetOutputSchema());
+    *rid = next_batch_.GetRid(next_batch_idx_++);
+    return true;
+  }
+
+  /** Drops the rest of the batch of NextFromBatch(). */
+  void ResetNextFromBatch() {
+    next_batch_.Reset(0);
+    next_batch_idx_ = 0;
+  }
+
   ExecutorContext *exec_ctx_;
+
+ private:
+  TupleBatch next_batch_;
+  uint32_t next_batch_idx_{0};
 };
 }  // namespace bustub
@@ -0,0 +1,132 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_executor.h
+//
+// Identification: src/include/execution/executors/hash_join_executor.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/hash_join_plan.h"
+#include "storage/table/tuple.h"
+#include "type/type_id.h"
+
+namespace bustub {
+/**
+ * HashJoinExecutor executes an equi-join by building a hash table on the smaller child and probing it with the
+ * tuples of the other one.
+ *
+ * Init() reads the whole left side, then the right side until it has more tuples than the left; the side that
+ * ended up smaller is the build side. The hash table is laid out by bucket: the (hash, row) entries of a bucket
+ * and their keys are contiguous, so a probe reads one short range instead of chasing pointers.
+ *
+ * If the hash table of the build side would not fit in L2_CACHE_SIZE, both sides are radix partitioned by the
+ * high bits of the key hash, and partitions are joined one after the other, each with a hash table that fits in
+ * the cache. That needs all the tuples of the probe side in memory; otherwise the rest of the probe side is only
+ * read a batch at a time, as the output is produced.
+ *
+ * Keys of both sides are hashed as one type, so that keys that compare equal across numeric types hash alike:
+ * integers as BIGINT, or as DECIMAL if either key is DECIMAL. Other mixed key types are rejected by Init().
+ */
+class HashJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new hash join executor.
+   * @param exec_ctx the executor context
+   * @param plan the hash join plan to be executed
+   * @param left_executor the child executor that produces tuple for the left side of join
+   * @param right_executor the child executor that produces tuple for the right side of join
+   */
+  HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
+                   std::unique_ptr<AbstractExecutor> &&left_executor,
+                   std::unique_ptr<AbstractExecutor> &&right_executor);
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  bool NextBatch(TupleBatch *batch) override;
+
+  /** @return the number of radix partitions the join runs in, 1 if the build side fits in the cache */
+  size_t GetNumPartitions() const { return partitions_.size(); }
+
+ private:
+  // cache budget of the hash table of one partition
+  static constexpr size_t L2_CACHE_SIZE = 256 * 1024;
+
+  /** The tuples of one side, with their join key and its hash. Tuples with a NULL key are left out. */
+  struct JoinRows {
+    std::vector<Tuple> tuples_;
+    std::vector<Value> keys_;
+    std::vector<hash_t> hashes_;
+  };
+
+  /** One entry of the hash table, row indexes the build side. */
+  struct Entry {
+    hash_t hash_;
+    uint32_t row_;
+  };
+
+  /** The rows of both sides whose hash falls in one radix partition. */
+  struct Partition {
+    std::vector<uint32_t> build_rows_;
+    std::vector<uint32_t> probe_rows_;
+  };
+
+  // the type join keys are hashed as, throws if left and right keys cannot be compared
+  static TypeId JoinKeyType(TypeId left, TypeId right);
+  // read the next batch of child into rows, false at the end of child
+  bool ReadBatch(AbstractExecutor *child, const AbstractExpression *key_expr, JoinRows *rows);
+  // split the rows of both sides into 2^radix_bits_ partitions
+  void PartitionRows();
+  // build the hash table on the given rows of the build side
+  void BuildTable(const std::vector<uint32_t> &build_rows);
+  // move to the next probe row and its bucket, false when all are joined
+  bool NextProbeRow();
+
+  /** The hash join plan node to be executed. */
+  const HashJoinPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> left_executor_;
+  std::unique_ptr<AbstractExecutor> right_executor_;
+
+  /** The type of the join keys in JoinRows, both sides are cast to it. */
+  TypeId key_type_{TypeId::INVALID};
+  JoinRows build_;
+  JoinRows probe_;
+  bool build_is_left_{true};
+  /** Reused by ReadBatch(). */
+  TupleBatch read_batch_;
+  std::vector<Value> read_keys_;
+  /** The probe child if it still has tuples to read, nullptr once it is exhausted or fully read. */
+  AbstractExecutor *probe_child_{nullptr};
+
+  size_t radix_bits_{0};
+  std::vector<Partition> partitions_;
+  size_t cur_partition_{0};
+
+  /** The hash table of the current partition: bucket b holds entries_[bucket_offsets_[b], bucket_offsets_[b + 1]) */
+  std::vector<uint32_t> bucket_offsets_;
+  std::vector<Entry> entries_;
+  /** The key of each entry. */
+  std::vector<Value> entry_keys_;
+  hash_t bucket_mask_{0};
+
+  /** The next row of the current partition to probe with, and the bucket range of the row being probed. */
+  size_t probe_pos_{0};
+  uint32_t probe_row_{0};
+  uint32_t entry_pos_{0};
+  uint32_t entry_end_{0};
+};
+}  // namespace bustub
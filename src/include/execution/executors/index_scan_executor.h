@@ -17,15 +17,21 @@
 #include "common/rid.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/expressions/abstract_expression.h"
 #include "execution/plans/index_scan_plan.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
- * IndexScanExecutor executes an index scan over a table.
+ * IndexScanExecutor executes an index scan over a table: a lookup of the key of the plan in the index.
+ *
+ * If the index is covering and the output columns and the predicate only read key and included columns, the scan
+ * is index-only: Index::ScanKey returns the included columns from the leaves, and the rows are built from them and
+ * the key without reading the table heap. Otherwise the matching tuples are fetched by RID. Either way the rows are
+ * decoded into a batch of the table schema, then filtered and projected as in SeqScanExecutor.
  */
-
 class IndexScanExecutor : public AbstractExecutor {
  public:
   /**
@@ -41,8 +47,37 @@ class IndexScanExecutor : public AbstractExecutor {
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  bool NextBatch(TupleBatch *batch) override;
+
+  /** @return true if the scan does not read the table heap, set by Init() */
+  bool IsIndexOnly() const { return index_only_; }
+
  private:
+  // whether expr only reads table columns i with covered[i]
+  static bool IsCovered(const AbstractExpression *expr, const std::vector<bool> &covered);
+
+  // decode up to a batch of matching rows into scan_batch_, false when all matches are read
+  bool FillScanBatch();
+
   /** The index scan plan node to be executed. */
   const IndexScanPlanNode *plan_;
+  TableMetadata *table_info_{nullptr};
+  IndexInfo *index_info_{nullptr};
+  bool index_only_{false};
+
+  // RIDs matching the key; on index-only scans included_[i] holds the included columns of rids_[i]
+  std::vector<RID> rids_;
+  std::vector<Tuple> included_;
+  size_t next_match_{0};
+  // index-only scans: a row of the table schema with the key columns set, the included columns are filled per
+  // match, the other columns are never read
+  std::vector<Value> covered_row_;
+
+  // table rows before predicate and projection
+  TupleBatch scan_batch_;
+  // output columns being evaluated, swapped with the batch
+  std::vector<std::vector<Value>> out_columns_;
+  std::vector<RID> out_rids_;
+  std::vector<Value> predicate_values_;
 };
 }  // namespace bustub
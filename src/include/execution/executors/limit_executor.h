@@ -21,6 +21,7 @@
 namespace bustub {
 /**
  * LimitExecutor limits the number of output tuples with an optional offset.
+ * It works on the batches of the child in place, by narrowing their selection.
  */
 class LimitExecutor : public AbstractExecutor {
  public:
@@ -39,10 +40,16 @@ class LimitExecutor : public AbstractExecutor {
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  bool NextBatch(TupleBatch *batch) override;
+
  private:
   /** The limit plan node to be executed. */
   const LimitPlanNode *plan_;
   /** The child executor to obtain value from. */
   std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The number of tuples skipped for the offset so far. */
+  size_t skipped_{0};
+  /** The number of tuples returned so far. */
+  size_t emitted_{0};
 };
 }  // namespace bustub
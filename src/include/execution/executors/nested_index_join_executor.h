@@ -29,6 +29,10 @@ namespace bustub {
 
 /**
  * IndexJoinExecutor executes index join operations.
+ *
+ * The outer side is read a batch at a time. The key of each outer row is the value of the side of the predicate
+ * that refers to the outer tuple; the keys of a whole batch are probed with one Index::ScanKeys() call, then the
+ * inner tuples they point to are fetched and checked against the full predicate.
  */
 class NestIndexJoinExecutor : public AbstractExecutor {
  public:
@@ -47,8 +51,27 @@ class NestIndexJoinExecutor : public AbstractExecutor {
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  bool NextBatch(TupleBatch *batch) override;
+
  private:
+  // read the next outer batch and probe the index with its keys, false when the outer side is exhausted
+  bool ProbeNextBatch();
+
   /** The nested index join plan node. */
   const NestedIndexJoinPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  TableMetadata *inner_table_info_{nullptr};
+  IndexInfo *index_info_{nullptr};
+  /** The side of the predicate that gives the index key of an outer tuple. */
+  const AbstractExpression *outer_key_expr_{nullptr};
+
+  /** The current outer batch, outer_idx_ is its row being joined. */
+  TupleBatch outer_batch_;
+  uint32_t outer_idx_{0};
+  Tuple outer_tuple_;
+  /** The RIDs of the inner tuples matching each row of the outer batch. */
+  std::vector<std::vector<RID>> matches_;
+  /** The next match of the current outer row. */
+  size_t match_idx_{0};
 };
 }  // namespace bustub
@@ -14,6 +14,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
@@ -24,6 +25,9 @@ namespace bustub {
 /**
  * NestedLoopJoinExecutor joins two tables using nested loop.
  * The child executor can either be a sequential scan
+ *
+ * Init() reads the whole right side once. The left side is read a batch at a time, each of its rows is joined with
+ * every right tuple, and the output is returned in batches.
  */
 class NestedLoopJoinExecutor : public AbstractExecutor {
  public:
@@ -45,8 +49,20 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  bool NextBatch(TupleBatch *batch) override;
+
  private:
   /** The NestedLoop plan node to be executed. */
   const NestedLoopJoinPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> left_executor_;
+  std::unique_ptr<AbstractExecutor> right_executor_;
+  /** All the tuples of the right side. */
+  std::vector<Tuple> right_tuples_;
+  /** The current batch of the left side, left_idx_ is its row being joined. */
+  TupleBatch left_batch_;
+  uint32_t left_idx_{0};
+  Tuple left_tuple_;
+  /** The next right tuple to join with the current left row. */
+  size_t right_idx_{0};
 };
 }  // namespace bustub
@@ -17,12 +17,17 @@
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "execution/tuple_batch.h"
+#include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
  * SeqScanExecutor executes a sequential scan over a table.
+ *
+ * The scan is batched: the tuples of the table pages are decoded into a batch of the table schema, the predicate
+ * shrinks its selection, and the output columns are evaluated on the selected rows only.
  */
 class SeqScanExecutor : public AbstractExecutor {
  public:
@@ -37,10 +42,31 @@ class SeqScanExecutor : public AbstractExecutor {
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  bool NextBatch(TupleBatch *batch) override;
+
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
 
  private:
+  // decode up to a batch of table tuples into scan_batch_, false at the end of the table
+  bool FillScanBatch();
+
   /** The sequential scan plan node to be executed. */
   const SeqScanPlanNode *plan_;
+  TableHeap *table_heap_{nullptr};
+  const Schema *table_schema_{nullptr};
+
+  // pages of the table, read in order
+  std::vector<page_id_t> page_ids_;
+  size_t next_page_{0};
+  // tuples of the current page not in a batch yet
+  std::vector<Tuple> page_tuples_;
+  size_t page_tuple_idx_{0};
+
+  // table tuples before predicate and projection
+  TupleBatch scan_batch_;
+  // output columns being evaluated, swapped with the batch
+  std::vector<std::vector<Value>> out_columns_;
+  std::vector<RID> out_rids_;
+  std::vector<Value> predicate_values_;
 };
 }  // namespace bustub
@@ -16,6 +16,7 @@
 #include <vector>
 
 #include "catalog/schema.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -39,6 +40,21 @@ class AbstractExpression {
   /** @return the value obtained by evaluating the tuple with the given schema */
   virtual Value Evaluate(const Tuple *tuple, const Schema *schema) const = 0;
 
+  /**
+   * Evaluates the expression on every selected row of a batch. The default materializes each row as a tuple,
+   * expressions that can work on the column vectors directly override it.
+   * @param batch the batch to evaluate on
+   * @param schema the schema of the columns of the batch
+   * @param[out] result the value for each selected row of the batch, in order
+   */
+  virtual void EvaluateBatch(const TupleBatch &batch, const Schema *schema, std::vector<Value> *result) const {
+    result->clear();
+    for (uint32_t i = 0; i < batch.Size(); i++) {
+      Tuple tuple = batch.GetTuple(i, schema);
+      result->push_back(Evaluate(&tuple, schema));
+    }
+  }
+
   /**
    * Returns the value obtained by evaluating a join.
    * @param left_tuple the left tuple
@@ -35,6 +35,13 @@ class ColumnValueExpression : public AbstractExpression {
 
   Value Evaluate(const Tuple *tuple, const Schema *schema) const override { return tuple->GetValue(schema, col_idx_); }
 
+  void EvaluateBatch(const TupleBatch &batch, const Schema *schema, std::vector<Value> *result) const override {
+    result->clear();
+    for (uint32_t i = 0; i < batch.Size(); i++) {
+      result->push_back(batch.GetValue(col_idx_, i));
+    }
+  }
+
   Value EvaluateJoin(const Tuple *left_tuple, const Schema *left_schema, const Tuple *right_tuple,
                      const Schema *right_schema) const override {
     return tuple_idx_ == 0 ? left_tuple->GetValue(left_schema, col_idx_)
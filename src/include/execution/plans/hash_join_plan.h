@@ -0,0 +1,64 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_plan.h
+//
+// Identification: src/include/execution/plans/hash_join_plan.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+/**
+ * HashJoinPlanNode represents an equi-join of two children: a left tuple and a right tuple are joined if their join
+ * keys are equal. A NULL key joins nothing.
+ */
+class HashJoinPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new hash join plan node.
+   * @param output_schema the output format of this hash join node, tuple index 0 is the left side, 1 the right side
+   * @param children the left and the right children plans
+   * @param left_key_expression the join key of a left tuple, evaluated on the output schema of the left child
+   * @param right_key_expression the join key of a right tuple, evaluated on the output schema of the right child
+   */
+  HashJoinPlanNode(const Schema *output_schema, std::vector<const AbstractPlanNode *> &&children,
+                   const AbstractExpression *left_key_expression, const AbstractExpression *right_key_expression)
+      : AbstractPlanNode(output_schema, std::move(children)),
+        left_key_expression_(left_key_expression),
+        right_key_expression_(right_key_expression) {}
+
+  PlanType GetType() const override { return PlanType::HashJoin; }
+
+  /** @return the expression giving the join key of a left tuple */
+  const AbstractExpression *LeftJoinKeyExpression() const { return left_key_expression_; }
+
+  /** @return the expression giving the join key of a right tuple */
+  const AbstractExpression *RightJoinKeyExpression() const { return right_key_expression_; }
+
+  /** @return the left plan node of the hash join */
+  const AbstractPlanNode *GetLeftPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Hash joins should have exactly two children plans.");
+    return GetChildAt(0);
+  }
+
+  /** @return the right plan node of the hash join */
+  const AbstractPlanNode *GetRightPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Hash joins should have exactly two children plans.");
+    return GetChildAt(1);
+  }
+
+ private:
+  const AbstractExpression *left_key_expression_;
+  const AbstractExpression *right_key_expression_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.h
+//
+// Identification: src/include/execution/tuple_batch.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * TupleBatch holds up to BATCH_SIZE rows of an executor's output, one value
+ * vector per column of the output schema, plus the RID of each row.
+ *
+ * The selection vector lists the physical rows that are still part of the
+ * batch, in order. Filters and limits only shrink the selection, the column
+ * vectors are left alone. Every accessor below takes the position of a row
+ * in the selection, not its physical index.
+ *
+ * The vectors keep their capacity over Reset(), so an executor that reuses
+ * its batch does not allocate per batch.
+ */
+class TupleBatch {
+ public:
+  /** Maximum number of rows of a batch. */
+  static constexpr uint32_t BATCH_SIZE = 1024;
+
+  TupleBatch() = default;
+
+  /** Empties the batch and gives it num_columns columns. */
+  void Reset(uint32_t num_columns);
+
+  /** @return the number of columns */
+  uint32_t GetColumnCount() const { return static_cast<uint32_t>(columns_.size()); }
+
+  /** @return the number of selected rows */
+  uint32_t Size() const { return static_cast<uint32_t>(selection_.size()); }
+
+  /** @return true if no more rows can be appended */
+  bool IsFull() const { return rids_.size() >= BATCH_SIZE; }
+
+  /** @return the value of column col_idx in the idx'th selected row */
+  const Value &GetValue(uint32_t col_idx, uint32_t idx) const { return columns_[col_idx][selection_[idx]]; }
+
+  /** @return the RID of the idx'th selected row */
+  const RID &GetRid(uint32_t idx) const { return rids_[selection_[idx]]; }
+
+  /** @return the idx'th selected row as a tuple of schema */
+  Tuple GetTuple(uint32_t idx, const Schema *schema) const;
+
+  /** Appends a row, values holds one value per column. */
+  void AppendRow(const std::vector<Value> &values, const RID &rid);
+
+  /** Appends a row decoded from tuple, schema must have as many columns as the batch. */
+  void AppendTuple(const Tuple &tuple, const Schema *schema) { AppendTuple(tuple, schema, tuple.GetRid()); }
+
+  /** Appends a row decoded from tuple, with the given RID instead of the tuple's own. */
+  void AppendTuple(const Tuple &tuple, const Schema *schema, const RID &rid);
+
+  /**
+   * Replaces the whole content of the batch with dense columns, every row is selected. The previous vectors of
+   * the batch are handed back in columns and rids, for reuse.
+   * @param columns one vector per column, all of the same length
+   * @param rids the RID of each row
+   */
+  void SetColumns(std::vector<std::vector<Value>> *columns, std::vector<RID> *rids);
+
+  /**
+   * Keeps the selected rows for which predicate is true.
+   * @param predicate one boolean per selected row, as produced by AbstractExpression::EvaluateBatch
+   */
+  void Select(const std::vector<Value> &predicate);
+
+  /** Keeps count selected rows, starting from the offset'th one. */
+  void Slice(uint32_t offset, uint32_t count);
+
+ private:
+  std::vector<std::vector<Value>> columns_;
+  std::vector<RID> rids_;
+  // 选中的物理行号，递增
+  std::vector<uint32_t> selection_;
+};
+
+}  // namespace bustub
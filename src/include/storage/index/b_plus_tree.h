@@ -10,37 +10,57 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <queue>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "concurrency/transaction.h"
+#include "container/hash/hash_function.h"
+#include "storage/index/bloom_filter.h"
+#include "storage/index/covering_value.h"
 #include "storage/index/index_iterator.h"
+#include "storage/index/index_stats.h"
+#include "storage/index/separator_key.h"
+#include "storage/index/shadow_page_manager.h"
+#include "storage/index/snapshot_index_iterator.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 namespace bustub {
 
 #define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
+// default max size of the internal pages, which hold (separator, page id) pairs
+#define BPLUSTREE_INTERNAL_PAGE_SIZE \
+  ((PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(std::pair<SeparatorKey<KeyType>, page_id_t>)))
 
 /**
  * Main class providing the API for the Interactive B+ Tree.
  *
  * Implementation of simple b+ tree data structure where internal pages direct
  * the search and leaf pages contain actual data.
- * (1) We only support unique key
+ * (1) Keys are unique by default, SetUniqueKeys(false) allows duplicate keys,
+ *     which are ordered by RID (the internal pages separate on key + RID)
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
-  using InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>;
+  using InternalKey = SeparatorKey<KeyType>;
+  using InternalComparator = SeparatorComparator<KeyType, KeyComparator>;
+  using InternalPage = BPlusTreeInternalPage<InternalKey, page_id_t, InternalComparator>;
   using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
 
  public:
   explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = BPLUSTREE_INTERNAL_PAGE_SIZE);
+
+  // Releases the pinned upper levels and flushes a deferred root page id, the buffer pool must still be alive.
+  ~BPlusTree();
 
   // Returns true if this B+ tree has no keys and values.
   bool IsEmpty() const;
@@ -51,14 +71,94 @@ class BPlusTree {
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
+  // Remove the exact key & value pair, needed when keys are not unique.
+  bool Remove(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+
   // return the value associated with a given key
   bool GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr);
 
+  // Batched lookup: (*result)[i] receives the values of keys[i]. The batch is
+  // sorted and walked in one pass, adjacent keys share the root-to-leaf path.
+  void GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *result,
+                 Transaction *transaction = nullptr);
+
+  // Batched insert in key order, sharing the path like GetValues. Returns the number of inserted pairs.
+  int InsertBatch(const std::vector<MappingType> &entries, Transaction *transaction = nullptr);
+
+  // Build an empty tree bottom up from pairs sorted by key (then RID, if keys are not unique; they are sorted here
+  // otherwise). Returns false if the tree is not empty.
+  bool BulkLoad(std::vector<MappingType> *entries, Transaction *transaction = nullptr);
+
+  // Allow duplicate keys. Must be set before the first insert.
+  void SetUniqueKeys(bool unique_keys) { unique_keys_ = unique_keys; }
+
+  // Rebalance a non-root node on delete only when its size drops below ratio * max size (0.5 by default).
+  // A lower ratio, e.g. 0.25, or 0 to merge only empty nodes, leaves room for reinserts without re-splitting.
+  void SetMergeThreshold(double ratio) { merge_threshold_ = ratio; }
+
+  // Rebalance the leaves left underfull by a relaxed merge threshold back to the regular minimum size.
+  void Compact(Transaction *transaction = nullptr);
+
+  // Find keys inside the pages by interpolation, with a binary search fallback for skewed pages. Only integer keys
+  // compared by GenericIntegerComparator support it, returns false for the other comparators.
+  bool SetInterpolationSearch(bool enable);
+
+  // Keep the internal pages of the top "levels" levels (the root is level 0) pinned, so that lookups reach them
+  // without going through the buffer pool. 0 (the default) disables it. The pool must have room for these pages.
+  void SetPinnedLevels(int levels);
+
+  // Only write the root page id to the header page on FlushRootPageId() or destruction, not on every root change.
+  void SetDeferRootUpdates(bool defer) {
+    defer_root_updates_ = defer;
+    if (!defer) {
+      FlushRootPageId();
+    }
+  }
+  void FlushRootPageId();
+
+  page_id_t GetRootPageId() const { return root_page_id_; }
+
+  // Keep a blocked bloom filter of the keys, so that GetValue, GetValues and Remove of a missing key usually return
+  // without reading the tree. It is built from the current entries and sized for expected_keys; once more keys were
+  // inserted, it is rebuilt twice as large. Removed keys stay in the filter until it is rebuilt.
+  void EnableBloomFilter(size_t expected_keys, int bits_per_key = 10);
+  void DisableBloomFilter() { bloom_filter_.reset(); }
+  // rebuild the filter from the current entries, which drops the removed keys
+  void RebuildBloomFilter(size_t expected_keys);
+
+  // Shadow paging: writers keep the before-image of the pages they change while snapshots are open, so that a
+  // snapshot reads the tree as it was when taken, from any thread, while this tree goes on taking writes (see
+  // ShadowPageManager). Must be set while no other thread uses the tree; turning it off frees all versions, no
+  // snapshot may be open then.
+  void SetShadowPaging(bool enable);
+  // Freeze the current contents of the tree, shadow paging must be on. The id is passed to the snapshot reads.
+  uint64_t TakeSnapshot();
+  // Close a snapshot: the page versions kept only for it are freed.
+  void ReleaseSnapshot(uint64_t snapshot);
+  // GetValue on a snapshot
+  bool GetValueAt(uint64_t snapshot, const KeyType &key, std::vector<ValueType> *result);
+  // scan of a snapshot, from the first key / the first key >= key / over [lo, hi)
+  SNAPSHOT_INDEXITERATOR_TYPE SnapshotBegin(uint64_t snapshot);
+  SNAPSHOT_INDEXITERATOR_TYPE SnapshotBegin(uint64_t snapshot, const KeyType &key);
+  SNAPSHOT_INDEXITERATOR_TYPE SnapshotBegin(uint64_t snapshot, const KeyType &lo, const KeyType &hi);
+
+  // Walk the tree and fill *stats, reading only every leaf_sample_rate-th leaf. The upper bounds of the
+  // num_buckets equi-depth histogram buckets are returned as keys in *bounds, stats->bucket_bounds_ is left empty.
+  void CollectStats(IndexStats *stats, std::vector<KeyType> *bounds, size_t num_buckets, int leaf_sample_rate = 1);
+
   // index iterator
   INDEXITERATOR_TYPE begin();
   INDEXITERATOR_TYPE Begin(const KeyType &key);
   INDEXITERATOR_TYPE end();
 
+  // bounded range scan over [lo, hi)
+  INDEXITERATOR_TYPE Begin(const KeyType &lo, const KeyType &hi);
+
+  // reverse scans, from the last key / the last key <= key / the last key < hi down to lo
+  INDEXITERATOR_TYPE RBegin();
+  INDEXITERATOR_TYPE RBegin(const KeyType &key);
+  INDEXITERATOR_TYPE RBegin(const KeyType &lo, const KeyType &hi);
+
   void Print(BufferPoolManager *bpm) {
     ToString(reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(root_page_id_)->GetData()), bpm);
   }
@@ -78,13 +178,45 @@ class BPlusTree {
   void RemoveFromFile(const std::string &file_name, Transaction *transaction = nullptr);
   // expose for test purpose
   Page *FindLeafPage(const KeyType &key, bool leftMost = false);
+  Page *FindRightMostLeafPage();
 
  private:
   void StartNewTree(const KeyType &key, const ValueType &value);
 
   bool InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
 
-  void InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
+  Page *FindEntry(const KeyType &key, const ValueType *value, int *index);
+
+  // the leaf holding separator: the first pair of a key is under InternalKey::First(key)
+  Page *FindLeafPage(const InternalKey &separator, bool leftMost = false);
+
+  // comparator of the internal pages, built on the fly so that it follows SetUniqueKeys and SetInterpolationSearch
+  InternalComparator GetInternalComparator() const { return InternalComparator(comparator_, !unique_keys_); }
+
+  // separator of a pair, and the order of the pairs in the leaves
+  static InternalKey SeparatorOf(const MappingType &item) {
+    return InternalKey(item.first, IndexValue<ValueType>::GetRid(item.second));
+  }
+  bool EntryLess(const MappingType &lhs, const MappingType &rhs) const {
+    return GetInternalComparator()(SeparatorOf(lhs), SeparatorOf(rhs)) < 0;
+  }
+
+  // one pinned node on the path kept by the batched operations
+  struct PathEntry {
+    Page *page_;
+    // separators of the subtree are < upper_
+    InternalKey upper_;
+    bool has_upper_;
+    bool dirty_;
+  };
+
+  Page *FindLeafPageOnPath(const InternalKey &separator, std::vector<PathEntry> *path);
+
+  void ReleasePath(std::vector<PathEntry> *path);
+
+  bool RemoveEntry(const KeyType &key, const ValueType *value, Transaction *transaction);
+
+  void InsertIntoParent(BPlusTreePage *old_node, const InternalKey &key, BPlusTreePage *new_node,
                         Transaction *transaction = nullptr);
 
   template <typename N>
@@ -94,16 +226,35 @@ class BPlusTree {
   bool CoalesceOrRedistribute(N *node, Transaction *transaction = nullptr);
 
   template <typename N>
-  bool Coalesce(N **neighbor_node, N **node, BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> **parent,
-                int index, Transaction *transaction = nullptr);
+  bool Coalesce(N **neighbor_node, N **node, InternalPage **parent, int index, Transaction *transaction = nullptr);
 
   template <typename N>
   void Redistribute(N *neighbor_node, N *node, int index);
 
   bool AdjustRoot(BPlusTreePage *node);
 
+  int MinSize(const BPlusTreePage *node) const;
+
   void UpdateRootPageId(int insert_record = 0);
 
+  // read-only descent: internal pages of the pinned levels come from pinned_pages_
+  Page *FetchNode(page_id_t page_id, int level);
+  void UnpinNode(Page *page, int level);
+  void ReleasePinnedPage(page_id_t page_id);
+  void ReleasePinnedPages();
+
+  // shadow paging hooks, no-ops while it is off: call ShadowPage before changing a page that is in the tree, and
+  // DeleteNode instead of BufferPoolManager::DeletePage
+  void ShadowPage(page_id_t page_id);
+  void DeleteNode(page_id_t page_id);
+  // copy of the leaf of the snapshot holding key, the leftmost leaf if key is nullptr; nullptr if the snapshot is empty
+  std::unique_ptr<char[]> FindSnapshotLeaf(uint64_t snapshot, const KeyType *key);
+
+  // true if there is no filter
+  bool BloomMayContain(const KeyType &key);
+  // add an inserted key to the filter, if there is one
+  void BloomInsert(const KeyType &key);
+
   /* Debug Routines for FREE!! */
   void ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::ofstream &out) const;
 
@@ -111,11 +262,29 @@ class BPlusTree {
 
   // member variable
   std::string index_name_;
-  page_id_t root_page_id_;
+  std::atomic<page_id_t> root_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
+  bool unique_keys_;
+  double merge_threshold_;
+  int pinned_levels_;
+  std::unordered_map<page_id_t, Page *> pinned_pages_;
+  bool defer_root_updates_;
+  // -1: header page up to date, otherwise the insert_record of the pending UpdateRootPageId
+  int pending_root_update_;
+  std::unique_ptr<BloomFilter> bloom_filter_;
+  HashFunction<KeyType> bloom_hash_;
+  int bloom_bits_per_key_{10};
+  // keys the filter was sized for, and keys added since it was built
+  size_t bloom_capacity_{0};
+  size_t bloom_keys_{0};
+  // lookups answered by the filter alone, and lookups it let through for a missing key
+  uint64_t bloom_negatives_{0};
+  uint64_t bloom_false_positives_{0};
+  // nullptr while shadow paging is off
+  std::unique_ptr<ShadowPageManager> shadow_;
   page_id_t FindLeafBro(BPlusTreePage *pPage);
   page_id_t FindRightBro(BPlusTreePage *pPage);
 
@@ -16,15 +16,24 @@
 #include <vector>
 
 #include "storage/index/b_plus_tree.h"
+#include "storage/index/covering_value.h"
 #include "storage/index/index.h"
+#include "storage/table/table_heap.h"
 
 namespace bustub {
 
 #define BPLUSTREE_INDEX_TYPE BPlusTreeIndex<KeyType, ValueType, KeyComparator>
 
+/**
+ * B+ tree index. ValueType is RID, or CoveringValue<N> for a covering index
+ * whose leaves also hold the included columns.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeIndex : public Index {
  public:
+  using Index::InsertEntry;
+  using Index::ScanKey;
+
   BPlusTreeIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager);
 
   void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
@@ -33,12 +42,43 @@ class BPlusTreeIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  void InsertEntry(const Tuple &key, const Tuple &included, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, std::vector<Tuple> *included,
+               Transaction *transaction) override;
+
+  /**
+   * Build the (empty) index from all the tuples of a table: num_threads threads scan disjoint page ranges and sort
+   * their keys, the sorted runs are merged and bulk loaded into the tree.
+   * If the index is unique and two tuples share a key, throws an Exception instead of keeping one of them.
+   * @param table_heap the indexed table
+   * @param schema the schema of the table
+   * @param num_threads number of scanning threads
+   */
+  void BuildFromTable(TableHeap *table_heap, const Schema &schema, size_t num_threads, Transaction *transaction);
+
+  void CollectStats(IndexStats *stats, size_t num_buckets, int leaf_sample_rate) override;
+
+  // see BPlusTree::EnableBloomFilter, the filter statistics are part of CollectStats
+  void EnableBloomFilter(size_t expected_keys, int bits_per_key = 10) {
+    container_.EnableBloomFilter(expected_keys, bits_per_key);
+  }
+
+  // see BPlusTree::SetInterpolationSearch
+  bool SetInterpolationSearch(bool enable) { return container_.SetInterpolationSearch(enable); }
+
   INDEXITERATOR_TYPE GetBeginIterator();
 
   INDEXITERATOR_TYPE GetBeginIterator(const KeyType &key);
 
   INDEXITERATOR_TYPE GetEndIterator();
 
+  // scan over [lo, hi), ends by itself
+  INDEXITERATOR_TYPE GetBeginIterator(const KeyType &lo, const KeyType &hi);
+
+  // scan from the last key backwards, e.g. ORDER BY key DESC
+  INDEXITERATOR_TYPE GetReverseBeginIterator();
+
  protected:
   // comparator for key
   KeyComparator comparator_;
@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter.h
+//
+// Identification: src/include/storage/index/bloom_filter.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bustub {
+
+/**
+ * Blocked bloom filter over 64 bit key hashes (Putze et al., "Cache-, Hash-
+ * and Space-Efficient Bloom Filters"). The high half of the hash picks one
+ * 512 bit block, one cache line, and all the bits of a key are set in that
+ * block, so a probe costs a single cache miss. The low half derives the bit
+ * positions by double hashing.
+ *
+ * MayContain never misses an inserted hash; it wrongly says yes for about
+ * (1 - e^(-k / bits_per_key))^k of the others, slightly more than a classic
+ * filter because the blocks do not fill evenly. Bits cannot be cleared, so
+ * removed keys stay in the filter until it is rebuilt.
+ */
+class BloomFilter {
+ public:
+  /**
+   * @param expected_keys number of keys the filter is sized for
+   * @param bits_per_key filter bits per expected key, 10 gives about 1% false positives
+   */
+  explicit BloomFilter(size_t expected_keys, int bits_per_key = 10);
+
+  void Insert(uint64_t hash);
+
+  // false: the hash was never inserted. true: it probably was
+  bool MayContain(uint64_t hash) const;
+
+  size_t GetNumBlocks() const { return num_blocks_; }
+
+  size_t GetSizeInBytes() const { return blocks_.size() * sizeof(uint64_t); }
+
+  int GetNumProbes() const { return num_probes_; }
+
+ private:
+  static constexpr size_t WORDS_PER_BLOCK = 8;
+  static constexpr uint32_t BITS_PER_BLOCK = WORDS_PER_BLOCK * 64;
+
+  // first word of the block of hash
+  size_t BlockOf(uint64_t hash) const;
+
+  size_t num_blocks_;
+  // bits set per key
+  int num_probes_;
+  std::vector<uint64_t> blocks_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// covering_value.h
+//
+// Identification: src/include/storage/index/covering_value.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * Leaf value of a covering index: the RID of the tuple, followed by the
+ * included (non-key) columns of the tuple. A lookup that only needs key and
+ * included columns is answered from the leaf without fetching the tuple.
+ *
+ * The payload holds the included columns serialized like a tuple of the
+ * included schema, in a fixed length array, as GenericKey does for keys.
+ * Two values are equal when their RIDs are, so a delete by (key, rid) does
+ * not need the payload.
+ */
+template <size_t PayloadSize>
+class CoveringValue {
+ public:
+  inline void SetPayload(const Tuple &included) {
+    BUSTUB_ASSERT(included.GetLength() <= PayloadSize, "included columns do not fit into the payload");
+    memset(payload_, 0, PayloadSize);
+    memcpy(payload_, included.GetData(), included.GetLength());
+  }
+
+  inline Value ToValue(const Schema *schema, uint32_t column_idx) const {
+    const auto &col = schema->GetColumn(column_idx);
+    const char *data_ptr = payload_ + col.GetOffset();
+    if (!col.IsInlined()) {
+      data_ptr = payload_ + *reinterpret_cast<const int32_t *>(data_ptr);
+    }
+    return Value::DeserializeFrom(data_ptr, col.GetType());
+  }
+
+  // the included columns as a tuple of the included schema
+  inline Tuple ToTuple(const Schema *schema) const {
+    std::vector<Value> values;
+    values.reserve(schema->GetColumnCount());
+    for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+      values.push_back(ToValue(schema, i));
+    }
+    return Tuple(values, schema);
+  }
+
+  inline bool operator==(const CoveringValue &other) const { return rid_ == other.rid_; }
+
+  RID rid_;
+  char payload_[PayloadSize];
+};
+
+/**
+ * Conversions between an index value type and RIDs / included columns, so
+ * that the index code is written once for plain (RID) and covering values.
+ */
+template <typename ValueType>
+struct IndexValue;
+
+template <>
+struct IndexValue<RID> {
+  static constexpr bool COVERING = false;
+  static constexpr size_t PAYLOAD_SIZE = 0;
+  static inline RID Make(const RID &rid, const Tuple *included) { return rid; }
+  static inline RID GetRid(const RID &value) { return value; }
+};
+
+template <size_t PayloadSize>
+struct IndexValue<CoveringValue<PayloadSize>> {
+  static constexpr bool COVERING = true;
+  static constexpr size_t PAYLOAD_SIZE = PayloadSize;
+  static inline CoveringValue<PayloadSize> Make(const RID &rid, const Tuple *included) {
+    CoveringValue<PayloadSize> value;
+    value.rid_ = rid;
+    memset(value.payload_, 0, PayloadSize);
+    if (included != nullptr) {
+      value.SetPayload(*included);
+    }
+    return value;
+  }
+  static inline RID GetRid(const CoveringValue<PayloadSize> &value) { return value.rid_; }
+};
+
+}  // namespace bustub
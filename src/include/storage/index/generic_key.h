@@ -13,6 +13,8 @@
 #pragma once
 
 #include <cstring>
+#include <type_traits>
+#include <utility>
 
 #include "storage/table/tuple.h"
 #include "type/value.h"
@@ -103,4 +105,49 @@ class GenericComparator {
   Schema *key_schema_;
 };
 
+/**
+ * Comparator for keys whose first 8 bytes hold a single int64_t, i.e. a one-column BIGINT key or a key built with
+ * SetFromInteger(). It skips the Value round trip of GenericComparator, and the B+ tree pages specialize their
+ * search on it (see b_plus_tree_key_search.h).
+ */
+template <size_t KeySize>
+class GenericIntegerComparator {
+  static_assert(KeySize >= sizeof(int64_t), "integer keys need at least 8 bytes");
+
+ public:
+  inline int operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const {
+    int64_t lhs_value = ToInteger(lhs);
+    int64_t rhs_value = ToInteger(rhs);
+    return lhs_value < rhs_value ? -1 : (lhs_value > rhs_value ? 1 : 0);
+  }
+
+  static inline int64_t ToInteger(const GenericKey<KeySize> &key) {
+    int64_t value;
+    memcpy(&value, key.data_, sizeof(int64_t));
+    return value;
+  }
+
+  // Search the pages by interpolation before falling back to binary search, for keys spread about evenly over
+  // their range (dense ids, timestamps). Part of the comparator so that each tree carries its own choice.
+  void SetInterpolationSearch(bool enable) { interpolation_search_ = enable; }
+  bool UseInterpolationSearch() const { return interpolation_search_; }
+
+  GenericIntegerComparator(const GenericIntegerComparator &other) = default;
+
+  // the key schema is accepted so that indexes can build this comparator like GenericComparator
+  explicit GenericIntegerComparator(Schema *key_schema = nullptr) {}
+
+ private:
+  bool interpolation_search_{false};
+};
+
+// true for the comparators that take SetInterpolationSearch
+template <typename KeyComparator, typename = void>
+struct HasInterpolationSearch : std::false_type {};
+
+template <typename KeyComparator>
+struct HasInterpolationSearch<
+    KeyComparator, std::void_t<decltype(std::declval<KeyComparator &>().SetInterpolationSearch(true))>>
+    : std::true_type {};
+
 }  // namespace bustub
@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// in_memory_b_plus_tree.h
+//
+// Identification: src/include/storage/index/in_memory_b_plus_tree.h
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "common/arena.h"
+#include "concurrency/transaction.h"
+#include "storage/index/generic_key.h"
+#include "storage/index/in_memory_index_iterator.h"
+#include "storage/page/b_plus_tree_internal_page.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+
+namespace bustub {
+
+#define IN_MEMORY_BPLUSTREE_TYPE InMemoryBPlusTree<KeyType, ValueType, KeyComparator>
+
+/**
+ * B+ tree whose nodes live in memory and point to each other directly, for
+ * ephemeral indexes (temporary join indexes, session caches) where going
+ * through the buffer pool on every node access costs more than the search.
+ * Same template parameters, lookups and iterators as BPlusTree; nothing is
+ * persisted.
+ *
+ * Nodes are placed in an Arena and freed together with the tree. Concurrent
+ * operations use optimistic lock coupling (see InMemoryNode): lookups do not
+ * write to shared memory, inserts lock the one or two nodes they change.
+ *
+ * (1) Full nodes are split on the way down, so the parent of a split always
+ *     has room
+ * (2) Remove does not merge nodes: leaves may become sparse or even empty,
+ *     which lookups and scans step over. Nodes are therefore never freed
+ *     while the tree is alive, and a stale pointer is always safe to follow
+ * (3) Keys must have a fixed size (GenericKey of inlined columns), readers may
+ *     compare a key that is being overwritten before they detect the change
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class InMemoryBPlusTree {
+  using Node = InMemoryNode;
+  using InternalNode = InMemoryInternalNode<KeyType>;
+  using LeafNode = InMemoryLeafNode<KeyType, ValueType>;
+
+ public:
+  explicit InMemoryBPlusTree(std::string name, const KeyComparator &comparator, int leaf_max_size = LEAF_PAGE_SIZE,
+                             int internal_max_size = INTERNAL_PAGE_SIZE);
+
+  DISALLOW_COPY_AND_MOVE(InMemoryBPlusTree);
+
+  // Returns true if this B+ tree has no keys and values.
+  bool IsEmpty() const;
+
+  // Insert a key-value pair into this B+ tree.
+  bool Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+
+  // Remove a key and its value from this B+ tree.
+  void Remove(const KeyType &key, Transaction *transaction = nullptr);
+
+  // Remove the exact key & value pair, needed when keys are not unique.
+  bool Remove(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+
+  // return the value associated with a given key
+  bool GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr);
+
+  // Allow duplicate keys. Must be set before the first insert.
+  void SetUniqueKeys(bool unique_keys) { unique_keys_ = unique_keys; }
+
+  // bytes allocated for the nodes
+  size_t GetMemoryUsage() { return arena_.MemoryUsage(); }
+
+  const std::string &GetName() const { return index_name_; }
+
+  // index iterator
+  IN_MEMORY_INDEXITERATOR_TYPE begin();
+  IN_MEMORY_INDEXITERATOR_TYPE Begin(const KeyType &key);
+  IN_MEMORY_INDEXITERATOR_TYPE end();
+
+  // bounded range scan over [lo, hi)
+  IN_MEMORY_INDEXITERATOR_TYPE Begin(const KeyType &lo, const KeyType &hi);
+
+  // reverse scans, from the last key / the last key <= key / the last key < hi down to lo
+  IN_MEMORY_INDEXITERATOR_TYPE RBegin();
+  IN_MEMORY_INDEXITERATOR_TYPE RBegin(const KeyType &key);
+  IN_MEMORY_INDEXITERATOR_TYPE RBegin(const KeyType &lo, const KeyType &hi);
+
+ private:
+  /*
+   * Each Try* makes one attempt and returns false if it has to restart
+   * because a node changed under it or was locked.
+   */
+  bool TryInsert(const KeyType &key, const ValueType &value, bool *inserted);
+  bool TryGetValue(const KeyType &key, std::vector<ValueType> *result, bool *found);
+  bool TryRemove(const KeyType &key, const ValueType *value, bool *removed);
+  // the leaf for key (the leftmost/rightmost leaf if key is nullptr), see ChildIndex for upper
+  bool TryFindLeaf(const KeyType *key, bool upper, bool rightMost, LeafNode **leaf) const;
+  LeafNode *FindLeaf(const KeyType *key, bool upper, bool rightMost = false) const;
+
+  /*
+   * Child of inner to descend into for key. Child i holds the keys in
+   * [key_i, key_i+1] (key_i+1 excluded if keys are unique).
+   * upper: the last child with key_i <= key, where an insert of a unique key has to go.
+   * otherwise: the last child with key_i < key, the leftmost subtree that can hold key;
+   * a search from there may have to continue into the next leaves.
+   */
+  int ChildIndex(const InternalNode *inner, int size, const KeyType &key, bool upper) const;
+  // number of entries of leaf with key < key (<= key if upper)
+  int LeafIndex(const LeafNode *leaf, int size, const KeyType &key, bool upper) const;
+
+  LeafNode *NewLeaf();
+  InternalNode *NewInternal();
+  // split the locked node in halves, the new right node is returned with its separator key
+  LeafNode *SplitLeaf(LeafNode *leaf, KeyType *separator);
+  InternalNode *SplitInternal(InternalNode *inner, KeyType *separator);
+  // link a new right sibling into the locked parent, or into a new root if left was the root
+  void InsertIntoParent(InternalNode *parent, Node *left, const KeyType &separator, Node *right);
+
+  std::string index_name_;
+  KeyComparator comparator_;
+  int leaf_max_size_;
+  int internal_max_size_;
+  bool unique_keys_{true};
+  Arena arena_;
+  std::atomic<Node *> root_;
+};
+
+}  // namespace bustub
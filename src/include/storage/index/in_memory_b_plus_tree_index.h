@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// in_memory_b_plus_tree_index.h
+//
+// Identification: src/include/storage/index/in_memory_b_plus_tree_index.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "storage/index/covering_value.h"
+#include "storage/index/in_memory_b_plus_tree.h"
+#include "storage/index/index.h"
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+#define IN_MEMORY_BPLUSTREE_INDEX_TYPE InMemoryBPlusTreeIndex<KeyType, ValueType, KeyComparator>
+
+/**
+ * Index backed by an InMemoryBPlusTree, for ephemeral indexes that do not
+ * need the buffer pool. Same interface as BPlusTreeIndex; its contents are
+ * lost with the index.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class InMemoryBPlusTreeIndex : public Index {
+ public:
+  using Index::InsertEntry;
+  using Index::ScanKey;
+
+  explicit InMemoryBPlusTreeIndex(IndexMetadata *metadata);
+
+  void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+  void InsertEntry(const Tuple &key, const Tuple &included, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, std::vector<Tuple> *included,
+               Transaction *transaction) override;
+
+  /**
+   * Insert all the tuples of a table: the tree takes concurrent inserts, so num_threads threads scan disjoint page
+   * ranges and insert directly.
+   * If the index is unique and two tuples share a key, throws an Exception instead of keeping one of them.
+   * @param table_heap the indexed table
+   * @param schema the schema of the table
+   * @param num_threads number of scanning threads
+   */
+  void BuildFromTable(TableHeap *table_heap, const Schema &schema, size_t num_threads, Transaction *transaction);
+
+  IN_MEMORY_INDEXITERATOR_TYPE GetBeginIterator();
+
+  IN_MEMORY_INDEXITERATOR_TYPE GetBeginIterator(const KeyType &key);
+
+  IN_MEMORY_INDEXITERATOR_TYPE GetEndIterator();
+
+  // scan over [lo, hi), ends by itself
+  IN_MEMORY_INDEXITERATOR_TYPE GetBeginIterator(const KeyType &lo, const KeyType &hi);
+
+  // scan from the last key backwards, e.g. ORDER BY key DESC
+  IN_MEMORY_INDEXITERATOR_TYPE GetReverseBeginIterator();
+
+ protected:
+  // comparator for key
+  KeyComparator comparator_;
+  // container
+  InMemoryBPlusTree<KeyType, ValueType, KeyComparator> container_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// in_memory_b_plus_tree_node.h
+//
+// Identification: src/include/storage/index/in_memory_b_plus_tree_node.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+/**
+ * Node header of the in-memory B+ tree, with the optimistic lock (Leis et al.,
+ * "Optimistic Lock Coupling"). The lock is a version counter, bit 1 set while
+ * a writer holds it:
+ *  - readers take no lock. They remember the version, read the node and check
+ *    that the version did not change before trusting what they read, or start
+ *    over (restart) otherwise.
+ *  - writers upgrade a version they have read with a CAS, so a writer also
+ *    fails if the node changed since it was read; unlocking bumps the version.
+ * No operation waits for a lock, a busy node means restart.
+ */
+struct InMemoryNode {
+  static constexpr uint64_t LOCKED = 0b10;
+
+  // @return the current version, sets *restart if the node is write locked
+  uint64_t ReadLockOrRestart(bool *restart) const {
+    uint64_t version = version_.load();
+    if ((version & LOCKED) != 0) {
+      *restart = true;
+    }
+    return version;
+  }
+
+  // sets *restart if the node changed since version was read
+  void CheckOrRestart(uint64_t version, bool *restart) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (version_.load() != version) {
+      *restart = true;
+    }
+  }
+
+  // take the write lock if the node is still at version, sets *restart otherwise
+  void UpgradeToWriteLockOrRestart(uint64_t version, bool *restart) {
+    if (!version_.compare_exchange_strong(version, version + LOCKED)) {
+      *restart = true;
+    }
+  }
+
+  void WriteUnlock() { version_.fetch_add(LOCKED); }
+
+  std::atomic<uint64_t> version_{0};
+  bool is_leaf_{false};
+  int size_{0};
+  // capacity of the array, fixed at allocation
+  int max_size_{0};
+};
+
+/**
+ * Internal node: size_ (key, child) pairs, the first key is unused, like
+ * BPlusTreeInternalPage with child pointers instead of page ids.
+ */
+template <typename KeyType>
+struct InMemoryInternalNode : public InMemoryNode {
+  std::pair<KeyType, InMemoryNode *> array_[0];
+};
+
+/**
+ * Leaf node: size_ sorted (key, value) pairs, linked to both neighbours for
+ * range scans in either direction.
+ */
+template <typename KeyType, typename ValueType>
+struct InMemoryLeafNode : public InMemoryNode {
+  InMemoryLeafNode *prev_{nullptr};
+  InMemoryLeafNode *next_{nullptr};
+  MappingType array_[0];
+};
+
+}  // namespace bustub
@@ -0,0 +1,80 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// in_memory_index_iterator.h
+//
+// Identification: src/include/storage/index/in_memory_index_iterator.h
+//
+//===----------------------------------------------------------------------===//
+/**
+ * Range scan of the in-memory B+ tree, with the interface of IndexIterator.
+ * 每到一个leaf，先在版本号校验下把整个leaf拷贝下来，之后只读这份拷贝，不会读到写了一半的leaf。
+ * 每个leaf是一致的，但整个扫描不是整棵树的快照：扫描过程中的插入/删除可能看得到也可能看不到。
+ */
+#pragma once
+#include <vector>
+
+#include "storage/index/in_memory_b_plus_tree_node.h"
+
+namespace bustub {
+
+#define IN_MEMORY_INDEXITERATOR_TYPE InMemoryIndexIterator<KeyType, ValueType, KeyComparator>
+
+INDEX_TEMPLATE_ARGUMENTS
+class InMemoryBPlusTree;
+
+INDEX_TEMPLATE_ARGUMENTS
+class InMemoryIndexIterator {
+  using LeafNode = InMemoryLeafNode<KeyType, ValueType>;
+  friend class InMemoryBPlusTree<KeyType, ValueType, KeyComparator>;
+
+ public:
+  // end iterator. comparator must outlive the iterator; stopKey is copied, nullptr means no bound
+  InMemoryIndexIterator(const KeyComparator *comparator, const KeyType *stopKey, bool reverse);
+
+  bool isEnd() const;
+
+  const MappingType &operator*();
+
+  InMemoryIndexIterator &operator++();
+
+  // same as IndexIterator::NextBatch
+  int NextBatch(std::vector<MappingType> *out, int max);
+
+  bool operator==(const InMemoryIndexIterator &itr) const;
+
+  bool operator!=(const InMemoryIndexIterator &itr) const;
+
+ private:
+  // positioning, used by the tree: first entry of leaf / first entry >= key / last entry / last entry <= key
+  // (< key if not inclusive). The position moves on to the neighbours if the leaf has no such entry.
+  void SeekFirst(LeafNode *leaf);
+  void SeekLowerBound(LeafNode *leaf, const KeyType &key);
+  void SeekLast(LeafNode *leaf);
+  void SeekReverse(LeafNode *leaf, const KeyType &key, bool inclusive);
+
+  // copy a consistent image of leaf into entries/prev/next
+  static void Snapshot(LeafNode *leaf, std::vector<MappingType> *entries, LeafNode **prev, LeafNode **next);
+  void Load(LeafNode *leaf);
+  //当前位置越过了拷贝的边界，移动到相邻的leaf，并检查stop key
+  void Settle();
+  // load the left neighbour of leaf, following next pointers if it was split after prev was read
+  void MoveToPrev();
+  // number of entries of the snapshot with key < key (<= key if inclusive)
+  int CountBelow(const KeyType &key, bool inclusive) const;
+
+  const KeyComparator *comparator;
+  //当前leaf和它的拷贝，leaf为nullptr表示迭代结束
+  LeafNode *leaf;
+  std::vector<MappingType> entries;
+  LeafNode *prev;
+  LeafNode *next;
+  int curIndex;
+
+  KeyType stopKey;
+  bool hasStopKey;
+  bool reverse;
+};
+
+}  // namespace bustub
@@ -18,6 +18,7 @@
 #include <vector>
 
 #include "catalog/schema.h"
+#include "storage/index/index_stats.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -37,12 +38,20 @@ class IndexMetadata {
   IndexMetadata() = delete;
 
   IndexMetadata(std::string index_name, std::string table_name, const Schema *tuple_schema,
-                std::vector<uint32_t> key_attrs)
-      : name_(std::move(index_name)), table_name_(std::move(table_name)), key_attrs_(std::move(key_attrs)) {
+                std::vector<uint32_t> key_attrs, bool is_unique = true, std::vector<uint32_t> included_attrs = {})
+      : name_(std::move(index_name)),
+        table_name_(std::move(table_name)),
+        key_attrs_(std::move(key_attrs)),
+        is_unique_(is_unique),
+        included_attrs_(std::move(included_attrs)) {
     key_schema_ = Schema::CopySchema(tuple_schema, key_attrs_);
+    included_schema_ = included_attrs_.empty() ? nullptr : Schema::CopySchema(tuple_schema, included_attrs_);
   }
 
-  ~IndexMetadata() { delete key_schema_; }
+  ~IndexMetadata() {
+    delete key_schema_;
+    delete included_schema_;
+  }
 
   inline const std::string &GetName() const { return name_; }
 
@@ -60,6 +69,15 @@ class IndexMetadata {
   //  columns
   inline const std::vector<uint32_t> &GetKeyAttrs() const { return key_attrs_; }
 
+  // Whether two entries may share the same key (false for secondary indexes)
+  inline bool IsUnique() const { return is_unique_; }
+
+  // Non-key columns stored in the index next to the RID (covering index), empty if there are none
+  inline const std::vector<uint32_t> &GetIncludedAttrs() const { return included_attrs_; }
+
+  // Schema of the included columns, nullptr if there are none
+  inline Schema *GetIncludedSchema() const { return included_schema_; }
+
   // Get a string representation for debugging
   std::string ToString() const {
     std::stringstream os;
@@ -78,8 +96,13 @@ class IndexMetadata {
   std::string table_name_;
   // The mapping relation between key schema and tuple schema
   const std::vector<uint32_t> key_attrs_;
+  bool is_unique_;
+  // The mapping relation between included columns and tuple schema
+  const std::vector<uint32_t> included_attrs_;
   // schema of the indexed key
   Schema *key_schema_;
+  // schema of the included columns
+  Schema *included_schema_;
 };
 
 /////////////////////////////////////////////////////////////////////
@@ -117,6 +140,13 @@ class Index {
 
   const std::vector<uint32_t> &GetKeyAttrs() const { return metadata_->GetKeyAttrs(); }
 
+  Schema *GetIncludedSchema() const { return metadata_->GetIncludedSchema(); }
+
+  const std::vector<uint32_t> &GetIncludedAttrs() const { return metadata_->GetIncludedAttrs(); }
+
+  // Whether lookups can return the included columns without reading the table
+  bool IsCovering() const { return metadata_->GetIncludedSchema() != nullptr; }
+
   // Get a string representation for debugging
   std::string ToString() const {
     std::stringstream os;
@@ -137,6 +167,35 @@ class Index {
 
   virtual void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) = 0;
 
+  // Covering indexes: insert with the included columns (a tuple of GetIncludedSchema()) stored next to the RID.
+  // Other indexes ignore them.
+  virtual void InsertEntry(const Tuple &key, const Tuple &included, RID rid, Transaction *transaction) {
+    InsertEntry(key, rid, transaction);
+  }
+
+  // Covering indexes: index-only lookup, (*included)[i] holds the included columns of (*result)[i].
+  // Other indexes leave included empty.
+  virtual void ScanKey(const Tuple &key, std::vector<RID> *result, std::vector<Tuple> *included,
+                       Transaction *transaction) {
+    ScanKey(key, result, transaction);
+  }
+
+  // Point queries for many keys, (*results)[i] holds the RIDs of keys[i]. Indexes that can overlap the probes
+  // (hash indexes) override it.
+  virtual void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                        Transaction *transaction) {
+    results->assign(keys.size(), std::vector<RID>());
+    for (size_t i = 0; i < keys.size(); i++) {
+      ScanKey(keys[i], &(*results)[i], transaction);
+    }
+  }
+
+  ///////////////////////////////////////////////////////////////////
+  // Statistics
+  ///////////////////////////////////////////////////////////////////
+  // fill stats from the index pages, reading every leaf_sample_rate-th leaf; indexes without statistics leave it empty
+  virtual void CollectStats(IndexStats *stats, size_t num_buckets, int leaf_sample_rate) { *stats = IndexStats(); }
+
  private:
   //===--------------------------------------------------------------------===//
   //  Data members
@@ -11,9 +11,12 @@
 /**
  * index_iterator.h
  * For range scan of b+ tree
- * 迭代器的功能就是顺序遍历一颗B+Tree的叶子节点，因为叶子节点是单向数组链表。
+ * 迭代器的功能就是顺序遍历一颗B+Tree的叶子节点，因为叶子节点是双向数组链表。
+ * 可以带一个stop key提前结束：正向遍历到 key >= stopKey 结束，反向遍历到 key < stopKey 结束。
  */
 #pragma once
+#include <vector>
+
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 namespace bustub {
@@ -27,14 +30,24 @@ class IndexIterator {
   // you may define your own constructor based on your member variables
 //  IndexIterator();
   IndexIterator(BufferPoolManager *b,LeafPage *leafNode,int index);
+  // comparator must outlive the iterator; stopKey is copied, nullptr means no bound
+  IndexIterator(BufferPoolManager *b, LeafPage *leafNode, int index, const KeyComparator *comparator,
+                const KeyType *stopKey, bool reverse);
   ~IndexIterator();
 
-  bool isEnd();
+  bool isEnd() const;
 
   const MappingType &operator*();
 
   IndexIterator &operator++();
 
+  /**
+   * Copy up to max entries from the current position into out (cleared first), a whole run of a leaf at a time,
+   * and advance past them. Honors the stop key and the direction.
+   * @return number of entries copied, 0 once the iterator is at its end
+   */
+  int NextBatch(std::vector<MappingType> *out, int max);
+
   bool operator==(const IndexIterator &itr) const;
 
   bool operator!=(const IndexIterator &itr) const;
@@ -47,6 +60,17 @@ class IndexIterator {
   //因为B+Tree的leafNode是一个leafNode的链表，
   // 所以需要在当前leafPage遍历结束之后，通过bufferPool拉取下一页
   BufferPoolManager *bufferPoolManager;
+
+  const KeyComparator *comparator;
+  KeyType stopKey;
+  bool hasStopKey;
+  //反向遍历，沿着leaf的左兄弟指针移动
+  bool reverse;
+
+  // true if the scan is past the stop key, so the next/prev leaf need not be fetched
+  bool PastStopKey(int index) const;
+  //当前位置越过了本页的边界，移动到相邻的leaf
+  void MoveToSibling();
 };
 
 }  // namespace bustub
@@ -0,0 +1,64 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_stats.h
+//
+// Identification: src/include/storage/index/index_stats.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * Statistics of an index, collected by walking (or sampling) its pages. They
+ * are used for capacity planning and for choosing between an index scan and a
+ * sequential scan.
+ *
+ * The key histogram is equi-depth: every bucket holds about the same number of
+ * entries, bucket i covers the keys in (bucket_bounds_[i - 1], bucket_bounds_[i]].
+ * Bounds hold the first column of the key.
+ *
+ * When only every leaf_sample_rate_-th leaf was read, entry and distinct-key
+ * counts are extrapolated from the sampled leaves.
+ *
+ * The bloom filter counters cover the point lookups since the filter was
+ * enabled; they stay 0 without a filter.
+ */
+struct IndexStats {
+  uint32_t height_{0};
+  uint32_t internal_page_count_{0};
+  uint32_t leaf_page_count_{0};
+  uint64_t num_entries_{0};
+  uint64_t distinct_keys_{0};
+  // average size / max size of the pages
+  double internal_fill_{0};
+  double leaf_fill_{0};
+  std::vector<Value> bucket_bounds_;
+  std::vector<uint64_t> bucket_counts_;
+  int leaf_sample_rate_{1};
+  uint64_t bloom_filter_bytes_{0};
+  // lookups of missing keys answered by the filter alone / let through by it
+  uint64_t bloom_negatives_{0};
+  uint64_t bloom_false_positives_{0};
+
+  uint32_t GetPageCount() const { return internal_page_count_ + leaf_page_count_; }
+
+  // estimated fraction of the entries equal to a given key, assuming keys are equally frequent
+  double EqualitySelectivity() const { return distinct_keys_ == 0 ? 0 : 1.0 / static_cast<double>(distinct_keys_); }
+
+  // observed fraction of the lookups of missing keys that the filter did not reject
+  double BloomFalsePositiveRate() const {
+    uint64_t misses = bloom_negatives_ + bloom_false_positives_;
+    return misses == 0 ? 0 : static_cast<double>(bloom_false_positives_) / static_cast<double>(misses);
+  }
+};
+
+}  // namespace bustub
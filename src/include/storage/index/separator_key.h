@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// separator_key.h
+//
+// Identification: src/include/storage/index/separator_key.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+#include "common/rid.h"
+
+namespace bustub {
+
+/**
+ * Key of the internal pages of a BPlusTree: the key and the RID of the first
+ * pair of the child it separates.
+ *
+ * With duplicate keys the leaves are ordered by (key, RID), and so are the
+ * separators. A run of equal keys spanning many leaves then still has one
+ * child per (key, RID), an exact delete descends straight to the leaf of its
+ * pair, and a lookup of all the pairs of a key descends with First(key).
+ * Trees with unique keys compare the keys only, the RID is carried along.
+ */
+template <typename KeyType>
+class SeparatorKey {
+ public:
+  SeparatorKey() = default;
+  SeparatorKey(const KeyType &key, const RID &rid) : key_(key), rid_(rid) {}
+
+  // below every (key, rid) pair of key
+  static SeparatorKey First(const KeyType &key) { return SeparatorKey(key, RID(INT64_MIN)); }
+
+  friend std::ostream &operator<<(std::ostream &os, const SeparatorKey &separator) {
+    os << separator.key_;
+    return os;
+  }
+
+  // key_ must stay the first member, the SIMD search of integer keys reads it at offset 0
+  KeyType key_{};
+  RID rid_;
+};
+
+/**
+ * Compares separators by key, then by RID if compare_rids (keys are not unique).
+ */
+template <typename KeyType, typename KeyComparator>
+class SeparatorComparator {
+ public:
+  SeparatorComparator(const KeyComparator &comparator, bool compare_rids)
+      : comparator_(comparator), compare_rids_(compare_rids) {}
+
+  inline int operator()(const SeparatorKey<KeyType> &lhs, const SeparatorKey<KeyType> &rhs) const {
+    int cmp = comparator_(lhs.key_, rhs.key_);
+    if (cmp != 0 || !compare_rids_) {
+      return cmp;
+    }
+    return CompareRids(lhs.rid_, rhs.rid_);
+  }
+
+  // RIDs in (page id, slot) order
+  static inline int CompareRids(const RID &lhs, const RID &rhs) {
+    int64_t lhs_value = lhs.Get();
+    int64_t rhs_value = rhs.Get();
+    return lhs_value < rhs_value ? -1 : (lhs_value > rhs_value ? 1 : 0);
+  }
+
+  const KeyComparator &GetKeyComparator() const { return comparator_; }
+  bool ComparesRids() const { return compare_rids_; }
+
+ private:
+  KeyComparator comparator_;
+  bool compare_rids_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,142 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// shadow_page_manager.h
+//
+// Identification: src/include/storage/index/shadow_page_manager.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * Page versions behind the snapshots of a BPlusTree (shadow paging).
+ *
+ * Time is cut into epochs, TakeSnapshot closes the current one: snapshot e
+ * sees every write of the epochs <= e. The first time a writer changes a page
+ * in an epoch while snapshots are open, the page as it is (its before-image)
+ * is copied to a new page of the buffer pool, the shadow, tagged with the
+ * epoch. Snapshot e then reads a page from its first shadow taken after e, or
+ * from the page itself if it did not change since. Shadows are never written
+ * again.
+ *
+ * Epoch based reclamation: a shadow of epoch c only serves snapshots < c, so
+ * it is deleted once the oldest open snapshot is >= c. Pages the tree drops
+ * wait in the same list, a reader of an older snapshot may still hold them.
+ *
+ * One writer and any number of snapshot readers, on any threads. The writer
+ * write latches a page only while it publishes the shadow, before changing
+ * the page; readers read latch a live page only for the time of the copy, so
+ * neither waits for an operation of the other. A reader always copies the
+ * page it reads and keeps no pin.
+ */
+class ShadowPageManager {
+ public:
+  explicit ShadowPageManager(BufferPoolManager *buffer_pool_manager);
+
+  // Deletes the shadows and the dropped pages left, no snapshot may be open any more.
+  ~ShadowPageManager();
+
+  DISALLOW_COPY_AND_MOVE(ShadowPageManager);
+
+  /*
+   * Writer side. A write operation runs between BeginWrite and EndWrite,
+   * snapshots are only taken between two operations.
+   */
+  void BeginWrite() { write_latch_.lock(); }
+  void EndWrite();
+
+  // Call before changing page_id: keeps its before-image if an open snapshot still reads it.
+  void BeforeWrite(page_id_t page_id);
+
+  // Call instead of BufferPoolManager::DeletePage for a page the writer unpinned and unlinked from the tree.
+  void DropPage(page_id_t page_id);
+
+  bool HasSnapshots() const { return num_snapshots_.load() > 0; }
+
+  /*
+   * Snapshots. TakeSnapshot must be called between BeginWrite and EndWrite, so
+   * that no operation is half done; root is the root page id of the tree at
+   * that moment.
+   */
+  uint64_t TakeSnapshot(page_id_t root);
+  void ReleaseSnapshot(uint64_t snapshot);
+  page_id_t GetRootPageId(uint64_t snapshot);
+
+  // Copy page page_id as snapshot sees it into out, PAGE_SIZE bytes.
+  void ReadPage(uint64_t snapshot, page_id_t page_id, char *out);
+
+  // number of shadows alive
+  size_t GetShadowCount();
+
+ private:
+  // page to read for page_id in snapshot, page_id itself if it did not change; latch_ held
+  page_id_t Resolve(uint64_t snapshot, page_id_t page_id) const;
+  // delete what no open snapshot can reach any more; latch_ held
+  void Reclaim();
+
+  struct Retired {
+    uint64_t epoch_;
+    page_id_t page_id_;
+    // true: the oldest shadow of page_id, false: page_id itself, dropped by the tree
+    bool shadow_;
+  };
+
+  BufferPoolManager *buffer_pool_manager_;
+  // held by the writer for a whole operation
+  std::mutex write_latch_;
+  // pages already passed to BeforeWrite in the current operation, writer only
+  std::unordered_set<page_id_t> shadowed_;
+
+  // protects everything below
+  std::mutex latch_;
+  // the epoch of the writes, snapshot ids are the epochs they close
+  uint64_t epoch_{1};
+  // open snapshot -> root page id
+  std::map<uint64_t, page_id_t> snapshots_;
+  std::atomic<size_t> num_snapshots_{0};
+  // page -> (epoch, shadow page id) by epoch
+  std::unordered_map<page_id_t, std::deque<std::pair<uint64_t, page_id_t>>> versions_;
+  // in epoch order
+  std::deque<Retired> retired_;
+};
+
+/**
+ * Scope of a write operation on a tree with shadow paging; does nothing if
+ * manager is nullptr.
+ */
+class ShadowWriteGuard {
+ public:
+  explicit ShadowWriteGuard(ShadowPageManager *manager) : manager_(manager) {
+    if (manager_ != nullptr) {
+      manager_->BeginWrite();
+    }
+  }
+  ~ShadowWriteGuard() {
+    if (manager_ != nullptr) {
+      manager_->EndWrite();
+    }
+  }
+  DISALLOW_COPY_AND_MOVE(ShadowWriteGuard);
+
+ private:
+  ShadowPageManager *manager_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// snapshot_index_iterator.h
+//
+// Identification: src/include/storage/index/snapshot_index_iterator.h
+//
+//===----------------------------------------------------------------------===//
+/**
+ * Range scan over a snapshot of a BPlusTree (see ShadowPageManager). Each
+ * leaf is copied as the snapshot sees it, so the scan keeps no pin and the
+ * tree goes on taking writes; the scan still returns the entries of the
+ * snapshot. Forward only, with an optional stop key: the scan ends at the
+ * first key >= stopKey.
+ */
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "storage/index/shadow_page_manager.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+
+namespace bustub {
+
+#define SNAPSHOT_INDEXITERATOR_TYPE SnapshotIndexIterator<KeyType, ValueType, KeyComparator>
+
+INDEX_TEMPLATE_ARGUMENTS
+class SnapshotIndexIterator {
+  using LeafPage = B_PLUS_TREE_LEAF_PAGE_TYPE;
+
+ public:
+  // leaf: copy of the first leaf (PAGE_SIZE bytes), nullptr for an empty scan; comparator must outlive the iterator,
+  // stopKey is copied, nullptr means no bound
+  SnapshotIndexIterator(ShadowPageManager *shadow, uint64_t snapshot, std::unique_ptr<char[]> leaf, int index,
+                        const KeyComparator *comparator, const KeyType *stopKey);
+
+  bool isEnd() const;
+
+  const MappingType &operator*();
+
+  SnapshotIndexIterator &operator++();
+
+  // Copy up to max entries into out (cleared first) and advance past them, like IndexIterator::NextBatch.
+  int NextBatch(std::vector<MappingType> *out, int max);
+
+ private:
+  // move on to the next leaf while the position is past the end of the current one, then apply the stop key
+  void Settle();
+
+  ShadowPageManager *shadow_;
+  uint64_t snapshot_;
+  //当前leaf的拷贝，nullptr表示遍历结束
+  std::unique_ptr<char[]> buffer_;
+  int index_;
+  const KeyComparator *comparator_;
+  KeyType stop_key_;
+  bool has_stop_key_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// varlen_b_plus_tree.h
+//
+// Identification: src/include/storage/index/varlen_b_plus_tree.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rid.h"
+#include "common/rwlatch.h"
+#include "storage/page/b_plus_tree_varlen_page.h"
+
+namespace bustub {
+
+/**
+ * B+ tree over variable-length byte string keys, built from BPlusTreeVarlenPage
+ * leaves (RID values) and internal pages (page id values). Leaves split by
+ * bytes and push a suffix-truncated separator, every page stores the prefix
+ * shared by its keys once, so long keys with common prefixes (VARCHAR columns)
+ * keep a high fan-out.
+ *
+ * A leaf entry is the key followed by the RID, so duplicate keys are ordered by
+ * RID and an exact delete finds its entry directly. Keys are compared in memcmp
+ * order and must be prefix-free: no key is a proper prefix of another one
+ * (VarlenBPlusTreeIndex::EncodeKey guarantees it).
+ *
+ * A single reader/writer latch protects the whole tree. Descents remember
+ * their path, so the parent pointers of the pages are not maintained. Removals
+ * do not merge pages, a leaf may become empty and is skipped by lookups.
+ */
+class VarlenBPlusTree {
+  using LeafPage = BPlusTreeVarlenPage<RID>;
+  using InternalPage = BPlusTreeVarlenPage<page_id_t>;
+
+ public:
+  // longest key accepted, the RID appended to it must still fit into a leaf entry
+  static constexpr size_t MAX_KEY_SIZE = LeafPage::MAX_KEY_SIZE - sizeof(int64_t);
+
+  VarlenBPlusTree(std::string name, BufferPoolManager *buffer_pool_manager);
+
+  bool IsEmpty() const { return root_page_id_ == INVALID_PAGE_ID; }
+
+  // with unique keys, Insert refuses a key that is already in the tree
+  void SetUniqueKeys(bool unique_keys) { unique_keys_ = unique_keys; }
+
+  /**
+   * Insert (key, rid), throws an Exception if the key is longer than MAX_KEY_SIZE.
+   * @return false if the keys are unique and key is already in the tree
+   */
+  bool Insert(std::string_view key, const RID &rid);
+
+  // @return false if (key, rid) is not in the tree
+  bool Remove(std::string_view key, const RID &rid);
+
+  // append the RIDs of key to result, in RID order
+  void GetValue(std::string_view key, std::vector<RID> *result);
+
+  // number of levels, 0 for an empty tree
+  int GetHeight();
+
+ private:
+  // key + RID, the RID big-endian so that equal keys sort by RID
+  static std::string EntryKey(std::string_view key, const RID &rid);
+
+  // ids of the pages from the root down to the leaf that key belongs to
+  void FindLeafPath(std::string_view key, std::vector<page_id_t> *path);
+  void GetValueLocked(std::string_view key, std::vector<RID> *result, bool first_only);
+  void StartNewTree(std::string_view entry_key, const RID &rid);
+  // insert separator -> right_page_id next to the child path[level] of path[level - 1]
+  void InsertIntoParent(const std::vector<page_id_t> &path, size_t level, const std::string &separator,
+                        page_id_t right_page_id);
+  Page *NewPage(page_id_t *page_id);
+  void UpdateRootPageId(bool insert_record);
+
+  std::string index_name_;
+  BufferPoolManager *buffer_pool_manager_;
+  page_id_t root_page_id_{INVALID_PAGE_ID};
+  bool unique_keys_{true};
+  ReaderWriterLatch latch_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// varlen_b_plus_tree_index.h
+//
+// Identification: src/include/storage/index/varlen_b_plus_tree_index.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "storage/index/index.h"
+#include "storage/index/varlen_b_plus_tree.h"
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+/**
+ * Key and comparator types that select a VarlenBPlusTreeIndex in
+ * Catalog::CreateIndex<VarlenKey, RID, VarlenComparator>. The keys are byte
+ * strings, there is no fixed key size.
+ */
+struct VarlenKey {};
+struct VarlenComparator {};
+
+/**
+ * B+ tree index with variable-length keys. Unlike GenericKey<N>, whose VARCHAR
+ * columns only hold an offset into the key tuple, the key columns are encoded
+ * into an order-preserving byte string of their actual length.
+ */
+class VarlenBPlusTreeIndex : public Index {
+ public:
+  VarlenBPlusTreeIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager);
+
+  void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+  /**
+   * Insert every tuple of a table into the (empty) index.
+   * If the index is unique and two tuples share a key, throws an Exception instead of keeping one of them.
+   */
+  void BuildFromTable(TableHeap *table_heap, const Schema &schema, Transaction *transaction);
+
+  /**
+   * Encode a key tuple so that memcmp order is the order of its values, column by column. Every column starts
+   * with a null marker; integers are big-endian with the sign bit flipped, VARCHARs have their 0 bytes escaped
+   * and end with two 0 bytes. No encoded key is a prefix of another one.
+   */
+  static std::string EncodeKey(const Tuple &key, const Schema &key_schema);
+
+  // see VarlenBPlusTree::GetHeight
+  int GetHeight() { return container_.GetHeight(); }
+
+ private:
+  VarlenBPlusTree container_;
+};
+
+}  // namespace bustub
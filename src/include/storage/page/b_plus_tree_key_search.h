@@ -0,0 +1,272 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/include/page/b_plus_tree_key_search.h
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#if defined(__AVX2__) || defined(__SSE4_2__)
+#include <immintrin.h>
+#endif
+
+#include "storage/index/generic_key.h"
+#include "storage/index/separator_key.h"
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+/**
+ * Search kernels shared by leaf and internal pages. Both page types keep their
+ * entries sorted in a MappingType array, so a lookup is a lower/upper bound
+ * over a sub range of that array.
+ *
+ * The primary template is the plain binary search through KeyComparator. It is
+ * specialized at compile time for integer keys (GenericKey<8> compared by
+ * GenericIntegerComparator<8>), where the last steps of the search are done
+ * with one SIMD compare over a small window instead of dependent branches.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class BPlusTreeKeySearch {
+ public:
+  /**
+   * @return the first index i in [left, right) such that array[i].first >= key, or right if there is none
+   */
+  static int LowerBound(const MappingType *array, int left, int right, const KeyType &key,
+                        const KeyComparator &comparator) {
+    int lo = left;
+    int hi = right - 1;
+    while (lo <= hi) {
+      int mid = (lo + hi) / 2;
+      if (comparator(array[mid].first, key) >= 0) {
+        //mid更大，目标在左侧
+        hi = mid - 1;
+      } else {
+        lo = mid + 1;
+      }
+    }
+    return hi + 1;
+  }
+
+  /**
+   * @return the first index i in [left, right) such that array[i].first > key, or right if there is none
+   */
+  static int UpperBound(const MappingType *array, int left, int right, const KeyType &key,
+                        const KeyComparator &comparator) {
+    int lo = left;
+    int hi = right - 1;
+    while (lo <= hi) {
+      int mid = (lo + hi) / 2;
+      if (comparator(array[mid].first, key) > 0) {
+        hi = mid - 1;
+      } else {
+        //即使相等也右移，最终lo停在第一个大于key的位置
+        lo = mid + 1;
+      }
+    }
+    return hi + 1;
+  }
+};
+
+/**
+ * Integer keys: binary search until at most SIMD_WINDOW entries are left, then
+ * count how many keys of the window are smaller than the search key. Because
+ * the window is sorted, that count is the offset of the bound inside it.
+ *
+ * Entries are interleaved (key + value), so the keys of the window are pulled
+ * out with a strided gather on AVX2, or two 64-bit lanes at a time on SSE4.2.
+ *
+ * With interpolation search on (GenericIntegerComparator::SetInterpolationSearch),
+ * the bound is first guessed from where the target falls between the first and
+ * the last key of the range, and a SIMD window around the guess is checked.
+ * On evenly spread keys the first guess almost always hits, two probes and one
+ * window instead of ~8 halvings. A miss still narrows the range to one side of
+ * the window; after MAX_INTERPOLATION_STEPS misses (skewed keys) the binary
+ * search takes over, so a bad node costs a few probes more than before.
+ */
+template <typename ValueType>
+class BPlusTreeKeySearch<GenericKey<8>, ValueType, GenericIntegerComparator<8>> {
+  using KeyType = GenericKey<8>;
+  using KeyComparator = GenericIntegerComparator<8>;
+
+ public:
+  static constexpr int SIMD_WINDOW = 16;
+  static constexpr int MAX_INTERPOLATION_STEPS = 2;
+
+  static int LowerBound(const MappingType *array, int left, int right, const KeyType &key,
+                        const KeyComparator &comparator) {
+    return Bound(array, left, right, KeyComparator::ToInteger(key), false, comparator.UseInterpolationSearch());
+  }
+
+  static int UpperBound(const MappingType *array, int left, int right, const KeyType &key,
+                        const KeyComparator &comparator) {
+    return Bound(array, left, right, KeyComparator::ToInteger(key), true, comparator.UseInterpolationSearch());
+  }
+
+  /**
+   * @param inclusive false counts keys < target (lower bound), true counts keys <= target (upper bound)
+   * @param interpolate try interpolation steps before the binary search
+   * Entry is any pair type holding the integer key in the first 8 bytes of .first
+   */
+  template <typename Entry>
+  static int Bound(const Entry *array, int left, int right, int64_t target, bool inclusive,
+                   bool interpolate = false) {
+    if (inclusive && target == INT64_MAX) {
+      // 所有key都<=INT64_MAX，同时避免下面target + 1溢出
+      return right;
+    }
+    if (interpolate && right - left > SIMD_WINDOW &&
+        Interpolate(array, &left, &right, inclusive ? target + 1 : target)) {
+      return left;
+    }
+    // 先用二分把范围缩小到一个窗口，窗口里剩下的比较交给SIMD一次做完
+    while (right - left > SIMD_WINDOW) {
+      int mid = left + (right - left) / 2;
+      int64_t mid_key = KeyAt(array, mid);
+      if (mid_key < target || (inclusive && mid_key == target)) {
+        left = mid + 1;
+      } else {
+        right = mid;
+      }
+    }
+    return left + CountBelow(array + left, right - left, inclusive ? target + 1 : target);
+  }
+
+  /**
+   * Interpolation steps over [*left, *right) for the first key >= bound.
+   * @return true with the answer in *left, or false with the range narrowed for the binary search
+   */
+  template <typename Entry>
+  static bool Interpolate(const Entry *array, int *left, int *right, int64_t bound) {
+    for (int step = 0; step < MAX_INTERPOLATION_STEPS && *right - *left > SIMD_WINDOW; step++) {
+      int64_t first = KeyAt(array, *left);
+      int64_t last = KeyAt(array, *right - 1);
+      if (first >= bound) {
+        return true;
+      }
+      if (last < bound) {
+        *left = *right;
+        return true;
+      }
+      // first < bound <= last，用double计算，避免key差值溢出
+      double fraction = (static_cast<double>(bound) - static_cast<double>(first)) /
+                        (static_cast<double>(last) - static_cast<double>(first));
+      int guess = *left + static_cast<int>(fraction * (*right - 1 - *left));
+      // 以猜测位置为中心的窗口[lo, hi)
+      int lo = std::max(*left + 1, guess - SIMD_WINDOW / 2);
+      int hi = std::min(*right - 1, lo + SIMD_WINDOW);
+      lo = std::max(*left + 1, hi - SIMD_WINDOW);
+      if (KeyAt(array, lo - 1) >= bound) {
+        //答案在窗口左边
+        *right = lo - 1;
+        continue;
+      }
+      if (KeyAt(array, hi) < bound) {
+        //答案在窗口右边
+        *left = hi + 1;
+        continue;
+      }
+      // key[lo - 1] < bound <= key[hi]，答案在[lo, hi]之内
+      *left = lo + CountBelow(array + lo, hi - lo, bound);
+      return true;
+    }
+    return false;
+  }
+
+  template <typename Entry>
+  static inline int64_t KeyAt(const Entry *array, int index) {
+    int64_t value;
+    memcpy(&value, &array[index].first, sizeof(int64_t));
+    return value;
+  }
+
+  /**
+   * @return the number of keys in items[0, size) that are < bound
+   */
+  template <typename Entry>
+  static int CountBelow(const Entry *items, int size, int64_t bound) {
+    int count = 0;
+    int i = 0;
+#if defined(__AVX2__)
+    constexpr int stride = static_cast<int>(sizeof(Entry));
+    const __m128i offsets = _mm_setr_epi32(0, stride, 2 * stride, 3 * stride);
+    const __m256i bounds = _mm256_set1_epi64x(bound);
+    for (; i + 4 <= size; i += 4) {
+      const auto *base = reinterpret_cast<const long long *>(&items[i]);  // NOLINT
+      __m256i keys = _mm256_i32gather_epi64(base, offsets, 1);
+      // bound > key 的lane全为1
+      __m256i less = _mm256_cmpgt_epi64(bounds, keys);
+      count += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(less)));
+    }
+#elif defined(__SSE4_2__)
+    const __m128i bounds = _mm_set1_epi64x(bound);
+    for (; i + 2 <= size; i += 2) {
+      __m128i keys = _mm_set_epi64x(KeyAt(items, i + 1), KeyAt(items, i));
+      __m128i less = _mm_cmpgt_epi64(bounds, keys);
+      count += __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(less)));
+    }
+#endif
+    for (; i < size; ++i) {
+      count += KeyAt(items, i) < bound ? 1 : 0;
+    }
+    return count;
+  }
+};
+
+/**
+ * Separators of integer keys (internal pages of a BPlusTree over integer
+ * keys): the integer search above finds the run of equal keys, and with
+ * duplicate keys a binary search on the RIDs finishes inside that run.
+ */
+template <typename ValueType>
+class BPlusTreeKeySearch<SeparatorKey<GenericKey<8>>, ValueType,
+                         SeparatorComparator<GenericKey<8>, GenericIntegerComparator<8>>> {
+  using KeyType = SeparatorKey<GenericKey<8>>;
+  using KeyComparator = SeparatorComparator<GenericKey<8>, GenericIntegerComparator<8>>;
+  using IntegerSearch = BPlusTreeKeySearch<GenericKey<8>, ValueType, GenericIntegerComparator<8>>;
+
+ public:
+  static int LowerBound(const MappingType *array, int left, int right, const KeyType &key,
+                        const KeyComparator &comparator) {
+    return Bound(array, left, right, key, comparator, false);
+  }
+
+  static int UpperBound(const MappingType *array, int left, int right, const KeyType &key,
+                        const KeyComparator &comparator) {
+    return Bound(array, left, right, key, comparator, true);
+  }
+
+ private:
+  static int Bound(const MappingType *array, int left, int right, const KeyType &key, const KeyComparator &comparator,
+                   bool inclusive) {
+    int64_t target = GenericIntegerComparator<8>::ToInteger(key.key_);
+    bool interpolate = comparator.GetKeyComparator().UseInterpolationSearch();
+    if (!comparator.ComparesRids()) {
+      return IntegerSearch::Bound(array, left, right, target, inclusive, interpolate);
+    }
+    //[lo, hi)是key相等的区间，区间内按RID二分
+    int lo = IntegerSearch::Bound(array, left, right, target, false, interpolate);
+    int hi = IntegerSearch::Bound(array, lo, right, target, true);
+    while (lo < hi) {
+      int mid = lo + (hi - lo) / 2;
+      int cmp = KeyComparator::CompareRids(array[mid].first.rid_, key.rid_);
+      if (cmp < 0 || (inclusive && cmp == 0)) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+};
+
+}  // namespace bustub
@@ -0,0 +1,137 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/include/page/b_plus_tree_varlen_page.h
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define B_PLUS_TREE_VARLEN_PAGE_TYPE BPlusTreeVarlenPage<ValueType>
+#define VARLEN_PAGE_HEADER_SIZE 32
+
+/**
+ * B+ tree page for variable-length keys. Keys are byte strings compared with
+ * memcmp order (binary-comparable encodings such as VARCHAR bytes), so a node
+ * only spends as many bytes on a key as the key actually has.
+ *
+ * Two compressions keep the fan-out high:
+ * (1) prefix compression: the longest prefix shared by all keys of the node is
+ *     stored once, every cell only keeps the remaining suffix.
+ * (2) suffix truncation: when a leaf splits, the separator pushed to the parent
+ *     is the shortest key that still separates the two halves
+ *     (see ShortestSeparator), not the whole first key of the right half.
+ *
+ * The same format serves leaf pages (ValueType = RID) and internal pages
+ * (ValueType = page_id_t). As in BPlusTreeInternalPage, the first key of an
+ * internal page is invalid; it is stored verbatim, outside the prefix, and is
+ * never compared. VarlenBPlusTree builds its trees from these pages.
+ *
+ * Page format:
+ *  ---------------------------------------------------------------------------
+ * | HEADER | PREFIX | SLOT(1) | SLOT(2) | ... | FREE SPACE | ... | CELL(2) | CELL(1) |
+ *  ---------------------------------------------------------------------------
+ *  Slot (4 bytes): | CellOffset (2) | SuffixLength (2) |
+ *  Cell: | KEY SUFFIX (SuffixLength) | VALUE (sizeof(ValueType)) |
+ *
+ *  Header format (size in byte, 32 bytes in total):
+ *  ---------------------------------------------------------------------
+ * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
+ *  ---------------------------------------------------------------------
+ *  ---------------------------------------------------------------------
+ * | ParentPageId (4) | PageId (4) | NextPageId (4) | FreeSpacePointer (2) | PrefixLength (2)
+ *  ---------------------------------------------------------------------
+ *
+ * Slots grow forward from the prefix, cells grow backward from the end of the
+ * page. MaxSize holds the byte capacity of the page.
+ */
+template <typename ValueType>
+class BPlusTreeVarlenPage : public BPlusTreePage {
+ public:
+  // longest key accepted, so that any page can always hold at least four entries
+  static constexpr size_t MAX_KEY_SIZE = (PAGE_SIZE - VARLEN_PAGE_HEADER_SIZE) / 4 - 2 * sizeof(ValueType) - 4;
+
+  // After creating a new page from buffer pool, must call initialize method to set default values
+  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID,
+            IndexPageType page_type = IndexPageType::LEAF_PAGE);
+
+  page_id_t GetNextPageId() const;
+  void SetNextPageId(page_id_t next_page_id);
+
+  // the prefix shared by every (valid) key of this page
+  std::string_view GetPrefix() const;
+
+  std::string KeyAt(int index) const;
+  ValueType ValueAt(int index) const;
+  void SetValueAt(int index, const ValueType &value);
+  int ValueIndex(const ValueType &value) const;
+
+  // first index i such that KeyAt(i) >= key (leaf page)
+  int KeyIndex(std::string_view key) const;
+  // leaf page: point lookup
+  bool Lookup(std::string_view key, ValueType *value) const;
+  // internal page: child pointer whose subtree contains key
+  ValueType LookupChild(std::string_view key) const;
+
+  /**
+   * Insert key & value ordered by key.
+   * @return false if the entry does not fit into this page (the caller must split first)
+   */
+  bool Insert(std::string_view key, const ValueType &value);
+  void PopulateNewRoot(const ValueType &old_value, std::string_view new_key, const ValueType &new_value);
+  void Remove(int index);
+
+  // bytes still available for new slots and cells, after compaction
+  size_t GetFreeSpace() const;
+
+  /**
+   * Split utility: move the upper half (by bytes) of the entries to "recipient".
+   * Both pages are rebuilt, so each gets the (usually longer) prefix of its own half.
+   * Sibling links and the parent pointers of moved children are left to the caller.
+   */
+  void MoveHalfTo(BPlusTreeVarlenPage *recipient);
+
+  /**
+   * Suffix truncation for separators: the shortest string s such that
+   * left_max < s <= right_min.
+   */
+  static std::string ShortestSeparator(std::string_view left_max, std::string_view right_min);
+
+ private:
+  using Entry = std::pair<std::string, ValueType>;
+
+  int FirstKeyIndex() const { return IsLeafPage() ? 0 : 1; }
+  char *SlotArray();
+  const char *SlotArray() const;
+  void GetSlot(int index, uint16_t *offset, uint16_t *length) const;
+  void SetSlot(int index, uint16_t offset, uint16_t length);
+  std::string_view SuffixAt(int index) const;
+
+  // lower/upper bound among the valid keys
+  int Bound(std::string_view key, bool upper) const;
+
+  std::vector<Entry> Decode() const;
+  static size_t CommonPrefixLength(const std::vector<Entry> &entries, int first);
+  static bool Fits(const std::vector<Entry> &entries, bool is_leaf);
+  // rewrite the whole page from entries, recomputing the common prefix
+  void Rebuild(const std::vector<Entry> &entries);
+
+  page_id_t next_page_id_;
+  uint16_t free_space_pointer_;
+  uint16_t prefix_length_;
+  char data_[0];
+};
+
+}  // namespace bustub
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 #include <utility>
 #include <vector>
 
@@ -32,13 +33,36 @@ namespace bustub {
  *
  *  Here '+' means concatenation.
  *
+ * Next to the occupied_/readable_ bitmaps, each slot has a tag byte: 0 if it
+ * was never occupied, TAG_TOMBSTONE once its pair was removed, and 0x80 plus
+ * the top 7 bits of the hash while it holds a pair. A probe compares the tags
+ * of 16 slots at once (one SSE2 compare) and only calls the comparator on the
+ * slots whose tag matches, about one in 128 of the other keys.
+ *
+ * Concurrency: the slots are cut into NUM_STRIPES stripes, each with a
+ * version word (a seqlock). Insert and Remove lock the stripe of their slot
+ * (odd version) for the time of the write, so writers of different stripes
+ * never wait for each other. ReadSlot takes no latch: it copies the slot and
+ * retries if the version of the stripe moved meanwhile. The tags are read
+ * without any synchronization, a match is only a hint that ReadSlot checks.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class HashTableBlockPage {
  public:
+  // slots MatchTag and MatchEmpty look at, starting at begin
+  static constexpr uint32_t GROUP_SIZE = 16;
+  static constexpr uint8_t TAG_EMPTY = 0x00;
+  static constexpr uint8_t TAG_TOMBSTONE = 0x01;
+  static constexpr uint32_t NUM_STRIPES = BLOCK_STRIPE_BYTES / sizeof(uint32_t);
+
   // Delete all constructor / destructor to ensure memory safety
   HashTableBlockPage() = delete;
 
+  /**
+   * @return the tag of a pair with this hash
+   */
+  static uint8_t HashTag(uint64_t hash) { return static_cast<uint8_t>(0x80 | (hash >> 57)); }
+
   /**
    * Gets the key at an index in the block.
    *
@@ -57,21 +81,21 @@ class HashTableBlockPage {
 
   /**
    * Attempts to insert a key and value into an index in the block.
-   * The insert is thread safe. It uses compare and swap to claim the index,
-   * and then writes the key and value into the index, and then marks the
-   * index as readable.
+   * The insert is thread safe. It locks the stripe of the index, and then
+   * writes the key, the value and the tag into the index, and then marks the
+   * index as occupied and readable.
    *
    * @param bucket_ind index to write the key and value to
    * @param key key to insert
    * @param value value to insert
+   * @param tag HashTag of the hash of key
    * @return If the value is inserted successfully, it returns true. If the
-   * index is marked as occupied before the key and value can be inserted,
-   * Insert returns false.
+   * index is readable (another writer got it first), Insert returns false.
    */
-  bool Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value);
+  bool Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value, uint8_t tag);
 
   /**
-   * Removes a key and value at index.
+   * Removes a key and value at index, thread safe like Insert.
    *
    * @param bucket_ind ind to remove the value
    */
@@ -93,11 +117,54 @@ class HashTableBlockPage {
    */
   bool IsReadable(slot_offset_t bucket_ind) const;
 
+  /**
+   * Copies the pair at an index without latching; the copy is consistent even while writers change the block.
+   *
+   * @param bucket_ind index to read
+   * @param[out] key key at the index
+   * @param[out] value value at the index
+   * @return false if the index does not hold a pair, key and value are then unchanged
+   */
+  bool ReadSlot(slot_offset_t bucket_ind, KeyType *key, ValueType *value) const;
+
+  /**
+   * Compares the tags of the GROUP_SIZE slots from begin (fewer at the end of the block) with tag.
+   *
+   * @param begin first index to look at
+   * @param tag tag to look for, a HashTag or TAG_TOMBSTONE
+   * @return bit i is set if index begin + i has this tag
+   */
+  uint32_t MatchTag(slot_offset_t begin, uint8_t tag) const;
+
+  /**
+   * @param begin first index to look at
+   * @return bit i is set if index begin + i was never occupied
+   */
+  uint32_t MatchEmpty(slot_offset_t begin) const { return MatchTag(begin, TAG_EMPTY); }
+
+  /**
+   * Starts loading the tags MatchTag reads from begin, and the pair at begin, into the cache.
+   */
+  void Prefetch(slot_offset_t begin) const {
+    __builtin_prefetch(&tags_[begin]);
+    __builtin_prefetch(&array_[begin]);
+  }
+
  private:
+  static uint32_t StripeOf(slot_offset_t bucket_ind) {
+    return static_cast<uint32_t>(bucket_ind / ((BLOCK_ARRAY_SIZE - 1) / NUM_STRIPES + 1));
+  }
+  void LockStripe(uint32_t stripe);
+  void UnlockStripe(uint32_t stripe);
+
+  // one seqlock per stripe of slots, odd while a writer holds it
+  std::atomic<uint32_t> stripes_[NUM_STRIPES];
   std::atomic_char occupied_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
 
   // 0 if tombstone/brand new (never occupied), 1 otherwise.
   std::atomic_char readable_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
+  // one per slot, see HashTag; written under the stripe lock
+  uint8_t tags_[BLOCK_ARRAY_SIZE];
   MappingType array_[0];
 };
 
@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_bucket_page.h
+//
+// Identification: src/include/storage/page/hash_table_bucket_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/index/int_comparator.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+/**
+ * Bucket page of an extendible hash table: an unordered array of key/value
+ * pairs. Supports non-unique keys, but not the same pair twice.
+ *
+ * Bucket page format:
+ *  ----------------------------------------------------------------------------
+ * | OCCUPIED BITMAP | READABLE BITMAP | KEY(1) + VALUE(1) | ... | KEY(n) + VALUE(n)
+ *  ----------------------------------------------------------------------------
+ *
+ * A slot is occupied once it was ever used, readable while it holds a pair.
+ * Slots are used from the front, so a scan stops at the first slot never
+ * occupied. Not thread safe, the caller latches the page.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class HashTableBucketPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  HashTableBucketPage() = delete;
+
+  /**
+   * Appends the values stored under key to result.
+   * @return true if at least one value was found
+   */
+  bool GetValue(const KeyType &key, KeyComparator cmp, std::vector<ValueType> *result) const;
+
+  /**
+   * Inserts the pair into the first free slot.
+   * @return false if the bucket is full or already holds the pair
+   */
+  bool Insert(const KeyType &key, const ValueType &value, KeyComparator cmp);
+
+  /**
+   * Removes the pair.
+   * @return false if the bucket does not hold it
+   */
+  bool Remove(const KeyType &key, const ValueType &value, KeyComparator cmp);
+
+  KeyType KeyAt(uint32_t bucket_idx) const;
+
+  ValueType ValueAt(uint32_t bucket_idx) const;
+
+  void RemoveAt(uint32_t bucket_idx);
+
+  bool IsOccupied(uint32_t bucket_idx) const;
+
+  bool IsReadable(uint32_t bucket_idx) const;
+
+  /**
+   * @return true if the pair is in the bucket
+   */
+  bool Contains(const KeyType &key, const ValueType &value, KeyComparator cmp) const;
+
+  bool IsFull() const;
+
+  bool IsEmpty() const;
+
+  // number of readable slots
+  uint32_t NumReadable() const;
+
+ private:
+  void SetOccupied(uint32_t bucket_idx);
+  void SetReadable(uint32_t bucket_idx);
+
+  char occupied_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
+  // 0 if tombstone/brand new (never occupied), 1 otherwise.
+  char readable_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
+  MappingType array_[0];
+};
+
+}  // namespace bustub
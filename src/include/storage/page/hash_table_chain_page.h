@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_chain_page.h
+//
+// Identification: src/include/storage/page/hash_table_chain_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/index/int_comparator.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+/**
+ * One page of a bucket chain of a chained hash table.
+ *
+ * Chain page format:
+ *  ----------------------------------------------------------------------------
+ * | NEXT PAGE ID (4) | COUNT (4) | KEY(1) + VALUE(1) | ... | KEY(COUNT) + VALUE(COUNT) | (free)
+ *  ----------------------------------------------------------------------------
+ *
+ * The pairs are dense: the first COUNT slots hold them, a remove moves the
+ * last pair into the hole. Does not look for duplicates, the table does. Not
+ * thread safe, the caller latches the head page of the chain.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class HashTableChainPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  HashTableChainPage() = delete;
+
+  // make a new page an empty end of chain
+  void Init();
+
+  page_id_t GetNextPageId() const { return next_page_id_; }
+
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  uint32_t GetCount() const { return count_; }
+
+  bool IsFull() const { return count_ == CHAIN_ARRAY_SIZE; }
+
+  const MappingType &PairAt(uint32_t index) const { return array_[index]; }
+
+  /**
+   * Appends the values stored under key to result.
+   * @return true if at least one value was found
+   */
+  bool GetValue(const KeyType &key, KeyComparator cmp, std::vector<ValueType> *result) const;
+
+  /**
+   * @return the index of the pair, -1 if the page does not hold it
+   */
+  int Find(const KeyType &key, const ValueType &value, KeyComparator cmp) const;
+
+  /**
+   * Appends the pair.
+   * @return false if the page is full
+   */
+  bool Append(const MappingType &pair);
+
+  // remove the pair at index, the last pair takes its place
+  void RemoveAt(uint32_t index);
+
+  // remove every pair, the next page id stays
+  void Clear() { count_ = 0; }
+
+ private:
+  page_id_t next_page_id_;
+  uint32_t count_;
+  MappingType array_[0];
+};
+
+}  // namespace bustub
@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_cuckoo_page.h
+//
+// Identification: src/include/storage/page/hash_table_cuckoo_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/index/int_comparator.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+/**
+ * Page of a cuckoo hash table: CUCKOO_BUCKET_ARRAY_SIZE buckets of
+ * CUCKOO_SLOTS key/value pairs each. A bucket never spans two pages, so a
+ * lookup reads one page per candidate bucket.
+ *
+ * Cuckoo page format:
+ *  ----------------------------------------------------------------------------
+ * | READABLE(1) | ... | READABLE(n) | BUCKET(1): CUCKOO_SLOTS x (KEY + VALUE) | ... | BUCKET(n)
+ *  ----------------------------------------------------------------------------
+ *
+ * Bit i of READABLE(b) is set while slot i of bucket b holds a pair. The page
+ * does not look for duplicates on insert, the table does. Not thread safe,
+ * the caller latches the page.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class HashTableCuckooPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  HashTableCuckooPage() = delete;
+
+  /**
+   * Appends the values stored under key in the bucket to result.
+   * @return true if at least one value was found
+   */
+  bool GetValue(uint32_t bucket, const KeyType &key, KeyComparator cmp, std::vector<ValueType> *result) const;
+
+  /**
+   * @return true if the bucket holds the pair
+   */
+  bool Contains(uint32_t bucket, const KeyType &key, const ValueType &value, KeyComparator cmp) const;
+
+  /**
+   * Inserts the pair into a free slot of the bucket.
+   * @return false if the bucket is full
+   */
+  bool Insert(uint32_t bucket, const MappingType &pair);
+
+  /**
+   * Removes the pair from the bucket.
+   * @return false if the bucket does not hold it
+   */
+  bool Remove(uint32_t bucket, const KeyType &key, const ValueType &value, KeyComparator cmp);
+
+  /**
+   * Puts pair into the slot, over the pair it may hold.
+   */
+  void SetAt(uint32_t bucket, uint32_t slot, const MappingType &pair);
+
+  bool IsReadable(uint32_t bucket, uint32_t slot) const;
+
+  const MappingType &PairAt(uint32_t bucket, uint32_t slot) const;
+
+  bool IsFull(uint32_t bucket) const;
+
+  // number of slots of the bucket holding key
+  uint32_t CountKey(uint32_t bucket, const KeyType &key, KeyComparator cmp) const;
+
+ private:
+  static constexpr uint8_t FULL_MASK = (1 << CUCKOO_SLOTS) - 1;
+
+  uint8_t readable_[CUCKOO_BUCKET_ARRAY_SIZE];
+  MappingType array_[0];
+};
+
+}  // namespace bustub
@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_directory_page.h
+//
+// Identification: src/include/storage/page/hash_table_directory_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+/**
+ * Directory Page for extendible hash table.
+ *
+ * Directory format (size in byte):
+ * --------------------------------------------------------------------------------------------
+ * | LSN (4) | PageId(4) | GlobalDepth(4) | LocalDepths(512) | BucketPageIds(2048) | Free(1524)
+ * --------------------------------------------------------------------------------------------
+ *
+ * Slot i of the directory holds the bucket of the hashes whose low
+ * GlobalDepth bits are i. A bucket of local depth d is shared by the
+ * 2^(GlobalDepth - d) slots that agree on the low d bits.
+ */
+class HashTableDirectoryPage {
+ public:
+  // largest global depth, DIRECTORY_ARRAY_SIZE slots
+  static constexpr uint32_t MAX_DEPTH = 9;
+
+  /**
+   * @return the page ID of this page
+   */
+  page_id_t GetPageId() const;
+
+  /**
+   * Sets the page ID of this page
+   *
+   * @param page_id the page id for the page id field to be set to
+   */
+  void SetPageId(page_id_t page_id);
+
+  /**
+   * @return the lsn of this page
+   */
+  lsn_t GetLSN() const;
+
+  /**
+   * Sets the LSN of this page
+   *
+   * @param lsn the log sequence number for the lsn field to be set to
+   */
+  void SetLSN(lsn_t lsn);
+
+  /**
+   * @return the global depth of the directory
+   */
+  uint32_t GetGlobalDepth() const;
+
+  /**
+   * @return the mask of the low GlobalDepth bits, applied to a hash it gives the directory slot
+   */
+  uint32_t GetGlobalDepthMask() const;
+
+  /**
+   * Doubles the directory: the new upper half is a copy of the lower half.
+   */
+  void IncrGlobalDepth();
+
+  /**
+   * Halves the directory, only valid if CanShrink().
+   */
+  void DecrGlobalDepth();
+
+  /**
+   * @return true if every local depth is below the global depth, the upper half is then a copy of the lower one
+   */
+  bool CanShrink() const;
+
+  /**
+   * @return the number of slots in use, 2^GlobalDepth
+   */
+  uint32_t Size() const;
+
+  page_id_t GetBucketPageId(uint32_t bucket_idx) const;
+
+  void SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id);
+
+  uint32_t GetLocalDepth(uint32_t bucket_idx) const;
+
+  void SetLocalDepth(uint32_t bucket_idx, uint32_t local_depth);
+
+  /**
+   * @return the slot of the other half of the bucket at bucket_idx: the one that differs in bit LocalDepth - 1
+   */
+  uint32_t GetSplitImageIndex(uint32_t bucket_idx) const;
+
+  /**
+   * Asserts that every bucket is referenced by exactly 2^(GlobalDepth - LocalDepth) slots, that all its slots
+   * agree on its local depth and that no local depth exceeds the global depth.
+   */
+  void VerifyIntegrity() const;
+
+ private:
+  lsn_t lsn_;
+  page_id_t page_id_;
+  uint32_t global_depth_;
+  uint8_t local_depths_[DIRECTORY_ARRAY_SIZE];
+  page_id_t bucket_page_ids_[DIRECTORY_ARRAY_SIZE];
+};
+
+}  // namespace bustub
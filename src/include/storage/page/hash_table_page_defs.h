@@ -16,9 +16,35 @@
 
 /** BLOCK_ARRAY_SIZE is the number of (key, value) pairs that can be stored in   * a block page. It is an approximate
  * calculation based on the size of MappingType (which is a std::pair of KeyType and ValueType). For each key/value
- * pair, we need two additional bits for occupied_ and readable_. 4 * PAGE_SIZE / (4 * sizeof (MappingType) + 1) =
- * PAGE_SIZE/(sizeof (MappingType) + 0.25) because 0.25 bytes = 2 bits is the space required to maintain the occupied
- * and readable flags for a key value pair.*/
-#define BLOCK_ARRAY_SIZE (4 * PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+ * pair, we need two additional bits for occupied_ and readable_ and one tag byte. 4 * PAGE_SIZE / (4 * sizeof
+ * (MappingType) + 5) = PAGE_SIZE/(sizeof (MappingType) + 1.25) because 1.25 bytes = 2 bits + 1 byte is the space
+ * required to maintain the occupied and readable flags and the tag of a key value pair. The page starts with
+ * BLOCK_STRIPE_BYTES of stripe versions.*/
+#define BLOCK_STRIPE_BYTES 64
+#define BLOCK_ARRAY_SIZE (4 * (PAGE_SIZE - BLOCK_STRIPE_BYTES) / (4 * sizeof(MappingType) + 5))
 
 #define HASH_TABLE_BLOCK_TYPE HashTableBlockPage<KeyType, ValueType, KeyComparator>
+
+/** BUCKET_ARRAY_SIZE is the number of (key, value) pairs of an extendible hash table bucket page: the same
+ * calculation as BLOCK_ARRAY_SIZE, without the tag byte and the stripes. */
+#define BUCKET_ARRAY_SIZE (4 * PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+
+/** DIRECTORY_ARRAY_SIZE is the number of bucket page ids of an extendible hash table directory page, the largest
+ * global depth is log2(DIRECTORY_ARRAY_SIZE). */
+#define DIRECTORY_ARRAY_SIZE 512
+
+#define HASH_TABLE_BUCKET_TYPE HashTableBucketPage<KeyType, ValueType, KeyComparator>
+
+/** CUCKOO_SLOTS is the number of (key, value) pairs of one cuckoo hash table bucket. CUCKOO_BUCKET_ARRAY_SIZE is the
+ * number of such buckets in a cuckoo page: each needs CUCKOO_SLOTS pairs and one byte of readable flags, and 8 bytes
+ * are left for the alignment of the pairs. */
+#define CUCKOO_SLOTS 4
+#define CUCKOO_BUCKET_ARRAY_SIZE ((PAGE_SIZE - 8) / (CUCKOO_SLOTS * sizeof(MappingType) + 1))
+
+#define HASH_TABLE_CUCKOO_TYPE HashTableCuckooPage<KeyType, ValueType, KeyComparator>
+
+/** CHAIN_ARRAY_SIZE is the number of (key, value) pairs of a chained hash table page, after its next page id and its
+ * fill counter. The pairs are kept dense, no per-pair flags are needed. */
+#define CHAIN_ARRAY_SIZE ((PAGE_SIZE - sizeof(page_id_t) - sizeof(uint32_t)) / sizeof(MappingType))
+
+#define HASH_TABLE_CHAIN_TYPE HashTableChainPage<KeyType, ValueType, KeyComparator>
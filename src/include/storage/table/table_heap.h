@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
@@ -108,6 +110,17 @@ class TableHeap {
   /** @return the id of the first page of this table */
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
+  /** @return the ids of all the pages of this table, in list order */
+  std::vector<page_id_t> GetPageIds();
+
+  /**
+   * Read all the tuples of one page, e.g. for scans that split the table into page ranges.
+   * @param page_id id of a page of this table
+   * @param[out] tuples the tuples of the page are appended here
+   * @param txn transaction performing the read
+   */
+  void GetPageTuples(page_id_t page_id, std::vector<Tuple> *tuples, Transaction *txn);
+
  private:
   BufferPoolManager *buffer_pool_manager_;
   LockManager *lock_manager_;
@@ -9,11 +9,16 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <memory>
+#include <numeric>
 #include <string>
+#include <utility>
 
 #include "common/exception.h"
 #include "common/rid.h"
 #include "storage/index/b_plus_tree.h"
+#include "storage/index/covering_value.h"
 #include "storage/page/header_page.h"
 
 namespace bustub {
@@ -25,10 +30,21 @@ BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manag
       buffer_pool_manager_(buffer_pool_manager),
       comparator_(comparator),
       leaf_max_size_(leaf_max_size),
-      internal_max_size_(internal_max_size) {
+      internal_max_size_(internal_max_size),
+      unique_keys_(true),
+      merge_threshold_(0.5),
+      pinned_levels_(0),
+      defer_root_updates_(false),
+      pending_root_update_(-1) {
           LOG_DEBUG("init B+Tree ok;  leafMaxSize:%d, internalMaxSize:%d",leaf_max_size_,internal_max_size_);
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TYPE::~BPlusTree() {
+  ReleasePinnedPages();
+  FlushRootPageId();
+}
+
 /*
  * Helper function to decide whether current b+tree is empty
  */
@@ -47,6 +63,42 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
   if (IsEmpty()){
     return false;
   }
+  //bloom filter说不存在就一定不存在，不用从根走到叶子
+  if (!BloomMayContain(key)) {
+    bloom_negatives_++;
+    return false;
+  }
+  bool check_filter = bloom_filter_ != nullptr;
+  if (!unique_keys_) {
+    //key可重复：从可能包含key的最左侧leaf开始，沿着叶子链表收集所有相等的key
+    bool found = false;
+    Page *page = FindLeafPage(key);
+    LeafPage *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    int index = leaf->KeyIndex(key, comparator_);
+    while (page != nullptr) {
+      if (index == leaf->GetSize()) {
+        page_id_t next_page_id = leaf->GetNextPageId();
+        buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+        page = next_page_id == INVALID_PAGE_ID ? nullptr : buffer_pool_manager_->FetchPage(next_page_id);
+        if (page != nullptr) {
+          leaf = reinterpret_cast<LeafPage *>(page->GetData());
+          index = 0;
+        }
+        continue;
+      }
+      if (comparator_(leaf->KeyAt(index), key) != 0) {
+        buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+        break;
+      }
+      result->push_back(leaf->GetItem(index).second);
+      found = true;
+      index++;
+    }
+    if (!found && check_filter) {
+      bloom_false_positives_++;
+    }
+    return found;
+  }
   //查询，从根节点出发，直到找到叶子结点。每次查找都是二分。
   Page *leaf_page = FindLeafPage(key);
   LeafPage *leaf_node = reinterpret_cast<LeafPage *>(leaf_page->GetData());
@@ -55,14 +107,94 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
 
   buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);//一页用完了就unpin掉，方便lru替换
 
-  result->resize(1);
-  (*result)[0] = value;
   if (!ok){    //树中无这个节点
+    if (check_filter) {
+      bloom_false_positives_++;
+    }
     return false;
   }
+  //只在命中时追加，调用者之前收集的结果保持不变
+  result->push_back(value);
   return true;
 }
 
+/*
+ * Batched point query. Keys are visited in sorted order, so a key usually
+ * lands in the same leaf (or at least the same inner nodes) as the one before
+ * it, and only the part of the path below the first differing node is
+ * descended again. Missing keys get an empty vector.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *result,
+                               Transaction *transaction) {
+  result->assign(keys.size(), std::vector<ValueType>());
+  if (IsEmpty()) {
+    return;
+  }
+  std::vector<size_t> order;
+  order.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    //被bloom filter排除的key直接得到空结果
+    if (BloomMayContain(keys[i])) {
+      order.push_back(i);
+    } else {
+      bloom_negatives_++;
+    }
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [&](size_t lhs, size_t rhs) { return comparator_(keys[lhs], keys[rhs]) < 0; });
+
+  std::vector<PathEntry> path;
+  for (size_t i : order) {
+    const KeyType &key = keys[i];
+    std::vector<ValueType> &values = (*result)[i];
+    Page *page = FindLeafPageOnPath(InternalKey::First(key), &path);
+    LeafPage *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    if (unique_keys_) {
+      ValueType value;
+      if (leaf->Lookup(key, &value, comparator_)) {
+        values.push_back(value);
+      }
+      continue;
+    }
+    //key可重复：在当前leaf收集相等的key，延续到后面的leaf时单独fetch，不影响缓存的路径
+    int index = leaf->KeyIndex(key, comparator_);
+    Page *scan_page = nullptr;
+    while (true) {
+      if (index == leaf->GetSize()) {
+        page_id_t next_page_id = leaf->GetNextPageId();
+        if (scan_page != nullptr) {
+          buffer_pool_manager_->UnpinPage(scan_page->GetPageId(), false);
+        }
+        if (next_page_id == INVALID_PAGE_ID) {
+          scan_page = nullptr;
+          break;
+        }
+        scan_page = buffer_pool_manager_->FetchPage(next_page_id);
+        leaf = reinterpret_cast<LeafPage *>(scan_page->GetData());
+        index = 0;
+        continue;
+      }
+      if (comparator_(leaf->KeyAt(index), key) != 0) {
+        break;
+      }
+      values.push_back(leaf->GetItem(index).second);
+      index++;
+    }
+    if (scan_page != nullptr) {
+      buffer_pool_manager_->UnpinPage(scan_page->GetPageId(), false);
+    }
+  }
+  ReleasePath(&path);
+  if (bloom_filter_ != nullptr) {
+    for (size_t i : order) {
+      if ((*result)[i].empty()) {
+        bloom_false_positives_++;
+      }
+    }
+  }
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -76,11 +208,13 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) {
   LOG_DEBUG("Insert");
+  ShadowWriteGuard guard(shadow_.get());
   //伪代码在<数据库系统概论>P279
   //1，树为空，建立一个新节点作为根节点。
   if (IsEmpty()){
     LOG_DEBUG("TREE IS EMPTY");
     StartNewTree(key,value);
+    BloomInsert(key);
     return true;
   }
   //2,向非空B+Tree插入KV
@@ -109,6 +243,96 @@ void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
   buffer_pool_manager_->UnpinPage(pageId, true);
 }
 
+/*
+ * Bulk loading: build the tree level by level from entries sorted by key.
+ * Each level is cut into the fewest nodes holding at most max size - 1
+ * entries (a full node would split on the next insert). The entries are
+ * spread evenly over these nodes, so that none of them is below its min size.
+ * The separator (first key and its RID) and the page id of every node become
+ * the entries of the level above, until a single node is left: the root.
+ * With unique keys, only the first pair of equal keys is kept. Otherwise equal
+ * keys are sorted by RID first, unless they already are.
+ * @return: false if the tree is not empty
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::BulkLoad(std::vector<MappingType> *entries, Transaction *transaction) {
+  ShadowWriteGuard guard(shadow_.get());
+  if (!IsEmpty()) {
+    return false;
+  }
+  if (unique_keys_) {
+    auto last = std::unique(entries->begin(), entries->end(), [&](const MappingType &lhs, const MappingType &rhs) {
+      return comparator_(lhs.first, rhs.first) == 0;
+    });
+    entries->erase(last, entries->end());
+  } else {
+    auto entry_less = [&](const MappingType &lhs, const MappingType &rhs) { return EntryLess(lhs, rhs); };
+    if (!std::is_sorted(entries->begin(), entries->end(), entry_less)) {
+      std::stable_sort(entries->begin(), entries->end(), entry_less);
+    }
+  }
+  if (entries->empty()) {
+    return true;
+  }
+
+  //1，叶子层，相邻的叶子互相链接；前一个叶子保持pin，等下一个叶子分配之后再设置next指针
+  std::vector<std::pair<InternalKey, page_id_t>> level;
+  int count = static_cast<int>(entries->size());
+  int nodes = (count + leaf_max_size_ - 2) / (leaf_max_size_ - 1);
+  int offset = 0;
+  Page *prev_page = nullptr;
+  for (int i = 0; i < nodes; i++) {
+    int size = count / nodes + (i < count % nodes ? 1 : 0);
+    page_id_t page_id;
+    Page *page = buffer_pool_manager_->NewPage(&page_id);
+    if (page == nullptr) {
+      throw ExceptionType::OUT_OF_MEMORY;
+    }
+    LeafPage *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    leaf->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+    leaf->CopyNFrom(entries->data() + offset, size);
+    if (prev_page != nullptr) {
+      leaf->SetPrevPageId(prev_page->GetPageId());
+      reinterpret_cast<LeafPage *>(prev_page->GetData())->SetNextPageId(page_id);
+      buffer_pool_manager_->UnpinPage(prev_page->GetPageId(), true);
+    }
+    level.emplace_back(SeparatorOf((*entries)[offset]), page_id);
+    offset += size;
+    prev_page = page;
+  }
+  buffer_pool_manager_->UnpinPage(prev_page->GetPageId(), true);
+
+  //2，逐层向上建internal节点，CopyNFrom会修改孩子的parent
+  while (level.size() > 1) {
+    std::vector<std::pair<InternalKey, page_id_t>> upper;
+    count = static_cast<int>(level.size());
+    nodes = (count + internal_max_size_ - 2) / (internal_max_size_ - 1);
+    offset = 0;
+    for (int i = 0; i < nodes; i++) {
+      int size = count / nodes + (i < count % nodes ? 1 : 0);
+      page_id_t page_id;
+      Page *page = buffer_pool_manager_->NewPage(&page_id);
+      if (page == nullptr) {
+        throw ExceptionType::OUT_OF_MEMORY;
+      }
+      InternalPage *internal = reinterpret_cast<InternalPage *>(page->GetData());
+      internal->Init(page_id, INVALID_PAGE_ID, internal_max_size_);
+      internal->CopyNFrom(level.data() + offset, size, buffer_pool_manager_);
+      upper.emplace_back(level[offset].first, page_id);
+      buffer_pool_manager_->UnpinPage(page_id, true);
+      offset += size;
+    }
+    level.swap(upper);
+  }
+
+  root_page_id_ = level[0].second;
+  UpdateRootPageId();
+  if (bloom_filter_ != nullptr) {
+    RebuildBloomFilter(std::max(bloom_capacity_, entries->size()));
+  }
+  return true;
+}
+
 /*
  * Insert constant key & value pair into leaf page
  * User needs to first find the right leaf page as insertion target, then look
@@ -120,13 +344,13 @@ void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction) {
   //向B+Tree插入一个KV到叶子节点
-  //1，找到待插入的leaf node；
-  Page *leafPage = FindLeafPage(key);
+  //1，找到待插入的leaf node；key可重复时按(key, RID)下降
+  Page *leafPage = FindLeafPage(InternalKey(key, IndexValue<ValueType>::GetRid(value)));
   LeafPage *leafNode = reinterpret_cast<LeafPage *>(leafPage->GetData());
 
-  //2,看看key是否重复
+  //2,看看key是否重复；允许重复key时不检查，调用者保证同一个(key, value)不会插入两次
   ValueType searchValue;
-  bool is_exit = leafNode->Lookup(key, &searchValue, comparator_);
+  bool is_exit = unique_keys_ && leafNode->Lookup(key, &searchValue, comparator_);
   if (is_exit){//已存在的key，不添加
     LOG_DEBUG("Key has exited");
     buffer_pool_manager_->UnpinPage(leafPage->GetPageId(), false);//记住，凡是fetch/new的page，用完都要unpin
@@ -135,6 +359,7 @@ bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value,
   LOG_DEBUG("Key not exit, begin insert");
 
   //插入key到leaf，如果满了就分裂。
+  ShadowPage(leafPage->GetPageId());
   leafNode->Insert(key, value, comparator_);
   LOG_DEBUG("insert over,curSize:%d, maxSize:%d",leafNode->GetSize(),leafNode->GetMaxSize());
 
@@ -146,14 +371,62 @@ bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value,
     //拆分后将键值对插入父节点这个内部页面
     //在leaf节点分裂之后，新的node需要在父节点中插入一个Key+Pointer的pair对，用于指示newNode。
     //而在父节点插入的这个Key-Pointer的key，应当是newNode中的下限(newNode.keys>=key)，oldNode中的上限(oldNode.keys<key)
-    //这个key就是newNode的第一个节点的key，array[0].first
-    InsertIntoParent(leafNode,newLeafNode->KeyAt(0),newLeafNode);
+    //这个key就是newNode的第一个节点的key，array[0].first，带上它的RID
+    InsertIntoParent(leafNode,SeparatorOf(newLeafNode->GetItem(0)),newLeafNode);
   }
 
   buffer_pool_manager_->UnpinPage(leafPage->GetPageId(), true);
+  BloomInsert(key);
   return true;
 }
 
+/*
+ * Batched insert. Entries are inserted in key order through the cached path
+ * of GetValues. An insert that fills the leaf would split it and change the
+ * inner nodes, so the path is released first and that entry takes the regular
+ * InsertIntoLeaf route.
+ * @return: number of inserted entries (duplicate keys are skipped when keys are unique)
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int BPLUSTREE_TYPE::InsertBatch(const std::vector<MappingType> &entries, Transaction *transaction) {
+  std::vector<MappingType> sorted(entries);
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [&](const MappingType &lhs, const MappingType &rhs) { return EntryLess(lhs, rhs); });
+
+  ShadowWriteGuard guard(shadow_.get());
+  int inserted = 0;
+  std::vector<PathEntry> path;
+  for (const auto &entry : sorted) {
+    if (IsEmpty()) {
+      StartNewTree(entry.first, entry.second);
+      BloomInsert(entry.first);
+      inserted++;
+      continue;
+    }
+    Page *page = FindLeafPageOnPath(SeparatorOf(entry), &path);
+    LeafPage *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    ValueType value;
+    if (unique_keys_ && leaf->Lookup(entry.first, &value, comparator_)) {
+      continue;
+    }
+    if (leaf->GetSize() + 1 < leaf->GetMaxSize()) {
+      //插入后不会分裂，直接写缓存路径上的leaf
+      ShadowPage(page->GetPageId());
+      leaf->Insert(entry.first, entry.second, comparator_);
+      path.back().dirty_ = true;
+      BloomInsert(entry.first);
+      inserted++;
+      continue;
+    }
+    ReleasePath(&path);
+    if (InsertIntoLeaf(entry.first, entry.second, transaction)) {
+      inserted++;
+    }
+  }
+  ReleasePath(&path);
+  return inserted;
+}
+
 /*
  * Split input page and return newly created page.
  * Using template N to represent either internal page or leaf page.
@@ -177,9 +450,17 @@ N *BPLUSTREE_TYPE::Split(N *node) {
     LeafPage *oldNode = reinterpret_cast<LeafPage *>(node);
     LeafPage *newNode = reinterpret_cast<LeafPage *>(new_node);
     oldNode->MoveHalfTo(newNode);
-    //设置叶子结点的前后连接指针,是一个单向链表
+    //设置叶子结点的前后连接指针,是一个双向链表
     newNode->SetNextPageId(oldNode->GetNextPageId());
+    newNode->SetPrevPageId(oldNode->GetPageId());
     oldNode->SetNextPageId(newNode->GetPageId());
+    if (newNode->GetNextPageId() != INVALID_PAGE_ID) {
+      //原来的右兄弟，左指针改为指向newNode
+      ShadowPage(newNode->GetNextPageId());
+      Page *nextPage = buffer_pool_manager_->FetchPage(newNode->GetNextPageId());
+      reinterpret_cast<LeafPage *>(nextPage->GetData())->SetPrevPageId(newPageId);
+      buffer_pool_manager_->UnpinPage(nextPage->GetPageId(), true);
+    }
     LOG_DEBUG("SplitOver; LeafNode,minSize:%d, maxSize:%d, oldNodeSize:%d,newNodeSize:%d,",newNode->GetMinSize(),newNode->GetMaxSize(),oldNode->GetSize(),newNode->GetSize());
     //把oldNode的类型转换为N，保存为new_node返回
     new_node = reinterpret_cast<N *>(newNode);
@@ -207,7 +488,7 @@ N *BPLUSTREE_TYPE::Split(N *node) {
  * recursively if necessary.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
+void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const InternalKey &key, BPlusTreePage *new_node,
                                       Transaction *transaction) {
   LOG_DEBUG("InsertIntoParent after split");
   //在leaf节点分裂之后，新的node需要在父节点中插入一个Key+Pointer的pair对，用于指示newNode。
@@ -256,6 +537,7 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
   //因为我们执行插入操作的时候，会拒绝已存在的key插入，所以根据本Tree的实现，只要是能执行到这里，必然key在tree中不存在过，而且不会在任何一个节点存在
   //不需要判断重复啦
   //因为是oldNode分裂出newNode，所以newNode在parent中的位置应该是oldNode.pageId之后。
+  ShadowPage(parentPageId);
   parentNode->InsertNodeAfter(old_node->GetPageId(), key, newNodeId);
   LOG_DEBUG("internal node insert over,curSize:%d, maxSize:%d",parentNode->GetSize(),parentNode->GetMaxSize());
 
@@ -283,18 +565,25 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
   LOG_DEBUG("REMOVE JOIN");
+  ShadowWriteGuard guard(shadow_.get());
   //1，判空
-  if (IsEmpty()){
+  if (IsEmpty() || !BloomMayContain(key)){
+    return;
+  }
+  if (!unique_keys_) {
+    //key可重复时，删除第一个匹配的pair
+    RemoveEntry(key, nullptr, transaction);
     return;
   }
   //2，查找key'所在的page
   Page *leafPage = FindLeafPage(key);
   LeafPage *leafNode = reinterpret_cast<LeafPage *>(leafPage->GetData());
   //3，查找key的index，删除key；单纯删除子节点的key，不需要调整父节点，除非子节点需要合并/重新分配
+  ShadowPage(leafPage->GetPageId());
   int size = leafNode->RemoveAndDeleteRecord(key, comparator_);
   //4，检查是否需要合并或者重新分配，
   bool node_del = false;//接住CoalesceOrRedistribute的返回结果，true表示该node在CoalesceOrRedistribute被删除！不需要在此unpin
-  if (size < leafNode->GetMinSize()){
+  if (size < MinSize(leafNode)){
     node_del = CoalesceOrRedistribute(leafNode,transaction);//will unpin leafNode
   }
   if (!node_del){
@@ -302,6 +591,84 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
   }
 }
 
+/*
+ * Delete the exact key & value pair. With duplicate keys the separators order
+ * the pairs by (key, RID), so the pair has a single leaf, however many leaves
+ * hold that key.
+ * @return : false if the pair does not exist
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::Remove(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  ShadowWriteGuard guard(shadow_.get());
+  if (IsEmpty() || !BloomMayContain(key)) {
+    return false;
+  }
+  return RemoveEntry(key, &value, transaction);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::RemoveEntry(const KeyType &key, const ValueType *value, Transaction *transaction) {
+  int index;
+  Page *leafPage = FindEntry(key, value, &index);
+  if (leafPage == nullptr) {
+    return false;
+  }
+  LeafPage *leafNode = reinterpret_cast<LeafPage *>(leafPage->GetData());
+  ShadowPage(leafPage->GetPageId());
+  int size = leafNode->RemoveAt(index);
+  //和Remove(key)一样，检查是否需要合并或者重新分配
+  bool node_del = false;
+  if (size < MinSize(leafNode)) {
+    node_del = CoalesceOrRedistribute(leafNode, transaction);
+  }
+  if (!node_del) {
+    buffer_pool_manager_->UnpinPage(leafPage->GetPageId(), true);
+  }
+  return true;
+}
+
+/*
+ * Find the first pair equal to key, or the pair equal to key and *value if
+ * value is not null: descend with (key, RID) to its leaf and binary search it.
+ * @return : the pinned leaf page holding it and its index in "index", or
+ * nullptr if there is no such pair
+ */
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FindEntry(const KeyType &key, const ValueType *value, int *index) {
+  if (value != nullptr) {
+    RID rid = IndexValue<ValueType>::GetRid(*value);
+    Page *page = FindLeafPage(InternalKey(key, rid));
+    LeafPage *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    int i = leaf->EntryIndex(key, rid, comparator_);
+    if (i < leaf->GetSize() && comparator_(leaf->KeyAt(i), key) == 0 && leaf->GetItem(i).second == *value) {
+      *index = i;
+      return page;
+    }
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    return nullptr;
+  }
+  Page *page = FindLeafPage(key);
+  LeafPage *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int i = leaf->KeyIndex(key, comparator_);
+  if (i == leaf->GetSize()) {
+    //key的第一个pair可能在下一个leaf的开头
+    page_id_t next_page_id = leaf->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    if (next_page_id == INVALID_PAGE_ID) {
+      return nullptr;
+    }
+    page = buffer_pool_manager_->FetchPage(next_page_id);
+    leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    i = 0;
+  }
+  if (i < leaf->GetSize() && comparator_(leaf->KeyAt(i), key) == 0) {
+    *index = i;
+    return page;
+  }
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  return nullptr;
+}
+
 /*
  * User needs to first find the sibling of input page. If sibling's size + input
  * page's size > page's max size, then redistribute. Otherwise, merge.
@@ -337,6 +704,10 @@ bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
   page_id_t parentId = node->GetParentPageId();
   Page *parentPage = buffer_pool_manager_->FetchPage(parentId);
   InternalPage *parentNode = reinterpret_cast<InternalPage *>(parentPage->GetData());
+  //合并和重组都会修改这三个节点
+  ShadowPage(node->GetPageId());
+  ShadowPage(node2->GetPageId());
+  ShadowPage(parentId);
 
   //3，然后按照兄弟PAGE和当前PAGE的位置关系，来做2个事情 合并/重组，标准是 兄弟的大小 + 输入页面的大小 < 页面的最大大小。
 //  4，第一个是当可以合并的时候，走Coalesce，让后面一个节点合并到前面一个节点。
@@ -408,8 +779,7 @@ bool BPlusTree<KeyType, ValueType, KeyComparator>::FindBro(N *node, N *&node2) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
-bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
-                              BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> **parent, int index,
+bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node, InternalPage **parent, int index,
                               Transaction *transaction) {
   LOG_DEBUG("Coalesce join");
   //合并的方法，就是把后面node，移到前面的node2。随后把全部移走的那个节点从PAGE TABLE里删了。
@@ -418,11 +788,18 @@ bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
     LeafPage *nd = reinterpret_cast<LeafPage *>(*node);
     LeafPage *broNd = reinterpret_cast<LeafPage *>(*neighbor_node);
     nd->MoveAllTo(broNd);
+    if (broNd->GetNextPageId() != INVALID_PAGE_ID) {
+      //nd被删除，它右兄弟的左指针改为指向broNd
+      ShadowPage(broNd->GetNextPageId());
+      Page *nextPage = buffer_pool_manager_->FetchPage(broNd->GetNextPageId());
+      reinterpret_cast<LeafPage *>(nextPage->GetData())->SetPrevPageId(broNd->GetPageId());
+      buffer_pool_manager_->UnpinPage(nextPage->GetPageId(), true);
+    }
     (*node) = reinterpret_cast<N *>(nd);
     (*neighbor_node) = reinterpret_cast<N *>(broNd);
   }else{
     //internal节点，合并之前需要使用父节点的key填充自己的invalidKey
-    KeyType middle_key = (*parent)->KeyAt(index);
+    InternalKey middle_key = (*parent)->KeyAt(index);
 
     InternalPage *nd = reinterpret_cast<InternalPage *>(*node);
     InternalPage *broNd = reinterpret_cast<InternalPage *>(*neighbor_node);
@@ -432,14 +809,15 @@ bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
   }
 
   page_id_t pageId = (*node)->GetPageId();
-  //删除被掏空的node
+  //删除被掏空的node，常驻的页面要先释放，否则DeletePage会失败
+  ReleasePinnedPage(pageId);
   buffer_pool_manager_->UnpinPage(pageId, true);
-  buffer_pool_manager_->DeletePage(pageId);
+  DeleteNode(pageId);
   buffer_pool_manager_->UnpinPage((*neighbor_node)->GetPageId(),true);
 
   //删除父节点node对应的KV
   (*parent)->Remove(index);
-  if ((*parent)->GetSize()<(*parent)->GetMinSize()){
+  if ((*parent)->GetSize()<MinSize(*parent)){
     return CoalesceOrRedistribute(*parent,transaction);
   }
   return false;//true 表示应该删除父节点，false 表示不删除
@@ -473,13 +851,13 @@ void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {
       //node在父节点中的index为0，那么neighbor_node一定是右兄弟，需要从右兄弟拿最左侧第一个元素到node中。
       //右兄弟首元素被移动到node之后，右兄弟所对应的indexInParent的key应该修改为右兄弟新的首元素,修改父节点以保证B+Tree规则。
       broNd->MoveFirstToEndOf(nd);
-      parent->SetKeyAt(1,broNd->KeyAt(0));//node为0，那么右兄弟为1
+      parent->SetKeyAt(1,SeparatorOf(broNd->GetItem(0)));//node为0，那么右兄弟为1
     }else{
       //neighbor_node是左兄弟，那node需要借来左兄弟最右侧的一个KV
       //左兄弟last元素被移动到node之后，node所对应的indexInParent的key应该修改为新插入元素的key；
       //此处node对应的index不可能为0，因为index=0的时候不存在左兄弟
       broNd->MoveLastToFrontOf(nd);
-      parent->SetKeyAt(index,nd->KeyAt(0));
+      parent->SetKeyAt(index,SeparatorOf(nd->GetItem(0)));
     }
 
     node = reinterpret_cast<N *>(nd);
@@ -512,6 +890,55 @@ void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {
   buffer_pool_manager_->UnpinPage(neighbor_node->GetPageId(), true);
 
 }
+/*
+ * Size below which a node is rebalanced on delete. The root keeps its own
+ * rule, other nodes use merge_threshold_ * max size; the default 0.5 gives
+ * exactly GetMinSize()
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int BPLUSTREE_TYPE::MinSize(const BPlusTreePage *node) const {
+  if (node->IsRootPage()) {
+    return node->GetMinSize();
+  }
+  //internal节点至少保留两个孩子，否则唯一的孩子下溢时找不到兄弟节点
+  int lower = node->IsLeafPage() ? 1 : std::min(2, node->GetMinSize());
+  return std::max(lower, static_cast<int>(merge_threshold_ * node->GetMaxSize()));
+}
+
+/*
+ * Compaction pass for a relaxed merge threshold: walk the leaf chain and run
+ * the regular CoalesceOrRedistribute on every leaf below GetMinSize().
+ * A merged leaf is always the right one of the pair, so the scan resumes from
+ * the leaf before the rebalanced one (or from it, if it is the first leaf).
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Compact(Transaction *transaction) {
+  ShadowWriteGuard guard(shadow_.get());
+  if (IsEmpty()) {
+    return;
+  }
+  //合并过程中（包括递归到父节点）都使用默认阈值
+  double merge_threshold = merge_threshold_;
+  merge_threshold_ = 0.5;
+  KeyType useless{};
+  Page *page = FindLeafPage(useless, true);
+  while (page != nullptr) {
+    LeafPage *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    if (!leaf->IsRootPage() && leaf->GetSize() < leaf->GetMinSize()) {
+      page_id_t resume = leaf->GetPrevPageId() == INVALID_PAGE_ID ? leaf->GetPageId() : leaf->GetPrevPageId();
+      if (!CoalesceOrRedistribute(leaf, transaction)) {
+        buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+      }
+      page = buffer_pool_manager_->FetchPage(resume);
+      continue;
+    }
+    page_id_t next_page_id = leaf->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = next_page_id == INVALID_PAGE_ID ? nullptr : buffer_pool_manager_->FetchPage(next_page_id);
+  }
+  merge_threshold_ = merge_threshold;
+}
+
 /*
  * Update root page if necessary
  * NOTE: size of root page can be less than min size and this method is only
@@ -534,7 +961,7 @@ bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) {
     //已经空了，直接删掉，树置空。
     assert(old_root_node->GetSize() == 0);
     buffer_pool_manager_->UnpinPage(old_root_node->GetPageId(), false);
-    buffer_pool_manager_->DeletePage(old_root_node->GetPageId());
+    DeleteNode(old_root_node->GetPageId());
     root_page_id_ = INVALID_PAGE_ID;
     UpdateRootPageId();
     return true;
@@ -551,7 +978,7 @@ bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) {
   UpdateRootPageId();
   buffer_pool_manager_->UnpinPage(old_root_node->GetPageId(), false);
   buffer_pool_manager_->UnpinPage(newRoot->GetPageId(), true);
-  buffer_pool_manager_->DeletePage(old_root_node->GetPageId());
+  DeleteNode(old_root_node->GetPageId());
   return true;
 }
 
@@ -567,7 +994,7 @@ INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::begin() {
   //返回指向第一个leaf节点的第一个元素的迭代器
   //1，找到leftMost的 leafPage
-  KeyType useless;
+  KeyType useless{};
   Page *leftLeaf = FindLeafPage(useless, true);
   LeafPage *leafNode = reinterpret_cast<LeafPage *>(leftLeaf->GetData());
   return INDEXITERATOR_TYPE(buffer_pool_manager_, leafNode, 0);
@@ -596,19 +1023,296 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::end() {
 //    构造一个索引迭代器，表示叶子节点中键值对的结束,结束的位置其实就是最右侧leafNode的最后一个元素之后。
-    //首先找到第一个leafNode，然后搜索leafNode链表达到最后一个leafNode
-    KeyType useless;
-    Page *curPage = FindLeafPage(useless, true);
+    //沿着每层最右侧的指针直接下降到最右侧的leafNode，不用遍历整个leaf链表
+    Page *curPage = FindRightMostLeafPage();
     LeafPage *curNode = reinterpret_cast<LeafPage *>(curPage->GetData());
-    while(curNode->GetNextPageId()!=INVALID_PAGE_ID){
-      buffer_pool_manager_->UnpinPage(curPage->GetPageId(), false);
-      curPage = buffer_pool_manager_->FetchPage(curNode->GetNextPageId());
-      curNode = reinterpret_cast<LeafPage *>(curPage->GetData());
-    }
-    //找到最右侧的leafPage
     return INDEXITERATOR_TYPE(buffer_pool_manager_,curNode,curNode->GetSize());
 }
 
+/*
+ * Bounded range scan over [lo, hi): the iterator ends by itself at the first
+ * key >= hi, without reading the leaves after it
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &lo, const KeyType &hi) {
+  Page *page = FindLeafPage(lo);
+  LeafPage *leafNode = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = leafNode->KeyIndex(lo, comparator_);
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, leafNode, index, &comparator_, &hi, false);
+}
+
+/*
+ * Reverse scan from the last key, ++ moves to the previous key following the
+ * left-sibling links of the leaves
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::RBegin() {
+  Page *page = FindRightMostLeafPage();
+  LeafPage *leafNode = reinterpret_cast<LeafPage *>(page->GetData());
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, leafNode, leafNode->GetSize() - 1, &comparator_, nullptr, true);
+}
+
+/*
+ * Reverse scan from the last key <= input key
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::RBegin(const KeyType &key) {
+  Page *page = FindLeafPage(key);
+  LeafPage *leafNode = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = leafNode->KeyIndex(key, comparator_);
+  while (true) {
+    //跳过相等的key，index停在第一个大于key的位置
+    while (index < leafNode->GetSize() && comparator_(leafNode->KeyAt(index), key) == 0) {
+      index++;
+    }
+    if (unique_keys_ || index < leafNode->GetSize() || leafNode->GetNextPageId() == INVALID_PAGE_ID) {
+      break;
+    }
+    //key可重复时，相等的key可能延续到下一个leaf
+    Page *nextPage = buffer_pool_manager_->FetchPage(leafNode->GetNextPageId());
+    LeafPage *nextNode = reinterpret_cast<LeafPage *>(nextPage->GetData());
+    if (comparator_(nextNode->KeyAt(0), key) != 0) {
+      buffer_pool_manager_->UnpinPage(nextPage->GetPageId(), false);
+      break;
+    }
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = nextPage;
+    leafNode = nextNode;
+    index = 0;
+  }
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, leafNode, index - 1, &comparator_, nullptr, true);
+}
+
+/*
+ * Bounded reverse scan over [lo, hi): from the last key < hi down to lo
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::RBegin(const KeyType &lo, const KeyType &hi) {
+  Page *page = FindLeafPage(hi);
+  LeafPage *leafNode = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = leafNode->KeyIndex(hi, comparator_);
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, leafNode, index - 1, &comparator_, &lo, true);
+}
+
+/*****************************************************************************
+ * SNAPSHOTS
+ *****************************************************************************/
+/*
+ * Shadow paging. Path copying would not fit these pages: a copied node moves
+ * to a new page id, and the parent ids of its children and the sibling links
+ * of its neighbours would have to be copied as well. So the tree is changed
+ * in place, and ShadowPageManager keeps the before-images for the open
+ * snapshots, which read every page through it. Only the parent page ids are
+ * not versioned, a snapshot never follows them.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::SetShadowPaging(bool enable) {
+  if (!enable) {
+    shadow_.reset();
+  } else if (shadow_ == nullptr) {
+    shadow_ = std::make_unique<ShadowPageManager>(buffer_pool_manager_);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+uint64_t BPLUSTREE_TYPE::TakeSnapshot() {
+  BUSTUB_ASSERT(shadow_ != nullptr, "shadow paging is off");
+  //等当前的写操作结束，snapshot看到的root和页面都是完整的
+  ShadowWriteGuard guard(shadow_.get());
+  return shadow_->TakeSnapshot(root_page_id_);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReleaseSnapshot(uint64_t snapshot) {
+  BUSTUB_ASSERT(shadow_ != nullptr, "shadow paging is off");
+  shadow_->ReleaseSnapshot(snapshot);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::GetValueAt(uint64_t snapshot, const KeyType &key, std::vector<ValueType> *result) {
+  bool found = false;
+  for (auto iter = SnapshotBegin(snapshot, key); !iter.isEnd() && comparator_((*iter).first, key) == 0; ++iter) {
+    result->push_back((*iter).second);
+    found = true;
+  }
+  return found;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+SNAPSHOT_INDEXITERATOR_TYPE BPLUSTREE_TYPE::SnapshotBegin(uint64_t snapshot) {
+  return SNAPSHOT_INDEXITERATOR_TYPE(shadow_.get(), snapshot, FindSnapshotLeaf(snapshot, nullptr), 0, &comparator_,
+                                     nullptr);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+SNAPSHOT_INDEXITERATOR_TYPE BPLUSTREE_TYPE::SnapshotBegin(uint64_t snapshot, const KeyType &key) {
+  std::unique_ptr<char[]> leaf = FindSnapshotLeaf(snapshot, &key);
+  int index = leaf == nullptr ? 0 : reinterpret_cast<LeafPage *>(leaf.get())->KeyIndex(key, comparator_);
+  return SNAPSHOT_INDEXITERATOR_TYPE(shadow_.get(), snapshot, std::move(leaf), index, &comparator_, nullptr);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+SNAPSHOT_INDEXITERATOR_TYPE BPLUSTREE_TYPE::SnapshotBegin(uint64_t snapshot, const KeyType &lo, const KeyType &hi) {
+  std::unique_ptr<char[]> leaf = FindSnapshotLeaf(snapshot, &lo);
+  int index = leaf == nullptr ? 0 : reinterpret_cast<LeafPage *>(leaf.get())->KeyIndex(lo, comparator_);
+  return SNAPSHOT_INDEXITERATOR_TYPE(shadow_.get(), snapshot, std::move(leaf), index, &comparator_, &hi);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+std::unique_ptr<char[]> BPLUSTREE_TYPE::FindSnapshotLeaf(uint64_t snapshot, const KeyType *key) {
+  BUSTUB_ASSERT(shadow_ != nullptr, "shadow paging is off");
+  page_id_t page_id = shadow_->GetRootPageId(snapshot);
+  if (page_id == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  //和FindLeafPage一样下降，只是每一层都读snapshot中的版本的拷贝
+  std::unique_ptr<char[]> buffer(new char[PAGE_SIZE]);
+  shadow_->ReadPage(snapshot, page_id, buffer.get());
+  auto *node = reinterpret_cast<BPlusTreePage *>(buffer.get());
+  while (!node->IsLeafPage()) {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    if (key == nullptr) {
+      page_id = internal->ValueAt(0);
+    } else {
+      page_id = internal->Lookup(InternalKey::First(*key), GetInternalComparator());
+    }
+    shadow_->ReadPage(snapshot, page_id, buffer.get());
+  }
+  return buffer;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ShadowPage(page_id_t page_id) {
+  if (shadow_ != nullptr) {
+    shadow_->BeforeWrite(page_id);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::DeleteNode(page_id_t page_id) {
+  if (shadow_ != nullptr) {
+    shadow_->DropPage(page_id);
+  } else {
+    buffer_pool_manager_->DeletePage(page_id);
+  }
+}
+
+/*****************************************************************************
+ * STATISTICS
+ *****************************************************************************/
+/*
+ * 1. walk the internal pages level by level: height, internal pages and the
+ *    ids of all leaves, in key order
+ * 2. read every leaf_sample_rate-th leaf: entries, fill and distinct keys
+ * 3. the histogram bucket bounds sit at fixed positions of the sampled
+ *    entries, read again only the leaves holding them
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::CollectStats(IndexStats *stats, std::vector<KeyType> *bounds, size_t num_buckets,
+                                  int leaf_sample_rate) {
+  *stats = IndexStats();
+  stats->leaf_sample_rate_ = std::max(1, leaf_sample_rate);
+  if (bloom_filter_ != nullptr) {
+    stats->bloom_filter_bytes_ = bloom_filter_->GetSizeInBytes();
+    stats->bloom_negatives_ = bloom_negatives_;
+    stats->bloom_false_positives_ = bloom_false_positives_;
+  }
+  bounds->clear();
+  if (IsEmpty()) {
+    return;
+  }
+
+  //1，按层遍历internal节点，最后一层就是全部的leaf
+  std::vector<page_id_t> level{root_page_id_};
+  uint64_t internal_entries = 0;
+  uint64_t internal_capacity = 0;
+  while (true) {
+    stats->height_++;
+    Page *page = buffer_pool_manager_->FetchPage(level[0]);
+    bool is_leaf = reinterpret_cast<BPlusTreePage *>(page->GetData())->IsLeafPage();
+    buffer_pool_manager_->UnpinPage(level[0], false);
+    if (is_leaf) {
+      break;
+    }
+    std::vector<page_id_t> children;
+    for (auto page_id : level) {
+      page = buffer_pool_manager_->FetchPage(page_id);
+      InternalPage *internal = reinterpret_cast<InternalPage *>(page->GetData());
+      stats->internal_page_count_++;
+      internal_entries += internal->GetSize();
+      internal_capacity += internal->GetMaxSize();
+      for (int i = 0; i < internal->GetSize(); i++) {
+        children.push_back(internal->ValueAt(i));
+      }
+      buffer_pool_manager_->UnpinPage(page_id, false);
+    }
+    level.swap(children);
+  }
+  stats->leaf_page_count_ = static_cast<uint32_t>(level.size());
+  stats->internal_fill_ = internal_capacity == 0 ? 0 : static_cast<double>(internal_entries) / internal_capacity;
+
+  //2，抽样的leaf，key有序，相邻key不同就是一个新的distinct key
+  // 抽样时跨leaf的相邻key不可见，只统计leaf内部相邻pair中key变化的比例
+  std::vector<page_id_t> sampled;
+  std::vector<int> sizes;
+  uint64_t entries = 0;
+  uint64_t capacity = 0;
+  uint64_t distinct = 0;
+  uint64_t pairs = 0;
+  uint64_t changes = 0;
+  KeyType last_key{};
+  for (size_t i = 0; i < level.size(); i += stats->leaf_sample_rate_) {
+    Page *page = buffer_pool_manager_->FetchPage(level[i]);
+    LeafPage *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    for (int j = 0; j < leaf->GetSize(); j++) {
+      bool changed = comparator_(leaf->KeyAt(j), last_key) != 0;
+      if ((entries == 0 && j == 0) || changed) {
+        distinct++;
+      }
+      if (j > 0) {
+        pairs++;
+        changes += changed ? 1 : 0;
+      }
+      last_key = leaf->KeyAt(j);
+    }
+    sampled.push_back(level[i]);
+    sizes.push_back(leaf->GetSize());
+    entries += leaf->GetSize();
+    capacity += leaf->GetMaxSize();
+    buffer_pool_manager_->UnpinPage(level[i], false);
+  }
+  double scale = static_cast<double>(level.size()) / sampled.size();
+  stats->num_entries_ = static_cast<uint64_t>(entries * scale);
+  if (stats->leaf_sample_rate_ == 1 || pairs == 0) {
+    stats->distinct_keys_ = distinct;
+  } else {
+    stats->distinct_keys_ =
+        1 + static_cast<uint64_t>(static_cast<double>(changes) / pairs * (stats->num_entries_ - 1));
+  }
+  stats->leaf_fill_ = capacity == 0 ? 0 : static_cast<double>(entries) / capacity;
+  if (entries == 0 || num_buckets == 0) {
+    return;
+  }
+
+  //3，第b个bucket的上界是第(b+1)*entries/num_buckets - 1个entry
+  num_buckets = std::min<size_t>(num_buckets, entries);
+  uint64_t prev_end = 0;
+  uint64_t leaf_begin = 0;
+  size_t leaf_index = 0;
+  for (size_t b = 0; b < num_buckets; b++) {
+    uint64_t end = (b + 1) * entries / num_buckets;
+    while (leaf_begin + sizes[leaf_index] < end) {
+      leaf_begin += sizes[leaf_index++];
+    }
+    Page *page = buffer_pool_manager_->FetchPage(sampled[leaf_index]);
+    LeafPage *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    bounds->push_back(leaf->KeyAt(static_cast<int>(end - 1 - leaf_begin)));
+    buffer_pool_manager_->UnpinPage(sampled[leaf_index], false);
+    stats->bucket_counts_.push_back(static_cast<uint64_t>((end - prev_end) * scale));
+    prev_end = end;
+  }
+}
+
 /*****************************************************************************
  * UTILITIES AND DEBUG
  *****************************************************************************/
@@ -619,8 +1323,16 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::end() {
  */
 INDEX_TEMPLATE_ARGUMENTS
 Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
+  //key可重复时，(key, 最小的RID)所在的leaf就是第一个可能包含key的leaf
+  return FindLeafPage(InternalKey::First(key), leftMost);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FindLeafPage(const InternalKey &separator, bool leftMost) {
   //寻找包含Key的leaf节点。
-  Page *cur_page = buffer_pool_manager_->FetchPage(root_page_id_);
+  InternalComparator comparator = GetInternalComparator();
+  int level = 0;
+  Page *cur_page = FetchNode(root_page_id_, level);
   BPlusTreePage *cur_node = reinterpret_cast<BPlusTreePage *>(cur_page->GetData());//表示目前正在查找的节点，从rootPage开始；
                                                                                    // 注意，treePage是page存储的data！
   while(!cur_node->IsLeafPage()){
@@ -630,11 +1342,11 @@ Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
       //如果要寻找最左侧leaf，那么直接搜索internalNode的第一个元素的ptr就行
       child_node_id = node->ValueAt(0);
     }else{
-      child_node_id = node->Lookup(key, comparator_);
+      child_node_id = node->Lookup(separator, comparator);
     }
-    buffer_pool_manager_->UnpinPage(cur_page->GetPageId(), false);
+    UnpinNode(cur_page, level);
 
-    cur_page = buffer_pool_manager_->FetchPage(child_node_id);
+    cur_page = FetchNode(child_node_id, ++level);
     cur_node = reinterpret_cast<BPlusTreePage *>(cur_page->GetData());
   }
 
@@ -645,6 +1357,198 @@ Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
 }
 
 
+/*
+ * FindLeafPage for a sorted stream of separators. "path" holds the pinned
+ * nodes from the root to the leaf of the previous one, each with the upper
+ * fence of its subtree. Since separators only grow, a node still covers the
+ * new one as long as it is below the fence: pop the nodes that do not, then
+ * descend again from the deepest one that does.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FindLeafPageOnPath(const InternalKey &separator, std::vector<PathEntry> *path) {
+  InternalComparator comparator = GetInternalComparator();
+  while (!path->empty()) {
+    const PathEntry &back = path->back();
+    if (!back.has_upper_ || comparator(separator, back.upper_) < 0) {
+      break;
+    }
+    buffer_pool_manager_->UnpinPage(back.page_->GetPageId(), back.dirty_);
+    path->pop_back();
+  }
+  if (path->empty()) {
+    path->push_back(PathEntry{buffer_pool_manager_->FetchPage(root_page_id_), InternalKey{}, false, false});
+  }
+  while (true) {
+    PathEntry parent = path->back();
+    auto *node = reinterpret_cast<BPlusTreePage *>(parent.page_->GetData());
+    if (node->IsLeafPage()) {
+      return parent.page_;
+    }
+    InternalPage *internal = reinterpret_cast<InternalPage *>(node);
+    int index = internal->ChildIndex(separator, comparator);
+    PathEntry child{buffer_pool_manager_->FetchPage(internal->ValueAt(index)), parent.upper_, parent.has_upper_, false};
+    if (index + 1 < internal->GetSize()) {
+      child.upper_ = internal->KeyAt(index + 1);
+      child.has_upper_ = true;
+    }
+    path->push_back(child);
+  }
+}
+
+/*
+ * Page fetch for the read-only descents (FindLeafPage, FindRightMostLeafPage).
+ * An internal page of the top pinned_levels_ levels keeps the pin of its first
+ * fetch in pinned_pages_, later descents take it from there without a buffer
+ * pool lookup, and UnpinNode leaves it pinned. Leaf pages are never kept:
+ * they are handed to the caller, which unpins them.
+ * Every other path fetches and unpins through the buffer pool as usual, the
+ * extra pin does not get in its way.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FetchNode(page_id_t page_id, int level) {
+  if (level >= pinned_levels_) {
+    return buffer_pool_manager_->FetchPage(page_id);
+  }
+  auto iter = pinned_pages_.find(page_id);
+  if (iter != pinned_pages_.end()) {
+    return iter->second;
+  }
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page != nullptr && !reinterpret_cast<BPlusTreePage *>(page->GetData())->IsLeafPage()) {
+    pinned_pages_.emplace(page_id, page);
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::UnpinNode(Page *page, int level) {
+  if (level < pinned_levels_ && pinned_pages_.count(page->GetPageId()) != 0) {
+    return;
+  }
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+}
+
+/*
+ * Drop the pin kept for page_id, must be called before the page is deleted
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReleasePinnedPage(page_id_t page_id) {
+  auto iter = pinned_pages_.find(page_id);
+  if (iter != pinned_pages_.end()) {
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    pinned_pages_.erase(iter);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReleasePinnedPages() {
+  for (const auto &entry : pinned_pages_) {
+    buffer_pool_manager_->UnpinPage(entry.first, false);
+  }
+  pinned_pages_.clear();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::SetInterpolationSearch(bool enable) {
+  //开关在comparator里，页面搜索时由BPlusTreeKeySearch读取
+  if constexpr (HasInterpolationSearch<KeyComparator>::value) {
+    comparator_.SetInterpolationSearch(enable);
+    return true;
+  }
+  return false;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::SetPinnedLevels(int levels) {
+  ReleasePinnedPages();
+  pinned_levels_ = levels;
+}
+
+/*****************************************************************************
+ * BLOOM FILTER
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::EnableBloomFilter(size_t expected_keys, int bits_per_key) {
+  bloom_bits_per_key_ = bits_per_key;
+  bloom_negatives_ = 0;
+  bloom_false_positives_ = 0;
+  RebuildBloomFilter(expected_keys);
+}
+
+/*
+ * Hash every key of the leaf chain into a new filter sized for the larger of
+ * expected_keys and the current number of entries.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RebuildBloomFilter(size_t expected_keys) {
+  std::vector<uint64_t> hashes;
+  if (!IsEmpty()) {
+    KeyType useless{};
+    Page *page = FindLeafPage(useless, true);
+    while (page != nullptr) {
+      LeafPage *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+      for (int i = 0; i < leaf->GetSize(); i++) {
+        hashes.push_back(bloom_hash_.GetHash(leaf->KeyAt(i)));
+      }
+      page_id_t next_page_id = leaf->GetNextPageId();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      page = next_page_id == INVALID_PAGE_ID ? nullptr : buffer_pool_manager_->FetchPage(next_page_id);
+    }
+  }
+  bloom_capacity_ = std::max(expected_keys, hashes.size());
+  bloom_filter_ = std::make_unique<BloomFilter>(bloom_capacity_, bloom_bits_per_key_);
+  for (auto hash : hashes) {
+    bloom_filter_->Insert(hash);
+  }
+  bloom_keys_ = hashes.size();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::BloomMayContain(const KeyType &key) {
+  return bloom_filter_ == nullptr || bloom_filter_->MayContain(bloom_hash_.GetHash(key));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BloomInsert(const KeyType &key) {
+  if (bloom_filter_ == nullptr) {
+    return;
+  }
+  if (bloom_keys_ >= bloom_capacity_) {
+    //超过预期的key数量，误判率会快速上升：按两倍容量重建，key已经在树里了
+    RebuildBloomFilter(2 * bloom_capacity_);
+    return;
+  }
+  bloom_filter_->Insert(bloom_hash_.GetHash(key));
+  bloom_keys_++;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReleasePath(std::vector<PathEntry> *path) {
+  for (const auto &entry : *path) {
+    buffer_pool_manager_->UnpinPage(entry.page_->GetPageId(), entry.dirty_);
+  }
+  path->clear();
+}
+
+/*
+ * Find the right most leaf page, following the last child pointer of every
+ * internal page
+ */
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FindRightMostLeafPage() {
+  int level = 0;
+  Page *cur_page = FetchNode(root_page_id_, level);
+  BPlusTreePage *cur_node = reinterpret_cast<BPlusTreePage *>(cur_page->GetData());
+  while (!cur_node->IsLeafPage()) {
+    InternalPage *node = reinterpret_cast<InternalPage *>(cur_node);
+    page_id_t child_node_id = node->ValueAt(node->GetSize() - 1);
+    UnpinNode(cur_page, level);
+    cur_page = FetchNode(child_node_id, ++level);
+    cur_node = reinterpret_cast<BPlusTreePage *>(cur_page->GetData());
+  }
+  return cur_page;
+}
+
 /**
  * 递归查找curNode的左兄弟，curNode的父节点已经是最左侧了，那就递归查找父节点的左兄弟，返回父节点左兄弟的最右侧孩子value
  * @tparam KeyType
@@ -737,8 +1641,27 @@ page_id_t BPlusTree<KeyType, ValueType, KeyComparator>::FindRightBro(BPlusTreePa
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::UpdateRootPageId(int insert_record) {
+  //root变了，各个页面所在的层也跟着变了，常驻的页面全部释放，之后的查找重新pin
+  ReleasePinnedPages();
+  //之前要求insert的话，合并后的这次写入仍然insert
+  pending_root_update_ = std::max(pending_root_update_, insert_record);
+  if (!defer_root_updates_) {
+    FlushRootPageId();
+  }
+}
+
+/*
+ * Write the pending root page id to the header page. With
+ * SetDeferRootUpdates(true) root changes are only recorded, and this is where
+ * they reach the header page.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::FlushRootPageId() {
+  if (pending_root_update_ < 0) {
+    return;
+  }
   HeaderPage *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
-  if (insert_record != 0) {
+  if (pending_root_update_ != 0) {
     // create a new record<index_name + root_page_id> in header_page
     header_page->InsertRecord(index_name_, root_page_id_);
   } else {
@@ -746,6 +1669,7 @@ void BPLUSTREE_TYPE::UpdateRootPageId(int insert_record) {
     header_page->UpdateRecord(index_name_, root_page_id_);
   }
   buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
+  pending_root_update_ = -1;
 }
 
 /*
@@ -762,7 +1686,7 @@ void BPLUSTREE_TYPE::InsertFromFile(const std::string &file_name, Transaction *t
     KeyType index_key;
     index_key.SetFromInteger(key);
     RID rid(key);
-    Insert(index_key, rid, transaction);
+    Insert(index_key, IndexValue<ValueType>::Make(rid, nullptr), transaction);
   }
 }
 /*
@@ -912,4 +1836,9 @@ template class BPlusTree<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTree<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTree<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class BPlusTree<GenericKey<8>, RID, GenericIntegerComparator<8>>;
+
+template class BPlusTree<GenericKey<8>, CoveringValue<16>, GenericComparator<8>>;
+template class BPlusTree<GenericKey<16>, CoveringValue<32>, GenericComparator<16>>;
+
 }  // namespace bustub
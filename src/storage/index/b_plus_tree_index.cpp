@@ -9,6 +9,13 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <iterator>
+#include <thread>  // NOLINT
+#include <type_traits>
+#include <utility>
+
+#include "common/exception.h"
 #include "storage/index/b_plus_tree_index.h"
 
 namespace bustub {
@@ -19,7 +26,9 @@ INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager)
     : Index(metadata),
       comparator_(metadata->GetKeySchema()),
-      container_(metadata->GetName(), buffer_pool_manager, comparator_) {}
+      container_(metadata->GetName(), buffer_pool_manager, comparator_) {
+  container_.SetUniqueKeys(metadata->IsUnique());
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
@@ -27,7 +36,15 @@ void BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *t
   KeyType index_key;
   index_key.SetFromKey(key);
 
-  container_.Insert(index_key, rid, transaction);
+  container_.Insert(index_key, IndexValue<ValueType>::Make(rid, nullptr), transaction);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, const Tuple &included, RID rid, Transaction *transaction) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  container_.Insert(index_key, IndexValue<ValueType>::Make(rid, &included), transaction);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -36,7 +53,8 @@ void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *t
   KeyType index_key;
   index_key.SetFromKey(key);
 
-  container_.Remove(index_key, transaction);
+  // covering values compare by rid only, the included columns are not needed
+  container_.Remove(index_key, IndexValue<ValueType>::Make(rid, nullptr), transaction);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -45,7 +63,109 @@ void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, T
   KeyType index_key;
   index_key.SetFromKey(key);
 
-  container_.GetValue(index_key, result, transaction);
+  if constexpr (std::is_same_v<ValueType, RID>) {
+    container_.GetValue(index_key, result, transaction);
+  } else {
+    std::vector<ValueType> values;
+    container_.GetValue(index_key, &values, transaction);
+    for (const auto &value : values) {
+      result->push_back(IndexValue<ValueType>::GetRid(value));
+    }
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, std::vector<Tuple> *included,
+                                   Transaction *transaction) {
+  if constexpr (!IndexValue<ValueType>::COVERING) {
+    ScanKey(key, result, transaction);
+  } else {
+    KeyType index_key;
+    index_key.SetFromKey(key);
+
+    // index-only lookup: the included columns come from the leaf, the table is not touched
+    std::vector<ValueType> values;
+    container_.GetValue(index_key, &values, transaction);
+    for (const auto &value : values) {
+      result->push_back(value.rid_);
+      included->push_back(value.ToTuple(GetIncludedSchema()));
+    }
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::BuildFromTable(TableHeap *table_heap, const Schema &schema, size_t num_threads,
+                                          Transaction *transaction) {
+  std::vector<page_id_t> page_ids = table_heap->GetPageIds();
+  num_threads = std::max<size_t>(1, std::min(num_threads, page_ids.size()));
+  auto less = [this](const MappingType &lhs, const MappingType &rhs) { return comparator_(lhs.first, rhs.first) < 0; };
+
+  // 1. every thread scans a contiguous range of pages and sorts its own run;
+  // stable sort keeps equal keys in rid order
+  std::vector<std::vector<MappingType>> runs(num_threads);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; t++) {
+    size_t begin = page_ids.size() * t / num_threads;
+    size_t end = page_ids.size() * (t + 1) / num_threads;
+    threads.emplace_back([&, t, begin, end] {
+      std::vector<Tuple> tuples;
+      for (size_t i = begin; i < end; i++) {
+        tuples.clear();
+        table_heap->GetPageTuples(page_ids[i], &tuples, transaction);
+        for (auto &tuple : tuples) {
+          KeyType index_key;
+          index_key.SetFromKey(tuple.KeyFromTuple(schema, *GetKeySchema(), GetKeyAttrs()));
+          if constexpr (IndexValue<ValueType>::COVERING) {
+            Tuple included = tuple.KeyFromTuple(schema, *GetIncludedSchema(), GetIncludedAttrs());
+            runs[t].emplace_back(index_key, IndexValue<ValueType>::Make(tuple.GetRid(), &included));
+          } else {
+            runs[t].emplace_back(index_key, tuple.GetRid());
+          }
+        }
+      }
+      std::stable_sort(runs[t].begin(), runs[t].end(), less);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // 2. merge the runs pairwise, the earlier run first so that the rid order survives
+  while (runs.size() > 1) {
+    std::vector<std::vector<MappingType>> merged;
+    for (size_t i = 0; i + 1 < runs.size(); i += 2) {
+      merged.emplace_back();
+      merged.back().reserve(runs[i].size() + runs[i + 1].size());
+      std::merge(runs[i].begin(), runs[i].end(), runs[i + 1].begin(), runs[i + 1].end(),
+                 std::back_inserter(merged.back()), less);
+    }
+    if (runs.size() % 2 == 1) {
+      merged.push_back(std::move(runs.back()));
+    }
+    runs.swap(merged);
+  }
+
+  // 3. a unique index must not drop duplicates silently, equal keys are adjacent after the merge
+  if (GetMetadata()->IsUnique()) {
+    auto dup = std::adjacent_find(runs[0].begin(), runs[0].end(), [this](const MappingType &lhs, const MappingType &rhs) {
+      return comparator_(lhs.first, rhs.first) == 0;
+    });
+    if (dup != runs[0].end()) {
+      throw Exception(ExceptionType::INVALID, "duplicate key in unique index " + GetName());
+    }
+  }
+
+  // 4. bulk load
+  container_.BulkLoad(&runs[0], transaction);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::CollectStats(IndexStats *stats, size_t num_buckets, int leaf_sample_rate) {
+  std::vector<KeyType> bounds;
+  container_.CollectStats(stats, &bounds, num_buckets, leaf_sample_rate);
+  for (const auto &bound : bounds) {
+    stats->bucket_bounds_.push_back(bound.ToValue(GetKeySchema(), 0));
+  }
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -57,10 +177,23 @@ INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetBeginIterator(const KeyType &key) {
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetEndIterator() { return container_.end(); }
 
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetBeginIterator(const KeyType &lo, const KeyType &hi) {
+  return container_.Begin(lo, hi);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetReverseBeginIterator() { return container_.RBegin(); }
+
 template class BPlusTreeIndex<GenericKey<4>, RID, GenericComparator<4>>;
 template class BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTreeIndex<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTreeIndex<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class BPlusTreeIndex<GenericKey<8>, RID, GenericIntegerComparator<8>>;
+
+template class BPlusTreeIndex<GenericKey<8>, CoveringValue<16>, GenericComparator<8>>;
+template class BPlusTreeIndex<GenericKey<16>, CoveringValue<32>, GenericComparator<16>>;
+
 }  // namespace bustub
@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter.cpp
+//
+// Identification: src/storage/index/bloom_filter.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/bloom_filter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace bustub {
+
+BloomFilter::BloomFilter(size_t expected_keys, int bits_per_key) {
+  bits_per_key = std::max(1, bits_per_key);
+  size_t bits = std::max<size_t>(1, expected_keys) * bits_per_key;
+  num_blocks_ = (bits + BITS_PER_BLOCK - 1) / BITS_PER_BLOCK;
+  // k = ln 2 * bits per key minimizes the false positive rate
+  num_probes_ = std::clamp(static_cast<int>(std::lround(bits_per_key * 0.69)), 1, 16);
+  blocks_.assign(num_blocks_ * WORDS_PER_BLOCK, 0);
+}
+
+size_t BloomFilter::BlockOf(uint64_t hash) const {
+  //用hash的高32位把块号映射到[0, num_blocks_)，乘法代替取模
+  return static_cast<size_t>(((hash >> 32) * num_blocks_) >> 32) * WORDS_PER_BLOCK;
+}
+
+void BloomFilter::Insert(uint64_t hash) {
+  uint64_t *block = &blocks_[BlockOf(hash)];
+  auto h1 = static_cast<uint32_t>(hash);
+  uint32_t h2 = (h1 >> 17) | (h1 << 15);
+  for (int i = 0; i < num_probes_; i++) {
+    uint32_t bit = h1 % BITS_PER_BLOCK;
+    block[bit / 64] |= uint64_t{1} << (bit % 64);
+    h1 += h2;
+  }
+}
+
+bool BloomFilter::MayContain(uint64_t hash) const {
+  const uint64_t *block = &blocks_[BlockOf(hash)];
+  auto h1 = static_cast<uint32_t>(hash);
+  uint32_t h2 = (h1 >> 17) | (h1 << 15);
+  for (int i = 0; i < num_probes_; i++) {
+    uint32_t bit = h1 % BITS_PER_BLOCK;
+    if ((block[bit / 64] & (uint64_t{1} << (bit % 64))) == 0) {
+      return false;
+    }
+    h1 += h2;
+  }
+  return true;
+}
+
+}  // namespace bustub
@@ -0,0 +1,484 @@
+/**
+ * in_memory_b_plus_tree.cpp
+ */
+#include <algorithm>
+#include <string>
+
+#include "common/exception.h"
+#include "common/rid.h"
+#include "storage/index/covering_value.h"
+#include "storage/index/in_memory_b_plus_tree.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+IN_MEMORY_BPLUSTREE_TYPE::InMemoryBPlusTree(std::string name, const KeyComparator &comparator, int leaf_max_size,
+                                            int internal_max_size)
+    : index_name_(std::move(name)),
+      comparator_(comparator),
+      leaf_max_size_(leaf_max_size),
+      internal_max_size_(internal_max_size) {
+  //内部节点分裂后两边都至少要有一个孩子
+  BUSTUB_ASSERT(leaf_max_size_ >= 2 && internal_max_size_ >= 3, "node sizes are too small");
+  //根节点一开始是一个空的leaf，root_永远不为空
+  root_.store(NewLeaf());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool IN_MEMORY_BPLUSTREE_TYPE::IsEmpty() const {
+  //删除不合并节点，所以要看有没有非空的leaf，而不是看根节点
+  IN_MEMORY_INDEXITERATOR_TYPE iter(&comparator_, nullptr, false);
+  iter.SeekFirst(FindLeaf(nullptr, false));
+  return iter.isEnd();
+}
+
+/*****************************************************************************
+ * NODES
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+typename IN_MEMORY_BPLUSTREE_TYPE::LeafNode *IN_MEMORY_BPLUSTREE_TYPE::NewLeaf() {
+  void *memory = arena_.Allocate(sizeof(LeafNode) + leaf_max_size_ * sizeof(MappingType), alignof(LeafNode));
+  auto *leaf = new (memory) LeafNode();
+  leaf->is_leaf_ = true;
+  leaf->max_size_ = leaf_max_size_;
+  return leaf;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+typename IN_MEMORY_BPLUSTREE_TYPE::InternalNode *IN_MEMORY_BPLUSTREE_TYPE::NewInternal() {
+  void *memory = arena_.Allocate(sizeof(InternalNode) + internal_max_size_ * sizeof(std::pair<KeyType, Node *>),
+                                 alignof(InternalNode));
+  auto *inner = new (memory) InternalNode();
+  inner->max_size_ = internal_max_size_;
+  return inner;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int IN_MEMORY_BPLUSTREE_TYPE::ChildIndex(const InternalNode *inner, int size, const KeyType &key, bool upper) const {
+  // binary search over the keys 1..size-1 for the last child whose key is < key (<= key if upper)
+  int lo = 1;
+  int hi = size;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    int cmp = comparator_(inner->array_[mid].first, key);
+    if (cmp < 0 || (upper && cmp == 0)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo - 1;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int IN_MEMORY_BPLUSTREE_TYPE::LeafIndex(const LeafNode *leaf, int size, const KeyType &key, bool upper) const {
+  int lo = 0;
+  int hi = size;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    int cmp = comparator_(leaf->array_[mid].first, key);
+    if (cmp < 0 || (upper && cmp == 0)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+typename IN_MEMORY_BPLUSTREE_TYPE::LeafNode *IN_MEMORY_BPLUSTREE_TYPE::SplitLeaf(LeafNode *leaf, KeyType *separator) {
+  LeafNode *right = NewLeaf();
+  int mid = leaf->size_ / 2;
+  std::copy(leaf->array_ + mid, leaf->array_ + leaf->size_, right->array_);
+  right->size_ = leaf->size_ - mid;
+  leaf->size_ = mid;
+  *separator = right->array_[0].first;
+  //双向链表：leaf <-> right <-> 原来的next，next的prev由调用者加锁后修改
+  right->prev_ = leaf;
+  right->next_ = leaf->next_;
+  if (leaf->next_ != nullptr) {
+    leaf->next_->prev_ = right;
+  }
+  leaf->next_ = right;
+  return right;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+typename IN_MEMORY_BPLUSTREE_TYPE::InternalNode *IN_MEMORY_BPLUSTREE_TYPE::SplitInternal(InternalNode *inner,
+                                                                                         KeyType *separator) {
+  InternalNode *right = NewInternal();
+  int mid = inner->size_ / 2;
+  std::copy(inner->array_ + mid, inner->array_ + inner->size_, right->array_);
+  right->size_ = inner->size_ - mid;
+  inner->size_ = mid;
+  //右边第一个key移到父节点，在右节点里不再使用
+  *separator = right->array_[0].first;
+  return right;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void IN_MEMORY_BPLUSTREE_TYPE::InsertIntoParent(InternalNode *parent, Node *left, const KeyType &separator,
+                                                Node *right) {
+  if (parent == nullptr) {
+    InternalNode *root = NewInternal();
+    root->array_[0].second = left;
+    root->array_[1] = std::make_pair(separator, right);
+    root->size_ = 2;
+    root_.store(root);
+    return;
+  }
+  // keys may repeat, so find left by pointer
+  int index = 0;
+  while (parent->array_[index].second != left) {
+    index++;
+  }
+  std::copy_backward(parent->array_ + index + 1, parent->array_ + parent->size_,
+                     parent->array_ + parent->size_ + 1);
+  parent->array_[index + 1] = std::make_pair(separator, right);
+  parent->size_++;
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+bool IN_MEMORY_BPLUSTREE_TYPE::TryFindLeaf(const KeyType *key, bool upper, bool rightMost, LeafNode **leaf) const {
+  bool restart = false;
+  Node *node = root_.load();
+  uint64_t version = node->ReadLockOrRestart(&restart);
+  if (restart || node != root_.load()) {
+    return false;
+  }
+  while (!node->is_leaf_) {
+    auto *inner = static_cast<InternalNode *>(node);
+    int size = std::min(inner->size_, internal_max_size_);
+    int index = key == nullptr ? (rightMost ? size - 1 : 0) : ChildIndex(inner, size, *key, upper);
+    Node *child = inner->array_[std::max(index, 0)].second;
+    //读到的孩子指针要先校验父节点的版本，才能去访问它
+    inner->CheckOrRestart(version, &restart);
+    if (restart) {
+      return false;
+    }
+    node = child;
+    uint64_t parent_version = version;
+    version = node->ReadLockOrRestart(&restart);
+    //再校验一次父节点：孩子可能在读到指针之后、读到它的版本之前分裂了，key已经不归它管
+    inner->CheckOrRestart(parent_version, &restart);
+    if (restart) {
+      return false;
+    }
+  }
+  *leaf = static_cast<LeafNode *>(node);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+typename IN_MEMORY_BPLUSTREE_TYPE::LeafNode *IN_MEMORY_BPLUSTREE_TYPE::FindLeaf(const KeyType *key, bool upper,
+                                                                                 bool rightMost) const {
+  LeafNode *leaf;
+  while (!TryFindLeaf(key, upper, rightMost, &leaf)) {
+  }
+  return leaf;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool IN_MEMORY_BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) {
+  size_t old_size = result->size();
+  bool found;
+  while (!TryGetValue(key, result, &found)) {
+    result->resize(old_size);
+  }
+  return found;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool IN_MEMORY_BPLUSTREE_TYPE::TryGetValue(const KeyType &key, std::vector<ValueType> *result, bool *found) {
+  *found = false;
+  LeafNode *leaf;
+  if (!TryFindLeaf(&key, false, false, &leaf)) {
+    return false;
+  }
+  //从可能包含key的最左侧leaf开始，沿着叶子链表收集所有相等的key
+  while (leaf != nullptr) {
+    bool restart = false;
+    uint64_t version = leaf->ReadLockOrRestart(&restart);
+    if (restart) {
+      return false;
+    }
+    int size = std::min(leaf->size_, leaf_max_size_);
+    int index = LeafIndex(leaf, size, key, false);
+    size_t old_size = result->size();
+    while (index < size && comparator_(leaf->array_[index].first, key) == 0) {
+      result->push_back(leaf->array_[index].second);
+      index++;
+    }
+    LeafNode *next = leaf->next_;
+    leaf->CheckOrRestart(version, &restart);
+    if (restart) {
+      return false;
+    }
+    *found = *found || result->size() > old_size;
+    if (index < size || (unique_keys_ && *found)) {
+      break;
+    }
+    leaf = next;
+  }
+  return true;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+bool IN_MEMORY_BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  bool inserted;
+  while (!TryInsert(key, value, &inserted)) {
+  }
+  return inserted;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool IN_MEMORY_BPLUSTREE_TYPE::TryInsert(const KeyType &key, const ValueType &value, bool *inserted) {
+  bool restart = false;
+  Node *node = root_.load();
+  uint64_t version = node->ReadLockOrRestart(&restart);
+  if (restart || node != root_.load()) {
+    return false;
+  }
+  InternalNode *parent = nullptr;
+  uint64_t parent_version = 0;
+
+  while (!node->is_leaf_) {
+    auto *inner = static_cast<InternalNode *>(node);
+    if (inner->size_ == internal_max_size_) {
+      //满的内部节点在下降的路上就分裂，这样它的父节点一定有空位。分裂完重新开始
+      if (parent != nullptr) {
+        parent->UpgradeToWriteLockOrRestart(parent_version, &restart);
+        if (restart) {
+          return false;
+        }
+      }
+      inner->UpgradeToWriteLockOrRestart(version, &restart);
+      if (restart) {
+        if (parent != nullptr) {
+          parent->WriteUnlock();
+        }
+        return false;
+      }
+      KeyType separator;
+      InternalNode *right = SplitInternal(inner, &separator);
+      InsertIntoParent(parent, inner, separator, right);
+      inner->WriteUnlock();
+      if (parent != nullptr) {
+        parent->WriteUnlock();
+      }
+      return false;
+    }
+    parent = inner;
+    parent_version = version;
+    int size = std::min(inner->size_, internal_max_size_);
+    node = inner->array_[ChildIndex(inner, size, key, unique_keys_)].second;
+    inner->CheckOrRestart(version, &restart);
+    if (restart) {
+      return false;
+    }
+    version = node->ReadLockOrRestart(&restart);
+    inner->CheckOrRestart(parent_version, &restart);
+    if (restart) {
+      return false;
+    }
+  }
+
+  auto *leaf = static_cast<LeafNode *>(node);
+  int size = std::min(leaf->size_, leaf_max_size_);
+  // keys are unique: the descent went to the only leaf that can hold key; otherwise a new duplicate goes first
+  int index = LeafIndex(leaf, size, key, false);
+  if (unique_keys_ && index < size && comparator_(leaf->array_[index].first, key) == 0) {
+    leaf->CheckOrRestart(version, &restart);
+    if (restart) {
+      return false;
+    }
+    *inserted = false;
+    return true;
+  }
+
+  if (size == leaf_max_size_) {
+    //leaf满了：锁住父节点、leaf和右兄弟（要改它的prev），分裂后重新开始
+    if (parent != nullptr) {
+      parent->UpgradeToWriteLockOrRestart(parent_version, &restart);
+      if (restart) {
+        return false;
+      }
+    }
+    leaf->UpgradeToWriteLockOrRestart(version, &restart);
+    if (restart) {
+      if (parent != nullptr) {
+        parent->WriteUnlock();
+      }
+      return false;
+    }
+    LeafNode *next = leaf->next_;
+    if (next != nullptr) {
+      uint64_t next_version = next->ReadLockOrRestart(&restart);
+      if (!restart) {
+        next->UpgradeToWriteLockOrRestart(next_version, &restart);
+      }
+      if (restart) {
+        leaf->WriteUnlock();
+        if (parent != nullptr) {
+          parent->WriteUnlock();
+        }
+        return false;
+      }
+    }
+    KeyType separator;
+    LeafNode *right = SplitLeaf(leaf, &separator);
+    InsertIntoParent(parent, leaf, separator, right);
+    if (next != nullptr) {
+      next->WriteUnlock();
+    }
+    leaf->WriteUnlock();
+    if (parent != nullptr) {
+      parent->WriteUnlock();
+    }
+    return false;
+  }
+
+  //只需要锁住leaf：版本号没变说明上面读到的index仍然有效
+  leaf->UpgradeToWriteLockOrRestart(version, &restart);
+  if (restart) {
+    return false;
+  }
+  std::copy_backward(leaf->array_ + index, leaf->array_ + size, leaf->array_ + size + 1);
+  leaf->array_[index] = std::make_pair(key, value);
+  leaf->size_++;
+  leaf->WriteUnlock();
+  *inserted = true;
+  return true;
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void IN_MEMORY_BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
+  bool removed;
+  while (!TryRemove(key, nullptr, &removed)) {
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool IN_MEMORY_BPLUSTREE_TYPE::Remove(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  bool removed;
+  while (!TryRemove(key, &value, &removed)) {
+  }
+  return removed;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool IN_MEMORY_BPLUSTREE_TYPE::TryRemove(const KeyType &key, const ValueType *value, bool *removed) {
+  *removed = false;
+  LeafNode *leaf;
+  if (!TryFindLeaf(&key, false, false, &leaf)) {
+    return false;
+  }
+  while (leaf != nullptr) {
+    bool restart = false;
+    uint64_t version = leaf->ReadLockOrRestart(&restart);
+    if (restart) {
+      return false;
+    }
+    int size = std::min(leaf->size_, leaf_max_size_);
+    int index = LeafIndex(leaf, size, key, false);
+    while (index < size && comparator_(leaf->array_[index].first, key) == 0) {
+      if (value == nullptr || leaf->array_[index].second == *value) {
+        //不合并节点，leaf可以变空
+        leaf->UpgradeToWriteLockOrRestart(version, &restart);
+        if (restart) {
+          return false;
+        }
+        std::copy(leaf->array_ + index + 1, leaf->array_ + size, leaf->array_ + index);
+        leaf->size_--;
+        leaf->WriteUnlock();
+        *removed = true;
+        return true;
+      }
+      index++;
+    }
+    LeafNode *next = leaf->next_;
+    leaf->CheckOrRestart(version, &restart);
+    if (restart) {
+      return false;
+    }
+    if (index < size) {
+      break;
+    }
+    leaf = next;
+  }
+  return true;
+}
+
+/*****************************************************************************
+ * INDEX ITERATOR
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+IN_MEMORY_INDEXITERATOR_TYPE IN_MEMORY_BPLUSTREE_TYPE::begin() {
+  IN_MEMORY_INDEXITERATOR_TYPE iter(&comparator_, nullptr, false);
+  iter.SeekFirst(FindLeaf(nullptr, false));
+  return iter;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+IN_MEMORY_INDEXITERATOR_TYPE IN_MEMORY_BPLUSTREE_TYPE::Begin(const KeyType &key) {
+  IN_MEMORY_INDEXITERATOR_TYPE iter(&comparator_, nullptr, false);
+  iter.SeekLowerBound(FindLeaf(&key, false), key);
+  return iter;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+IN_MEMORY_INDEXITERATOR_TYPE IN_MEMORY_BPLUSTREE_TYPE::end() {
+  return IN_MEMORY_INDEXITERATOR_TYPE(&comparator_, nullptr, false);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+IN_MEMORY_INDEXITERATOR_TYPE IN_MEMORY_BPLUSTREE_TYPE::Begin(const KeyType &lo, const KeyType &hi) {
+  IN_MEMORY_INDEXITERATOR_TYPE iter(&comparator_, &hi, false);
+  iter.SeekLowerBound(FindLeaf(&lo, false), lo);
+  return iter;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+IN_MEMORY_INDEXITERATOR_TYPE IN_MEMORY_BPLUSTREE_TYPE::RBegin() {
+  IN_MEMORY_INDEXITERATOR_TYPE iter(&comparator_, nullptr, true);
+  iter.SeekLast(FindLeaf(nullptr, false, true));
+  return iter;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+IN_MEMORY_INDEXITERATOR_TYPE IN_MEMORY_BPLUSTREE_TYPE::RBegin(const KeyType &key) {
+  IN_MEMORY_INDEXITERATOR_TYPE iter(&comparator_, nullptr, true);
+  // keys equal to key can be right of the separator equal to key only if keys are not unique
+  iter.SeekReverse(FindLeaf(&key, true), key, true);
+  return iter;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+IN_MEMORY_INDEXITERATOR_TYPE IN_MEMORY_BPLUSTREE_TYPE::RBegin(const KeyType &lo, const KeyType &hi) {
+  IN_MEMORY_INDEXITERATOR_TYPE iter(&comparator_, &lo, true);
+  iter.SeekReverse(FindLeaf(&hi, false), hi, false);
+  return iter;
+}
+
+template class InMemoryBPlusTree<GenericKey<4>, RID, GenericComparator<4>>;
+template class InMemoryBPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+template class InMemoryBPlusTree<GenericKey<16>, RID, GenericComparator<16>>;
+template class InMemoryBPlusTree<GenericKey<32>, RID, GenericComparator<32>>;
+template class InMemoryBPlusTree<GenericKey<64>, RID, GenericComparator<64>>;
+
+template class InMemoryBPlusTree<GenericKey<8>, RID, GenericIntegerComparator<8>>;
+
+template class InMemoryBPlusTree<GenericKey<8>, CoveringValue<16>, GenericComparator<8>>;
+template class InMemoryBPlusTree<GenericKey<16>, CoveringValue<32>, GenericComparator<16>>;
+
+}  // namespace bustub
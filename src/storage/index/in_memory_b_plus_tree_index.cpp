@@ -0,0 +1,152 @@
+/**
+ * in_memory_b_plus_tree_index.cpp
+ */
+#include <algorithm>
+#include <atomic>
+#include <thread>  // NOLINT
+#include <type_traits>
+
+#include "common/exception.h"
+#include "storage/index/in_memory_b_plus_tree_index.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+IN_MEMORY_BPLUSTREE_INDEX_TYPE::InMemoryBPlusTreeIndex(IndexMetadata *metadata)
+    : Index(metadata), comparator_(metadata->GetKeySchema()), container_(metadata->GetName(), comparator_) {
+  container_.SetUniqueKeys(metadata->IsUnique());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void IN_MEMORY_BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  container_.Insert(index_key, IndexValue<ValueType>::Make(rid, nullptr), transaction);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void IN_MEMORY_BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, const Tuple &included, RID rid,
+                                                 Transaction *transaction) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  container_.Insert(index_key, IndexValue<ValueType>::Make(rid, &included), transaction);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void IN_MEMORY_BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  container_.Remove(index_key, IndexValue<ValueType>::Make(rid, nullptr), transaction);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void IN_MEMORY_BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  if constexpr (std::is_same_v<ValueType, RID>) {
+    container_.GetValue(index_key, result, transaction);
+  } else {
+    std::vector<ValueType> values;
+    container_.GetValue(index_key, &values, transaction);
+    for (const auto &value : values) {
+      result->push_back(IndexValue<ValueType>::GetRid(value));
+    }
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void IN_MEMORY_BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, std::vector<Tuple> *included,
+                                             Transaction *transaction) {
+  if constexpr (!IndexValue<ValueType>::COVERING) {
+    ScanKey(key, result, transaction);
+  } else {
+    KeyType index_key;
+    index_key.SetFromKey(key);
+
+    std::vector<ValueType> values;
+    container_.GetValue(index_key, &values, transaction);
+    for (const auto &value : values) {
+      result->push_back(value.rid_);
+      included->push_back(value.ToTuple(GetIncludedSchema()));
+    }
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void IN_MEMORY_BPLUSTREE_INDEX_TYPE::BuildFromTable(TableHeap *table_heap, const Schema &schema, size_t num_threads,
+                                                    Transaction *transaction) {
+  std::vector<page_id_t> page_ids = table_heap->GetPageIds();
+  num_threads = std::max<size_t>(1, std::min(num_threads, page_ids.size()));
+
+  // 唯一索引插入重复key时Insert返回false，不能在线程里抛异常，join之后再报错
+  std::atomic<bool> duplicate{false};
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; t++) {
+    size_t begin = page_ids.size() * t / num_threads;
+    size_t end = page_ids.size() * (t + 1) / num_threads;
+    threads.emplace_back([&, begin, end] {
+      std::vector<Tuple> tuples;
+      for (size_t i = begin; i < end && !duplicate; i++) {
+        tuples.clear();
+        table_heap->GetPageTuples(page_ids[i], &tuples, transaction);
+        for (auto &tuple : tuples) {
+          KeyType index_key;
+          index_key.SetFromKey(tuple.KeyFromTuple(schema, *GetKeySchema(), GetKeyAttrs()));
+          bool inserted;
+          if constexpr (IndexValue<ValueType>::COVERING) {
+            Tuple included = tuple.KeyFromTuple(schema, *GetIncludedSchema(), GetIncludedAttrs());
+            inserted = container_.Insert(index_key, IndexValue<ValueType>::Make(tuple.GetRid(), &included), transaction);
+          } else {
+            inserted = container_.Insert(index_key, tuple.GetRid(), transaction);
+          }
+          if (!inserted) {
+            duplicate = true;
+            break;
+          }
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  if (duplicate) {
+    throw Exception(ExceptionType::INVALID, "duplicate key in unique index " + GetName());
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+IN_MEMORY_INDEXITERATOR_TYPE IN_MEMORY_BPLUSTREE_INDEX_TYPE::GetBeginIterator() { return container_.begin(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+IN_MEMORY_INDEXITERATOR_TYPE IN_MEMORY_BPLUSTREE_INDEX_TYPE::GetBeginIterator(const KeyType &key) {
+  return container_.Begin(key);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+IN_MEMORY_INDEXITERATOR_TYPE IN_MEMORY_BPLUSTREE_INDEX_TYPE::GetEndIterator() { return container_.end(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+IN_MEMORY_INDEXITERATOR_TYPE IN_MEMORY_BPLUSTREE_INDEX_TYPE::GetBeginIterator(const KeyType &lo, const KeyType &hi) {
+  return container_.Begin(lo, hi);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+IN_MEMORY_INDEXITERATOR_TYPE IN_MEMORY_BPLUSTREE_INDEX_TYPE::GetReverseBeginIterator() { return container_.RBegin(); }
+
+template class InMemoryBPlusTreeIndex<GenericKey<4>, RID, GenericComparator<4>>;
+template class InMemoryBPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>>;
+template class InMemoryBPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
+template class InMemoryBPlusTreeIndex<GenericKey<32>, RID, GenericComparator<32>>;
+template class InMemoryBPlusTreeIndex<GenericKey<64>, RID, GenericComparator<64>>;
+
+template class InMemoryBPlusTreeIndex<GenericKey<8>, RID, GenericIntegerComparator<8>>;
+
+template class InMemoryBPlusTreeIndex<GenericKey<8>, CoveringValue<16>, GenericComparator<8>>;
+template class InMemoryBPlusTreeIndex<GenericKey<16>, CoveringValue<32>, GenericComparator<16>>;
+
+}  // namespace bustub
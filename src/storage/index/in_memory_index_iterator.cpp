@@ -0,0 +1,201 @@
+/**
+ * in_memory_index_iterator.cpp
+ */
+#include <algorithm>
+
+#include "storage/index/covering_value.h"
+#include "storage/index/in_memory_b_plus_tree.h"
+#include "storage/index/in_memory_index_iterator.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+IN_MEMORY_INDEXITERATOR_TYPE::InMemoryIndexIterator(const KeyComparator *comparator, const KeyType *stopKey,
+                                                    bool reverse)
+    : comparator(comparator),
+      leaf(nullptr),
+      prev(nullptr),
+      next(nullptr),
+      curIndex(0),
+      stopKey(),
+      hasStopKey(stopKey != nullptr),
+      reverse(reverse) {
+  if (hasStopKey) {
+    this->stopKey = *stopKey;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void IN_MEMORY_INDEXITERATOR_TYPE::Snapshot(LeafNode *leaf, std::vector<MappingType> *entries, LeafNode **prev,
+                                            LeafNode **next) {
+  while (true) {
+    bool restart = false;
+    uint64_t version = leaf->ReadLockOrRestart(&restart);
+    if (restart) {
+      continue;
+    }
+    int size = std::min(std::max(0, leaf->size_), leaf->max_size_);
+    entries->assign(leaf->array_, leaf->array_ + size);
+    *prev = leaf->prev_;
+    *next = leaf->next_;
+    leaf->CheckOrRestart(version, &restart);
+    if (!restart) {
+      return;
+    }
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void IN_MEMORY_INDEXITERATOR_TYPE::Load(LeafNode *leaf) {
+  this->leaf = leaf;
+  Snapshot(leaf, &entries, &prev, &next);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int IN_MEMORY_INDEXITERATOR_TYPE::CountBelow(const KeyType &key, bool inclusive) const {
+  auto less = [this](const MappingType &pair, const KeyType &k) { return (*comparator)(pair.first, k) < 0; };
+  auto less_equal = [this](const KeyType &k, const MappingType &pair) { return (*comparator)(k, pair.first) < 0; };
+  if (inclusive) {
+    return static_cast<int>(std::upper_bound(entries.begin(), entries.end(), key, less_equal) - entries.begin());
+  }
+  return static_cast<int>(std::lower_bound(entries.begin(), entries.end(), key, less) - entries.begin());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void IN_MEMORY_INDEXITERATOR_TYPE::SeekFirst(LeafNode *leaf) {
+  Load(leaf);
+  curIndex = 0;
+  Settle();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void IN_MEMORY_INDEXITERATOR_TYPE::SeekLowerBound(LeafNode *leaf, const KeyType &key) {
+  Load(leaf);
+  curIndex = CountBelow(key, false);
+  Settle();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void IN_MEMORY_INDEXITERATOR_TYPE::SeekLast(LeafNode *leaf) {
+  Load(leaf);
+  //找到的最右leaf之后可能又分裂出了新的leaf
+  while (next != nullptr) {
+    Load(next);
+  }
+  curIndex = static_cast<int>(entries.size()) - 1;
+  Settle();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void IN_MEMORY_INDEXITERATOR_TYPE::SeekReverse(LeafNode *leaf, const KeyType &key, bool inclusive) {
+  Load(leaf);
+  // the leaf may have been split after the descent, the entries before key can continue in the right neighbours
+  std::vector<MappingType> next_entries;
+  while (CountBelow(key, inclusive) == static_cast<int>(entries.size()) && next != nullptr) {
+    LeafNode *next_prev;
+    LeafNode *next_next;
+    Snapshot(next, &next_entries, &next_prev, &next_next);
+    int cmp = next_entries.empty() ? -1 : (*comparator)(next_entries[0].first, key);
+    if (cmp > 0 || (cmp == 0 && !inclusive)) {
+      break;
+    }
+    this->leaf = next;
+    entries.swap(next_entries);
+    prev = next_prev;
+    next = next_next;
+  }
+  curIndex = CountBelow(key, inclusive) - 1;
+  Settle();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void IN_MEMORY_INDEXITERATOR_TYPE::MoveToPrev() {
+  LeafNode *cur = leaf;
+  Load(prev);
+  while (next != cur && next != nullptr) {
+    Load(next);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void IN_MEMORY_INDEXITERATOR_TYPE::Settle() {
+  if (!reverse) {
+    while (curIndex >= static_cast<int>(entries.size())) {
+      if (next == nullptr) {
+        leaf = nullptr;
+        return;
+      }
+      Load(next);
+      curIndex = 0;
+    }
+    if (hasStopKey && (*comparator)(entries[curIndex].first, stopKey) >= 0) {
+      leaf = nullptr;
+    }
+    return;
+  }
+  while (curIndex < 0) {
+    if (prev == nullptr) {
+      leaf = nullptr;
+      return;
+    }
+    MoveToPrev();
+    curIndex = static_cast<int>(entries.size()) - 1;
+  }
+  if (hasStopKey && (*comparator)(entries[curIndex].first, stopKey) < 0) {
+    leaf = nullptr;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool IN_MEMORY_INDEXITERATOR_TYPE::isEnd() const { return leaf == nullptr; }
+
+INDEX_TEMPLATE_ARGUMENTS
+const MappingType &IN_MEMORY_INDEXITERATOR_TYPE::operator*() { return entries[curIndex]; }
+
+INDEX_TEMPLATE_ARGUMENTS
+IN_MEMORY_INDEXITERATOR_TYPE &IN_MEMORY_INDEXITERATOR_TYPE::operator++() {
+  curIndex += reverse ? -1 : 1;
+  Settle();
+  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int IN_MEMORY_INDEXITERATOR_TYPE::NextBatch(std::vector<MappingType> *out, int max) {
+  out->clear();
+  while (!isEnd() && static_cast<int>(out->size()) < max) {
+    out->push_back(entries[curIndex]);
+    ++(*this);
+  }
+  return static_cast<int>(out->size());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool IN_MEMORY_INDEXITERATOR_TYPE::operator==(const InMemoryIndexIterator &itr) const {
+  if (isEnd() && itr.isEnd()) {
+    return true;
+  }
+  return leaf == itr.leaf && curIndex == itr.curIndex;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool IN_MEMORY_INDEXITERATOR_TYPE::operator!=(const InMemoryIndexIterator &itr) const {
+  return !(*this == itr);
+}
+
+template class InMemoryIndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
+
+template class InMemoryIndexIterator<GenericKey<8>, RID, GenericComparator<8>>;
+
+template class InMemoryIndexIterator<GenericKey<16>, RID, GenericComparator<16>>;
+
+template class InMemoryIndexIterator<GenericKey<32>, RID, GenericComparator<32>>;
+
+template class InMemoryIndexIterator<GenericKey<64>, RID, GenericComparator<64>>;
+
+template class InMemoryIndexIterator<GenericKey<8>, RID, GenericIntegerComparator<8>>;
+
+template class InMemoryIndexIterator<GenericKey<8>, CoveringValue<16>, GenericComparator<8>>;
+
+template class InMemoryIndexIterator<GenericKey<16>, CoveringValue<32>, GenericComparator<16>>;
+
+}  // namespace bustub
@@ -1,9 +1,11 @@
 /**
  * index_iterator.cpp
  */
+#include <algorithm>
 #include <cassert>
 
 #include "common/logger.h"
+#include "storage/index/covering_value.h"
 #include "storage/index/index_iterator.h"
 
 namespace bustub {
@@ -18,22 +20,79 @@ namespace bustub {
 ////泛型方法
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *b, IndexIterator::LeafPage *leafNode,
-                                                                int index) {
-  bufferPoolManager = b;
-  this->leafNode = leafNode;
-  this->curIndex = index;
+                                                                int index)
+    : IndexIterator(b, leafNode, index, nullptr, nullptr, false) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *b, LeafPage *leafNode, int index,
+                                  const KeyComparator *comparator, const KeyType *stopKey, bool reverse)
+    : leafNode(leafNode),
+      curIndex(index),
+      bufferPoolManager(b),
+      comparator(comparator),
+      stopKey(),
+      hasStopKey(stopKey != nullptr),
+      reverse(reverse) {
+  if (hasStopKey) {
+    this->stopKey = *stopKey;
+  }
+  //起始位置可能落在本页之外（比如key大于本页所有key），先移动到相邻的leaf
+  if (leafNode != nullptr) {
+    MoveToSibling();
+  }
 }
+
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::~IndexIterator(){
-//  if (leafNode!= nullptr){
-    bufferPoolManager->UnpinPage(leafNode->GetPageId(),false);
-//    leafNode = nullptr;
-//  }
-};
+bool INDEXITERATOR_TYPE::PastStopKey(int index) const {
+  if (!hasStopKey) {
+    return false;
+  }
+  int cmp = (*comparator)(leafNode->KeyAt(index), stopKey);
+  return reverse ? cmp < 0 : cmp >= 0;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::MoveToSibling() {
+  if (!reverse) {
+    while (curIndex >= leafNode->GetSize() && leafNode->GetNextPageId() != INVALID_PAGE_ID) {
+      if (leafNode->GetSize() > 0 && PastStopKey(leafNode->GetSize() - 1)) {
+        //本页最后一个key已经越界，后面的leaf不用读了
+        return;
+      }
+      //先释放当前leaf的pin，再拉取下一页
+      page_id_t nextPageId = leafNode->GetNextPageId();
+      bufferPoolManager->UnpinPage(leafNode->GetPageId(), false);
+      leafNode = reinterpret_cast<LeafPage *>(bufferPoolManager->FetchPage(nextPageId)->GetData());
+      curIndex = 0;
+    }
+    return;
+  }
+  while (curIndex < 0 && leafNode->GetPrevPageId() != INVALID_PAGE_ID) {
+    if (leafNode->GetSize() > 0 && PastStopKey(0)) {
+      return;
+    }
+    page_id_t prevPageId = leafNode->GetPrevPageId();
+    bufferPoolManager->UnpinPage(leafNode->GetPageId(), false);
+    leafNode = reinterpret_cast<LeafPage *>(bufferPoolManager->FetchPage(prevPageId)->GetData());
+    curIndex = leafNode->GetSize() - 1;
+  }
+}
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::~IndexIterator() {
+  //没有leaf的迭代器没有pin要释放
+  if (leafNode != nullptr) {
+    bufferPoolManager->UnpinPage(leafNode->GetPageId(), false);
+    leafNode = nullptr;
+  }
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-bool INDEXITERATOR_TYPE::isEnd() {
-  return leafNode->GetNextPageId() == INVALID_PAGE_ID && curIndex == leafNode->GetSize();
+bool INDEXITERATOR_TYPE::isEnd() const {
+  //MoveToSibling之后，位置仍在本页之外说明已经没有相邻leaf（或者相邻leaf已越界）
+  if (leafNode == nullptr || reverse ? curIndex < 0 : curIndex >= leafNode->GetSize()) {
+    return true;
+  }
+  return PastStopKey(curIndex);
 //  LOG_DEBUG("isEnd");
 //  return leafNode == nullptr;
 //  if (leafNode == nullptr){
@@ -58,16 +117,11 @@ const MappingType &INDEXITERATOR_TYPE::operator*() {
 
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
-  //相当于 iter.next();
-  curIndex++;
+  //相当于 iter.next();反向遍历时是iter.prev()
+  curIndex += reverse ? -1 : 1;
 //  LOG_DEBUG("curIndex:%d,leafNode.getSize():%d",curIndex,leafNode->GetSize());
-  if (curIndex == leafNode->GetSize() && leafNode->GetNextPageId()!=INVALID_PAGE_ID){
-          //拉去新的leafPage
-          Page *p = bufferPoolManager->FetchPage(leafNode->GetNextPageId());
-          bufferPoolManager->UnpinPage(leafNode->GetPageId(), false);
-          leafNode = reinterpret_cast<LeafPage *>(p->GetData());
-          curIndex = 0;
-  }
+  //越过本页边界时拉取相邻的leafPage
+  MoveToSibling();
   return *this;
   //  if (curIndex >= leafNode->GetSize()){
 //    //这一页最后一个元素就是getSize-1对应下标的元素，所以到这里说明这一页已经遍历结束
@@ -85,8 +139,41 @@ INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
 //  }
   return *this;
 }
+INDEX_TEMPLATE_ARGUMENTS
+int INDEXITERATOR_TYPE::NextBatch(std::vector<MappingType> *out, int max) {
+  out->clear();
+  while (static_cast<int>(out->size()) < max && !isEnd()) {
+    int want = max - static_cast<int>(out->size());
+    //本页从curIndex开始的一段连续pair，受max和stopKey限制，整段拷贝
+    if (!reverse) {
+      int end = std::min(leafNode->GetSize(), curIndex + want);
+      if (hasStopKey) {
+        end = std::min(end, leafNode->KeyIndex(stopKey, *comparator));
+      }
+      const MappingType *run = &leafNode->GetItem(curIndex);
+      out->insert(out->end(), run, run + (end - curIndex));
+      curIndex = end;
+    } else {
+      int begin = std::max(0, curIndex - want + 1);
+      if (hasStopKey) {
+        begin = std::max(begin, leafNode->KeyIndex(stopKey, *comparator));
+      }
+      for (int i = curIndex; i >= begin; i--) {
+        out->push_back(leafNode->GetItem(i));
+      }
+      curIndex = begin - 1;
+    }
+    MoveToSibling();
+  }
+  return static_cast<int>(out->size());
+}
+
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool IndexIterator<KeyType, ValueType, KeyComparator>::operator==(const IndexIterator &itr) const {
+  if (isEnd() && itr.isEnd()) {
+    //已结束的迭代器都相等，有界/反向迭代器也可以和end()比较
+    return true;
+  }
   return leafNode->GetPageId() == itr.leafNode->GetPageId() && curIndex == itr.curIndex;  // leaf page和index均相同
 }
 
@@ -107,4 +194,10 @@ template class IndexIterator<GenericKey<32>, RID, GenericComparator<32>>;
 
 template class IndexIterator<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class IndexIterator<GenericKey<8>, RID, GenericIntegerComparator<8>>;
+
+template class IndexIterator<GenericKey<8>, CoveringValue<16>, GenericComparator<8>>;
+
+template class IndexIterator<GenericKey<16>, CoveringValue<32>, GenericComparator<16>>;
+
 }  // namespace bustub
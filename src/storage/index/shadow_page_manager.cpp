@@ -0,0 +1,202 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// shadow_page_manager.cpp
+//
+// Identification: src/storage/index/shadow_page_manager.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/shadow_page_manager.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+ShadowPageManager::ShadowPageManager(BufferPoolManager *buffer_pool_manager)
+    : buffer_pool_manager_(buffer_pool_manager) {}
+
+ShadowPageManager::~ShadowPageManager() {
+  std::lock_guard<std::mutex> lock(latch_);
+  snapshots_.clear();
+  num_snapshots_ = 0;
+  Reclaim();
+}
+
+void ShadowPageManager::EndWrite() {
+  shadowed_.clear();
+  write_latch_.unlock();
+}
+
+/*
+ * Only the writer changes pages, so the before-image is copied without
+ * latching the page. The page is write latched just to publish the shadow: a
+ * reader that found no shadow for it has either copied it already, or sees the
+ * shadow when it checks again under the read latch. Once published, every open
+ * snapshot resolves to a shadow and no reader looks at the page any more, so
+ * the writer changes it without a latch.
+ */
+void ShadowPageManager::BeforeWrite(page_id_t page_id) {
+  if (!HasSnapshots() || !shadowed_.insert(page_id).second) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(latch_);
+    if (snapshots_.empty()) {
+      return;
+    }
+    //已有的最新shadow比所有打开的snapshot都新：每个snapshot都已经有自己的版本
+    auto iter = versions_.find(page_id);
+    if (iter != versions_.end() && iter->second.back().first > snapshots_.rbegin()->first) {
+      return;
+    }
+  }
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no frame left for a shadowed page");
+  }
+  page_id_t shadow_id;
+  Page *shadow = buffer_pool_manager_->NewPage(&shadow_id);
+  if (shadow == nullptr) {
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no frame left for a shadow page");
+  }
+  memcpy(shadow->GetData(), page->GetData(), PAGE_SIZE);
+  buffer_pool_manager_->UnpinPage(shadow_id, true);
+
+  bool published = false;
+  page->WLatch();
+  {
+    std::lock_guard<std::mutex> lock(latch_);
+    //拷贝期间snapshot可能都被释放了，那就不需要这个shadow
+    if (!snapshots_.empty()) {
+      versions_[page_id].emplace_back(epoch_, shadow_id);
+      retired_.push_back(Retired{epoch_, page_id, true});
+      published = true;
+    }
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  if (!published) {
+    buffer_pool_manager_->DeletePage(shadow_id);
+  }
+}
+
+void ShadowPageManager::DropPage(page_id_t page_id) {
+  BeforeWrite(page_id);
+  {
+    std::lock_guard<std::mutex> lock(latch_);
+    if (!snapshots_.empty()) {
+      //旧snapshot的reader可能正pin着这一页，等它们都结束再删
+      retired_.push_back(Retired{epoch_, page_id, false});
+      return;
+    }
+  }
+  buffer_pool_manager_->DeletePage(page_id);
+}
+
+uint64_t ShadowPageManager::TakeSnapshot(page_id_t root) {
+  std::lock_guard<std::mutex> lock(latch_);
+  uint64_t snapshot = epoch_++;
+  snapshots_.emplace(snapshot, root);
+  num_snapshots_ = snapshots_.size();
+  return snapshot;
+}
+
+void ShadowPageManager::ReleaseSnapshot(uint64_t snapshot) {
+  std::lock_guard<std::mutex> lock(latch_);
+  snapshots_.erase(snapshot);
+  num_snapshots_ = snapshots_.size();
+  Reclaim();
+}
+
+page_id_t ShadowPageManager::GetRootPageId(uint64_t snapshot) {
+  std::lock_guard<std::mutex> lock(latch_);
+  auto iter = snapshots_.find(snapshot);
+  BUSTUB_ASSERT(iter != snapshots_.end(), "snapshot is not open");
+  return iter->second;
+}
+
+/*
+ * A live page is copied under its read latch, after checking again that it
+ * still has no shadow for this snapshot. The writer publishes shadows under
+ * the write latch of the page and changes the page only afterwards, so the
+ * copy cannot hold its changes; if a shadow showed up in between, it is read
+ * instead.
+ */
+void ShadowPageManager::ReadPage(uint64_t snapshot, page_id_t page_id, char *out) {
+  while (true) {
+    page_id_t source;
+    {
+      std::lock_guard<std::mutex> lock(latch_);
+      source = Resolve(snapshot, page_id);
+    }
+    Page *page = buffer_pool_manager_->FetchPage(source);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "no frame left for a snapshot read");
+    }
+    if (source != page_id) {
+      // shadow不会再被修改，不需要latch
+      memcpy(out, page->GetData(), PAGE_SIZE);
+      buffer_pool_manager_->UnpinPage(source, false);
+      return;
+    }
+    page->RLatch();
+    bool unchanged;
+    {
+      std::lock_guard<std::mutex> lock(latch_);
+      unchanged = Resolve(snapshot, page_id) == page_id;
+    }
+    if (unchanged) {
+      memcpy(out, page->GetData(), PAGE_SIZE);
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(source, false);
+    if (unchanged) {
+      return;
+    }
+  }
+}
+
+size_t ShadowPageManager::GetShadowCount() {
+  std::lock_guard<std::mutex> lock(latch_);
+  return std::count_if(retired_.begin(), retired_.end(), [](const Retired &retired) { return retired.shadow_; });
+}
+
+page_id_t ShadowPageManager::Resolve(uint64_t snapshot, page_id_t page_id) const {
+  auto iter = versions_.find(page_id);
+  if (iter == versions_.end()) {
+    return page_id;
+  }
+  //第一个在snapshot之后拍下的shadow，就是这一页在snapshot时的内容
+  auto version = std::upper_bound(
+      iter->second.begin(), iter->second.end(), snapshot,
+      [](uint64_t epoch, const std::pair<uint64_t, page_id_t> &entry) { return epoch < entry.first; });
+  return version == iter->second.end() ? page_id : version->second;
+}
+
+void ShadowPageManager::Reclaim() {
+  uint64_t oldest = snapshots_.empty() ? std::numeric_limits<uint64_t>::max() : snapshots_.begin()->first;
+  while (!retired_.empty() && retired_.front().epoch_ <= oldest) {
+    const Retired &retired = retired_.front();
+    if (retired.shadow_) {
+      //同一页的shadow按epoch先后进入retired_，最早的一个就在deque头部
+      auto iter = versions_.find(retired.page_id_);
+      buffer_pool_manager_->DeletePage(iter->second.front().second);
+      iter->second.pop_front();
+      if (iter->second.empty()) {
+        versions_.erase(iter);
+      }
+    } else {
+      buffer_pool_manager_->DeletePage(retired.page_id_);
+    }
+    retired_.pop_front();
+  }
+}
+
+}  // namespace bustub
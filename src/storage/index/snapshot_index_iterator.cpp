@@ -0,0 +1,99 @@
+/**
+ * snapshot_index_iterator.cpp
+ */
+#include <algorithm>
+#include <utility>
+
+#include "storage/index/covering_value.h"
+#include "storage/index/generic_key.h"
+#include "storage/index/snapshot_index_iterator.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+SNAPSHOT_INDEXITERATOR_TYPE::SnapshotIndexIterator(ShadowPageManager *shadow, uint64_t snapshot,
+                                                   std::unique_ptr<char[]> leaf, int index,
+                                                   const KeyComparator *comparator, const KeyType *stopKey)
+    : shadow_(shadow),
+      snapshot_(snapshot),
+      buffer_(std::move(leaf)),
+      index_(index),
+      comparator_(comparator),
+      stop_key_(),
+      has_stop_key_(stopKey != nullptr) {
+  if (has_stop_key_) {
+    stop_key_ = *stopKey;
+  }
+  Settle();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool SNAPSHOT_INDEXITERATOR_TYPE::isEnd() const { return buffer_ == nullptr; }
+
+INDEX_TEMPLATE_ARGUMENTS
+const MappingType &SNAPSHOT_INDEXITERATOR_TYPE::operator*() {
+  return reinterpret_cast<LeafPage *>(buffer_.get())->GetItem(index_);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+SNAPSHOT_INDEXITERATOR_TYPE &SNAPSHOT_INDEXITERATOR_TYPE::operator++() {
+  index_++;
+  Settle();
+  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int SNAPSHOT_INDEXITERATOR_TYPE::NextBatch(std::vector<MappingType> *out, int max) {
+  out->clear();
+  while (static_cast<int>(out->size()) < max && !isEnd()) {
+    auto *leaf = reinterpret_cast<LeafPage *>(buffer_.get());
+    int end = std::min(leaf->GetSize(), index_ + max - static_cast<int>(out->size()));
+    if (has_stop_key_) {
+      end = std::min(end, leaf->KeyIndex(stop_key_, *comparator_));
+    }
+    const MappingType *run = &leaf->GetItem(index_);
+    out->insert(out->end(), run, run + (end - index_));
+    index_ = end;
+    Settle();
+  }
+  return static_cast<int>(out->size());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void SNAPSHOT_INDEXITERATOR_TYPE::Settle() {
+  while (buffer_ != nullptr) {
+    auto *leaf = reinterpret_cast<LeafPage *>(buffer_.get());
+    if (index_ < leaf->GetSize()) {
+      if (has_stop_key_ && (*comparator_)(leaf->KeyAt(index_), stop_key_) >= 0) {
+        buffer_.reset();
+      }
+      return;
+    }
+    //本页读完，按snapshot中的next指针把下一页拷贝进同一块buffer
+    page_id_t next_page_id = leaf->GetNextPageId();
+    if (next_page_id == INVALID_PAGE_ID) {
+      buffer_.reset();
+      return;
+    }
+    shadow_->ReadPage(snapshot_, next_page_id, buffer_.get());
+    index_ = 0;
+  }
+}
+
+template class SnapshotIndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
+
+template class SnapshotIndexIterator<GenericKey<8>, RID, GenericComparator<8>>;
+
+template class SnapshotIndexIterator<GenericKey<16>, RID, GenericComparator<16>>;
+
+template class SnapshotIndexIterator<GenericKey<32>, RID, GenericComparator<32>>;
+
+template class SnapshotIndexIterator<GenericKey<64>, RID, GenericComparator<64>>;
+
+template class SnapshotIndexIterator<GenericKey<8>, RID, GenericIntegerComparator<8>>;
+
+template class SnapshotIndexIterator<GenericKey<8>, CoveringValue<16>, GenericComparator<8>>;
+
+template class SnapshotIndexIterator<GenericKey<16>, CoveringValue<32>, GenericComparator<16>>;
+
+}  // namespace bustub
@@ -0,0 +1,249 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// varlen_b_plus_tree.cpp
+//
+// Identification: src/storage/index/varlen_b_plus_tree.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <utility>
+
+#include "common/exception.h"
+#include "storage/index/varlen_b_plus_tree.h"
+#include "storage/page/header_page.h"
+
+namespace bustub {
+
+VarlenBPlusTree::VarlenBPlusTree(std::string name, BufferPoolManager *buffer_pool_manager)
+    : index_name_(std::move(name)), buffer_pool_manager_(buffer_pool_manager) {}
+
+std::string VarlenBPlusTree::EntryKey(std::string_view key, const RID &rid) {
+  std::string entry_key(key);
+  // 翻转符号位再按大端序写入，memcmp的顺序就是RID的顺序
+  auto value = static_cast<uint64_t>(rid.Get()) ^ (uint64_t{1} << 63);
+  for (int shift = 56; shift >= 0; shift -= 8) {
+    entry_key.push_back(static_cast<char>((value >> shift) & 0xff));
+  }
+  return entry_key;
+}
+
+Page *VarlenBPlusTree::NewPage(page_id_t *page_id) {
+  Page *page = buffer_pool_manager_->NewPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame for a page of index " + index_name_);
+  }
+  return page;
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+void VarlenBPlusTree::FindLeafPath(std::string_view key, std::vector<page_id_t> *path) {
+  path->clear();
+  page_id_t page_id = root_page_id_;
+  while (true) {
+    path->push_back(page_id);
+    auto *page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    if (page->IsLeafPage()) {
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      return;
+    }
+    page_id_t child = reinterpret_cast<InternalPage *>(page)->LookupChild(key);
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = child;
+  }
+}
+
+void VarlenBPlusTree::GetValue(std::string_view key, std::vector<RID> *result) {
+  latch_.RLock();
+  GetValueLocked(key, result, false);
+  latch_.RUnlock();
+}
+
+/*
+ * The entries of key are the run of entries that start with key, they begin in
+ * the leaf key belongs to or in one of the leaves after it.
+ */
+void VarlenBPlusTree::GetValueLocked(std::string_view key, std::vector<RID> *result, bool first_only) {
+  if (IsEmpty()) {
+    return;
+  }
+  std::vector<page_id_t> path;
+  FindLeafPath(key, &path);
+  page_id_t page_id = path.back();
+  bool first_leaf = true;
+  while (page_id != INVALID_PAGE_ID) {
+    auto *leaf = reinterpret_cast<LeafPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    for (int i = first_leaf ? leaf->KeyIndex(key) : 0; i < leaf->GetSize(); i++) {
+      std::string entry_key = leaf->KeyAt(i);
+      if (entry_key.compare(0, key.size(), key) != 0) {
+        buffer_pool_manager_->UnpinPage(page_id, false);
+        return;
+      }
+      if (entry_key.size() == key.size() + sizeof(int64_t)) {
+        result->push_back(leaf->ValueAt(i));
+        if (first_only) {
+          buffer_pool_manager_->UnpinPage(page_id, false);
+          return;
+        }
+      }
+    }
+    page_id_t next_page_id = leaf->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+    first_leaf = false;
+  }
+}
+
+int VarlenBPlusTree::GetHeight() {
+  latch_.RLock();
+  int height = 0;
+  if (!IsEmpty()) {
+    std::vector<page_id_t> path;
+    FindLeafPath(std::string_view(), &path);
+    height = static_cast<int>(path.size());
+  }
+  latch_.RUnlock();
+  return height;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+bool VarlenBPlusTree::Insert(std::string_view key, const RID &rid) {
+  if (key.size() > MAX_KEY_SIZE) {
+    throw Exception(ExceptionType::OUT_OF_RANGE,
+                    "key of " + std::to_string(key.size()) + " bytes is too long for index " + index_name_);
+  }
+  latch_.WLock();
+  if (unique_keys_) {
+    std::vector<RID> existing;
+    GetValueLocked(key, &existing, true);
+    if (!existing.empty()) {
+      latch_.WUnlock();
+      return false;
+    }
+  }
+  std::string entry_key = EntryKey(key, rid);
+  if (IsEmpty()) {
+    StartNewTree(entry_key, rid);
+    latch_.WUnlock();
+    return true;
+  }
+
+  std::vector<page_id_t> path;
+  FindLeafPath(entry_key, &path);
+  page_id_t leaf_id = path.back();
+  auto *leaf = reinterpret_cast<LeafPage *>(buffer_pool_manager_->FetchPage(leaf_id)->GetData());
+  if (leaf->Insert(entry_key, rid)) {
+    buffer_pool_manager_->UnpinPage(leaf_id, true);
+    latch_.WUnlock();
+    return true;
+  }
+
+  //放不下：按字节对半分裂，再插入到所属的一半
+  page_id_t new_leaf_id;
+  auto *new_leaf = reinterpret_cast<LeafPage *>(NewPage(&new_leaf_id)->GetData());
+  new_leaf->Init(new_leaf_id);
+  leaf->MoveHalfTo(new_leaf);
+  new_leaf->SetNextPageId(leaf->GetNextPageId());
+  leaf->SetNextPageId(new_leaf_id);
+  LeafPage *target = entry_key < new_leaf->KeyAt(0) ? leaf : new_leaf;
+  //MAX_KEY_SIZE保证半页一定放得下
+  target->Insert(entry_key, rid);
+  std::string separator = LeafPage::ShortestSeparator(leaf->KeyAt(leaf->GetSize() - 1), new_leaf->KeyAt(0));
+  buffer_pool_manager_->UnpinPage(leaf_id, true);
+  buffer_pool_manager_->UnpinPage(new_leaf_id, true);
+  InsertIntoParent(path, path.size() - 1, separator, new_leaf_id);
+  latch_.WUnlock();
+  return true;
+}
+
+void VarlenBPlusTree::StartNewTree(std::string_view entry_key, const RID &rid) {
+  page_id_t page_id;
+  auto *leaf = reinterpret_cast<LeafPage *>(NewPage(&page_id)->GetData());
+  leaf->Init(page_id);
+  leaf->Insert(entry_key, rid);
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  root_page_id_ = page_id;
+  UpdateRootPageId(true);
+}
+
+/*
+ * An internal page that is full splits as well. The first key of the right
+ * half, which becomes its invalid key, moves up to the parent.
+ */
+void VarlenBPlusTree::InsertIntoParent(const std::vector<page_id_t> &path, size_t level, const std::string &separator,
+                                       page_id_t right_page_id) {
+  if (level == 0) {
+    page_id_t root_id;
+    auto *root = reinterpret_cast<InternalPage *>(NewPage(&root_id)->GetData());
+    root->Init(root_id, INVALID_PAGE_ID, IndexPageType::INTERNAL_PAGE);
+    root->PopulateNewRoot(path[0], separator, right_page_id);
+    buffer_pool_manager_->UnpinPage(root_id, true);
+    root_page_id_ = root_id;
+    UpdateRootPageId(false);
+    return;
+  }
+
+  page_id_t parent_id = path[level - 1];
+  auto *parent = reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(parent_id)->GetData());
+  if (parent->Insert(separator, right_page_id)) {
+    buffer_pool_manager_->UnpinPage(parent_id, true);
+    return;
+  }
+  page_id_t new_parent_id;
+  auto *new_parent = reinterpret_cast<InternalPage *>(NewPage(&new_parent_id)->GetData());
+  new_parent->Init(new_parent_id, INVALID_PAGE_ID, IndexPageType::INTERNAL_PAGE);
+  parent->MoveHalfTo(new_parent);
+  std::string middle = new_parent->KeyAt(0);
+  InternalPage *target = separator < middle ? parent : new_parent;
+  target->Insert(separator, right_page_id);
+  buffer_pool_manager_->UnpinPage(parent_id, true);
+  buffer_pool_manager_->UnpinPage(new_parent_id, true);
+  InsertIntoParent(path, level - 1, middle, new_parent_id);
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+bool VarlenBPlusTree::Remove(std::string_view key, const RID &rid) {
+  latch_.WLock();
+  if (IsEmpty()) {
+    latch_.WUnlock();
+    return false;
+  }
+  std::string entry_key = EntryKey(key, rid);
+  std::vector<page_id_t> path;
+  FindLeafPath(entry_key, &path);
+  auto *leaf = reinterpret_cast<LeafPage *>(buffer_pool_manager_->FetchPage(path.back())->GetData());
+  int index = leaf->KeyIndex(entry_key);
+  bool found = index < leaf->GetSize() && leaf->KeyAt(index) == entry_key;
+  if (found) {
+    leaf->Remove(index);
+  }
+  buffer_pool_manager_->UnpinPage(path.back(), found);
+  latch_.WUnlock();
+  return found;
+}
+
+/*****************************************************************************
+ * UTILITIES
+ *****************************************************************************/
+/*
+ * Update/Insert root page id in header page(where page_id = 0, header_page is
+ * defined under include/page/header_page.h)
+ */
+void VarlenBPlusTree::UpdateRootPageId(bool insert_record) {
+  auto *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
+  if (insert_record) {
+    header_page->InsertRecord(index_name_, root_page_id_);
+  } else {
+    header_page->UpdateRecord(index_name_, root_page_id_);
+  }
+  buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
+}
+
+}  // namespace bustub
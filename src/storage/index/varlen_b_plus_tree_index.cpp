@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// varlen_b_plus_tree_index.cpp
+//
+// Identification: src/storage/index/varlen_b_plus_tree_index.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstring>
+
+#include "common/exception.h"
+#include "storage/index/varlen_b_plus_tree_index.h"
+
+namespace bustub {
+
+VarlenBPlusTreeIndex::VarlenBPlusTreeIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager)
+    : Index(metadata), container_(metadata->GetName(), buffer_pool_manager) {
+  container_.SetUniqueKeys(metadata->IsUnique());
+}
+
+void VarlenBPlusTreeIndex::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  container_.Insert(EncodeKey(key, *GetKeySchema()), rid);
+}
+
+void VarlenBPlusTreeIndex::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  container_.Remove(EncodeKey(key, *GetKeySchema()), rid);
+}
+
+void VarlenBPlusTreeIndex::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  container_.GetValue(EncodeKey(key, *GetKeySchema()), result);
+}
+
+void VarlenBPlusTreeIndex::BuildFromTable(TableHeap *table_heap, const Schema &schema, Transaction *transaction) {
+  std::vector<Tuple> tuples;
+  for (page_id_t page_id : table_heap->GetPageIds()) {
+    tuples.clear();
+    table_heap->GetPageTuples(page_id, &tuples, transaction);
+    for (auto &tuple : tuples) {
+      Tuple key = tuple.KeyFromTuple(schema, *GetKeySchema(), GetKeyAttrs());
+      if (!container_.Insert(EncodeKey(key, *GetKeySchema()), tuple.GetRid())) {
+        throw Exception(ExceptionType::INVALID, "duplicate key in unique index " + GetName());
+      }
+    }
+  }
+}
+
+// 大端序写入，memcmp的顺序就是无符号整数的顺序
+static void AppendBigEndian(uint64_t value, size_t size, std::string *out) {
+  for (int shift = static_cast<int>(size - 1) * 8; shift >= 0; shift -= 8) {
+    out->push_back(static_cast<char>((value >> shift) & 0xff));
+  }
+}
+
+std::string VarlenBPlusTreeIndex::EncodeKey(const Tuple &key, const Schema &key_schema) {
+  std::string encoded;
+  for (uint32_t i = 0; i < key_schema.GetColumnCount(); i++) {
+    Value value = key.GetValue(&key_schema, i);
+    // null排在所有值前面
+    if (value.IsNull()) {
+      encoded.push_back('\0');
+      continue;
+    }
+    encoded.push_back('\1');
+    switch (value.GetTypeId()) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        AppendBigEndian(static_cast<uint8_t>(value.GetAs<int8_t>()) ^ 0x80U, 1, &encoded);
+        break;
+      case TypeId::SMALLINT:
+        AppendBigEndian(static_cast<uint16_t>(value.GetAs<int16_t>()) ^ 0x8000U, 2, &encoded);
+        break;
+      case TypeId::INTEGER:
+        AppendBigEndian(static_cast<uint32_t>(value.GetAs<int32_t>()) ^ 0x80000000U, 4, &encoded);
+        break;
+      case TypeId::BIGINT:
+        AppendBigEndian(static_cast<uint64_t>(value.GetAs<int64_t>()) ^ (uint64_t{1} << 63), 8, &encoded);
+        break;
+      case TypeId::TIMESTAMP:
+        AppendBigEndian(value.GetAs<uint64_t>(), 8, &encoded);
+        break;
+      case TypeId::DECIMAL: {
+        // 正数翻转符号位，负数翻转所有位
+        double decimal = value.GetAs<double>();
+        uint64_t bits;
+        memcpy(&bits, &decimal, sizeof(bits));
+        bits = (bits >> 63) != 0 ? ~bits : bits ^ (uint64_t{1} << 63);
+        AppendBigEndian(bits, 8, &encoded);
+        break;
+      }
+      case TypeId::VARCHAR: {
+        // 0字节转义成0xff前面加一个0，两个0结尾：短的字符串排在以它开头的长字符串前面
+        const char *data = value.GetData();
+        uint32_t length = value.GetLength() - 1;
+        for (uint32_t j = 0; j < length; j++) {
+          encoded.push_back(data[j]);
+          if (data[j] == '\0') {
+            encoded.push_back('\xff');
+          }
+        }
+        encoded.push_back('\0');
+        encoded.push_back('\0');
+        break;
+      }
+      default:
+        throw Exception(ExceptionType::UNKNOWN_TYPE,
+                        "cannot index a column of type " + Type::TypeIdToString(value.GetTypeId()));
+    }
+  }
+  return encoded;
+}
+
+}  // namespace bustub
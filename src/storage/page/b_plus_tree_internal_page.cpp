@@ -90,25 +90,21 @@ ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const {
 INDEX_TEMPLATE_ARGUMENTS
 ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const {
   //寻找给定的key在array中符合 K(i)<=key<K(i+1)的i，这个pair的value值就是key所在的internal/leaf page
-  //采用二分查找，
-//  assert(GetSize()>1);
-  int left = 1;
-  int right = GetSize()-1;
-  while (left <= right){
-    int mid = (left+right)/2;
-    if (comparator(KeyAt(mid),key) >0){
-      //mid大，目标在左侧区间
-      right = mid -1;
-    } else{
-      //注意，即使找到了，也令left右移；这样可以保证最终的查找结果是left位于比key大的一个数的下标，所以实际上寻找的key是left-1
-      left = mid +1;
-    }
-  }
-  int keyIndex = left -1 ;
-//  assert(comparator(KeyAt(keyIndex),key)<=0);
+  //第一个key无效，从下标1开始查找第一个大于key的位置，它的前一个就是目标
+  int keyIndex =
+      BPlusTreeKeySearch<KeyType, ValueType, KeyComparator>::UpperBound(array, 1, GetSize(), key, comparator) - 1;
   return ValueAt(keyIndex);
 }
 
+/*
+ * Same search as Lookup, but return the index, so that callers can also read
+ * the separator keys around the chosen child
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_INTERNAL_PAGE_TYPE::ChildIndex(const KeyType &key, const KeyComparator &comparator) const {
+  return BPlusTreeKeySearch<KeyType, ValueType, KeyComparator>::UpperBound(array, 1, GetSize(), key, comparator) - 1;
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -314,7 +310,8 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeInternalPage *re
   //2,左兄弟填充好的array[getSize]借给node
   //3,设置node的parentKey为新添加的array[0].key
   //tips：node的indexInParent=index
-    SetKeyAt(0,middle_key);
+    //middle_key填到recipient的invalidKey上，CopyFirstFrom后移一位后它就是array[1]的key
+    recipient->SetKeyAt(0,middle_key);
     recipient->CopyFirstFrom(array[GetSize()-1],buffer_pool_manager);
     IncreaseSize(-1);
 }
@@ -325,7 +322,7 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeInternalPage *re
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyFirstFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager) {
-  for (int i = GetSize(); i > 0 ; ++i) {
+  for (int i = GetSize(); i > 0 ; --i) {
     array[i] = array[i-1];
   }
   array[0] = pair;
@@ -343,10 +340,18 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyFirstFrom(const MappingType &pair, Buff
 
 }
 
-// valuetype for internalNode should be page id_t
-template class BPlusTreeInternalPage<GenericKey<4>, page_id_t, GenericComparator<4>>;
-template class BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>;
-template class BPlusTreeInternalPage<GenericKey<16>, page_id_t, GenericComparator<16>>;
-template class BPlusTreeInternalPage<GenericKey<32>, page_id_t, GenericComparator<32>>;
-template class BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+// valuetype for internalNode should be page id_t, keys are the separators of BPlusTree
+template class BPlusTreeInternalPage<SeparatorKey<GenericKey<4>>, page_id_t,
+                                     SeparatorComparator<GenericKey<4>, GenericComparator<4>>>;
+template class BPlusTreeInternalPage<SeparatorKey<GenericKey<8>>, page_id_t,
+                                     SeparatorComparator<GenericKey<8>, GenericComparator<8>>>;
+template class BPlusTreeInternalPage<SeparatorKey<GenericKey<16>>, page_id_t,
+                                     SeparatorComparator<GenericKey<16>, GenericComparator<16>>>;
+template class BPlusTreeInternalPage<SeparatorKey<GenericKey<32>>, page_id_t,
+                                     SeparatorComparator<GenericKey<32>, GenericComparator<32>>>;
+template class BPlusTreeInternalPage<SeparatorKey<GenericKey<64>>, page_id_t,
+                                     SeparatorComparator<GenericKey<64>, GenericComparator<64>>>;
+
+template class BPlusTreeInternalPage<SeparatorKey<GenericKey<8>>, page_id_t,
+                                     SeparatorComparator<GenericKey<8>, GenericIntegerComparator<8>>>;
 }  // namespace bustub
@@ -14,6 +14,7 @@
 #include "common/exception.h"
 #include "common/logger.h"
 #include "common/rid.h"
+#include "storage/index/covering_value.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 namespace bustub {
@@ -35,10 +36,11 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, in
     SetMaxSize(max_size);
     SetPageType(IndexPageType::LEAF_PAGE);
     SetNextPageId(INVALID_PAGE_ID);
+    SetPrevPageId(INVALID_PAGE_ID);
 }
 
 /**
- * Helper methods to set/get next page id
+ * Helper methods to set/get next/prev page id
  */
 INDEX_TEMPLATE_ARGUMENTS
 page_id_t B_PLUS_TREE_LEAF_PAGE_TYPE::GetNextPageId() const { return next_page_id_; }
@@ -48,6 +50,14 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {
   next_page_id_ = next_page_id;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t B_PLUS_TREE_LEAF_PAGE_TYPE::GetPrevPageId() const { return prev_page_id_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetPrevPageId(page_id_t prev_page_id) {
+  prev_page_id_ = prev_page_id;
+}
+
 /**
  * Helper method to find the first index i so that array[i].first >= key
  * NOTE: This method is only used when generating index iterator
@@ -56,18 +66,33 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const {
   assert(GetSize() >= 0);
-  int left = 0;//leaf node，所有pair都是有效的
-  int right = GetSize()-1;
-  while(left <= right){
-    int mid = (left+right)/2;
-    if (comparator(KeyAt(mid),key)>=0){
-      //mid更大，目标在左侧
-      right = mid -1;
-    }else{
-      left = mid+1;
+  //leaf node，所有pair都是有效的；整数key会在编译期选到SIMD版本的查找
+  return BPlusTreeKeySearch<KeyType, ValueType, KeyComparator>::LowerBound(array, 0, GetSize(), key, comparator);
+}
+
+/*
+ * KeyIndex, then a binary search on the RIDs inside the run of keys equal to
+ * key. This is the position of the pair in a tree with duplicate keys.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_LEAF_PAGE_TYPE::EntryIndex(const KeyType &key, const RID &rid, const KeyComparator &comparator) const {
+  using KeySearch = BPlusTreeKeySearch<KeyType, ValueType, KeyComparator>;
+  int lo = KeyIndex(key, comparator);
+  if (lo == GetSize() || comparator(array[lo].first, key) != 0) {
+    //没有相等的key，key唯一时总是这种情况
+    return lo;
+  }
+  int hi = KeySearch::UpperBound(array, lo, GetSize(), key, comparator);
+  int64_t target = rid.Get();
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (IndexValue<ValueType>::GetRid(array[mid].second).Get() < target) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
     }
   }
-  return right+1;//最终right指向的是小于key的最大键，right+1就是array[i].first >= key的第一个i
+  return lo;
 }
 
 /*
@@ -96,7 +121,7 @@ const MappingType &B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) {
  * INSERTION
  *****************************************************************************/
 /*
- * Insert key & value pair into leaf page ordered by key
+ * Insert key & value pair into leaf page ordered by key, equal keys by RID
  * @return  page size after insertion
  */
 INDEX_TEMPLATE_ARGUMENTS
@@ -109,8 +134,8 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &valu
   }
 
   //1，不需要判断是不是重复key，因为我们在调用Insert之前已经判断过是否重复，
-  // 并且这里KeyIndex产生的是>=key的第一个位置，可能已经是getSize位置
-  int index = KeyIndex(key, comparator);
+  // 并且这里产生的是>=key的第一个位置，可能已经是getSize位置；重复的key按RID排序
+  int index = EntryIndex(key, IndexValue<ValueType>::GetRid(value), comparator);
 
   //2,key不重复，说明index位置的key大于给定的key，从这里后移一位，插入
   for (int i = GetSize(); i > index ; --i) {
@@ -194,6 +219,20 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const
 
 }
 
+/*
+ * Delete the pair at input "index", used when keys are not unique and the
+ * caller has already located the exact key & value pair.
+ * @return   page size after deletion
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAt(int index) {
+  for (int i = index; i < GetSize() - 1; ++i) {
+    array[i] = array[i + 1];
+  }
+  IncreaseSize(-1);
+  return GetSize();
+}
+
 /*****************************************************************************
  * MERGE
  *****************************************************************************/
@@ -260,4 +299,9 @@ template class BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTreeLeafPage<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTreeLeafPage<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTreeLeafPage<GenericKey<64>, RID, GenericComparator<64>>;
+
+template class BPlusTreeLeafPage<GenericKey<8>, RID, GenericIntegerComparator<8>>;
+
+template class BPlusTreeLeafPage<GenericKey<8>, CoveringValue<16>, GenericComparator<8>>;
+template class BPlusTreeLeafPage<GenericKey<16>, CoveringValue<32>, GenericComparator<16>>;
 }  // namespace bustub
@@ -0,0 +1,381 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/page/b_plus_tree_varlen_page.cpp
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/rid.h"
+#include "storage/page/b_plus_tree_varlen_page.h"
+
+namespace bustub {
+
+static constexpr size_t VARLEN_SLOT_SIZE = 2 * sizeof(uint16_t);
+
+/*****************************************************************************
+ * HELPER METHODS AND UTILITIES
+ *****************************************************************************/
+
+/**
+ * Init method after creating a new varlen page
+ * Including set page type, set current size to zero, set page id/parent id,
+ * set next page id, and reset the free space pointer and the prefix
+ */
+template <typename ValueType>
+void B_PLUS_TREE_VARLEN_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, IndexPageType page_type) {
+  SetPageId(page_id);
+  SetParentPageId(parent_id);
+  SetSize(0);
+  SetMaxSize(PAGE_SIZE - VARLEN_PAGE_HEADER_SIZE);
+  SetPageType(page_type);
+  SetNextPageId(INVALID_PAGE_ID);
+  free_space_pointer_ = PAGE_SIZE;
+  prefix_length_ = 0;
+}
+
+template <typename ValueType>
+page_id_t B_PLUS_TREE_VARLEN_PAGE_TYPE::GetNextPageId() const {
+  return next_page_id_;
+}
+
+template <typename ValueType>
+void B_PLUS_TREE_VARLEN_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {
+  next_page_id_ = next_page_id;
+}
+
+template <typename ValueType>
+std::string_view B_PLUS_TREE_VARLEN_PAGE_TYPE::GetPrefix() const {
+  return std::string_view(data_, prefix_length_);
+}
+
+template <typename ValueType>
+char *B_PLUS_TREE_VARLEN_PAGE_TYPE::SlotArray() {
+  return data_ + prefix_length_;
+}
+
+template <typename ValueType>
+const char *B_PLUS_TREE_VARLEN_PAGE_TYPE::SlotArray() const {
+  return data_ + prefix_length_;
+}
+
+// 前缀长度任意，slot可能不对齐，统一用memcpy读写
+template <typename ValueType>
+void B_PLUS_TREE_VARLEN_PAGE_TYPE::GetSlot(int index, uint16_t *offset, uint16_t *length) const {
+  const char *slot = SlotArray() + index * VARLEN_SLOT_SIZE;
+  memcpy(offset, slot, sizeof(uint16_t));
+  memcpy(length, slot + sizeof(uint16_t), sizeof(uint16_t));
+}
+
+template <typename ValueType>
+void B_PLUS_TREE_VARLEN_PAGE_TYPE::SetSlot(int index, uint16_t offset, uint16_t length) {
+  char *slot = SlotArray() + index * VARLEN_SLOT_SIZE;
+  memcpy(slot, &offset, sizeof(uint16_t));
+  memcpy(slot + sizeof(uint16_t), &length, sizeof(uint16_t));
+}
+
+template <typename ValueType>
+std::string_view B_PLUS_TREE_VARLEN_PAGE_TYPE::SuffixAt(int index) const {
+  uint16_t offset;
+  uint16_t length;
+  GetSlot(index, &offset, &length);
+  return std::string_view(reinterpret_cast<const char *>(this) + offset, length);
+}
+
+/*
+ * Helper method to find and return the key associated with input "index"(a.k.a
+ * array offset). The prefix is glued back in front of the stored suffix.
+ */
+template <typename ValueType>
+std::string B_PLUS_TREE_VARLEN_PAGE_TYPE::KeyAt(int index) const {
+  if (index < FirstKeyIndex()) {
+    //internal节点的第一个key无效，原样存放，不带前缀
+    return std::string(SuffixAt(index));
+  }
+  std::string key(GetPrefix());
+  key.append(SuffixAt(index));
+  return key;
+}
+
+template <typename ValueType>
+ValueType B_PLUS_TREE_VARLEN_PAGE_TYPE::ValueAt(int index) const {
+  uint16_t offset;
+  uint16_t length;
+  GetSlot(index, &offset, &length);
+  ValueType value;
+  memcpy(&value, reinterpret_cast<const char *>(this) + offset + length, sizeof(ValueType));
+  return value;
+}
+
+template <typename ValueType>
+void B_PLUS_TREE_VARLEN_PAGE_TYPE::SetValueAt(int index, const ValueType &value) {
+  uint16_t offset;
+  uint16_t length;
+  GetSlot(index, &offset, &length);
+  memcpy(reinterpret_cast<char *>(this) + offset + length, &value, sizeof(ValueType));
+}
+
+template <typename ValueType>
+int B_PLUS_TREE_VARLEN_PAGE_TYPE::ValueIndex(const ValueType &value) const {
+  for (int i = 0; i < GetSize(); i++) {
+    if (ValueAt(i) == value) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+template <typename ValueType>
+size_t B_PLUS_TREE_VARLEN_PAGE_TYPE::GetFreeSpace() const {
+  size_t used = VARLEN_PAGE_HEADER_SIZE + prefix_length_;
+  for (int i = 0; i < GetSize(); i++) {
+    used += VARLEN_SLOT_SIZE + SuffixAt(i).size() + sizeof(ValueType);
+  }
+  return PAGE_SIZE - used;
+}
+
+/*****************************************************************************
+ * LOOKUP
+ *****************************************************************************/
+/*
+ * Binary search over the valid keys. The search key is compared with the
+ * prefix once; only if it starts with the prefix are the suffixes compared.
+ */
+template <typename ValueType>
+int B_PLUS_TREE_VARLEN_PAGE_TYPE::Bound(std::string_view key, bool upper) const {
+  int first = FirstKeyIndex();
+  int size = GetSize();
+  std::string_view prefix = GetPrefix();
+  size_t common = std::min(key.size(), prefix.size());
+  int cmp = key.compare(0, common, prefix, 0, common);
+  if (cmp < 0 || (cmp == 0 && key.size() < prefix.size())) {
+    //key比前缀小，也就比页内所有key小
+    return first;
+  }
+  if (cmp > 0) {
+    return std::max(first, size);
+  }
+  std::string_view suffix = key.substr(prefix.size());
+  int lo = first;
+  int hi = size;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    int result = SuffixAt(mid).compare(suffix);
+    if (result < 0 || (upper && result == 0)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+template <typename ValueType>
+int B_PLUS_TREE_VARLEN_PAGE_TYPE::KeyIndex(std::string_view key) const {
+  return Bound(key, false);
+}
+
+template <typename ValueType>
+bool B_PLUS_TREE_VARLEN_PAGE_TYPE::Lookup(std::string_view key, ValueType *value) const {
+  int index = KeyIndex(key);
+  if (index >= GetSize()) {
+    return false;
+  }
+  std::string_view prefix = GetPrefix();
+  if (key.substr(0, prefix.size()) != prefix || key.substr(prefix.size()) != SuffixAt(index)) {
+    return false;
+  }
+  *value = ValueAt(index);
+  return true;
+}
+
+/*
+ * Find the child pointer which points to the page that contains input "key".
+ * Same rule as BPlusTreeInternalPage::Lookup: the last key <= input key.
+ */
+template <typename ValueType>
+ValueType B_PLUS_TREE_VARLEN_PAGE_TYPE::LookupChild(std::string_view key) const {
+  return ValueAt(Bound(key, true) - 1);
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+/*
+ * A key that keeps the current prefix goes straight into the free space gap.
+ * Otherwise (the prefix breaks, or the gap is fragmented by removals) the page
+ * is rebuilt with a recomputed prefix, if the entries still fit.
+ */
+template <typename ValueType>
+bool B_PLUS_TREE_VARLEN_PAGE_TYPE::Insert(std::string_view key, const ValueType &value) {
+  if (key.size() > MAX_KEY_SIZE) {
+    return false;
+  }
+  int size = GetSize();
+  int index = std::min(Bound(key, !IsLeafPage()), size);
+  std::string_view prefix = GetPrefix();
+  if (index < FirstKeyIndex() || key.substr(0, prefix.size()) == prefix) {
+    std::string_view stored = index < FirstKeyIndex() ? key : key.substr(prefix.size());
+    size_t gap = free_space_pointer_ - (VARLEN_PAGE_HEADER_SIZE + prefix_length_ + size * VARLEN_SLOT_SIZE);
+    if (gap >= VARLEN_SLOT_SIZE + stored.size() + sizeof(ValueType)) {
+      char *slots = SlotArray();
+      memmove(slots + (index + 1) * VARLEN_SLOT_SIZE, slots + index * VARLEN_SLOT_SIZE,
+              (size - index) * VARLEN_SLOT_SIZE);
+      free_space_pointer_ -= stored.size() + sizeof(ValueType);
+      char *cell = reinterpret_cast<char *>(this) + free_space_pointer_;
+      memcpy(cell, stored.data(), stored.size());
+      memcpy(cell + stored.size(), &value, sizeof(ValueType));
+      SetSlot(index, free_space_pointer_, static_cast<uint16_t>(stored.size()));
+      IncreaseSize(1);
+      return true;
+    }
+  }
+  auto entries = Decode();
+  entries.emplace(entries.begin() + index, std::string(key), value);
+  if (!Fits(entries, IsLeafPage())) {
+    return false;
+  }
+  Rebuild(entries);
+  return true;
+}
+
+/*
+ * Populate new root page with old_value + new_key & new_value
+ */
+template <typename ValueType>
+void B_PLUS_TREE_VARLEN_PAGE_TYPE::PopulateNewRoot(const ValueType &old_value, std::string_view new_key,
+                                                   const ValueType &new_value) {
+  std::vector<Entry> entries;
+  entries.emplace_back(std::string(), old_value);
+  entries.emplace_back(std::string(new_key), new_value);
+  Rebuild(entries);
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+/*
+ * Only the slot is removed, the cell bytes stay behind as garbage until the
+ * next rebuild.
+ */
+template <typename ValueType>
+void B_PLUS_TREE_VARLEN_PAGE_TYPE::Remove(int index) {
+  if (index < FirstKeyIndex()) {
+    //下一个key要变成原样存放的无效key，只能重建
+    auto entries = Decode();
+    entries.erase(entries.begin() + index);
+    Rebuild(entries);
+    return;
+  }
+  char *slots = SlotArray();
+  memmove(slots + index * VARLEN_SLOT_SIZE, slots + (index + 1) * VARLEN_SLOT_SIZE,
+          (GetSize() - index - 1) * VARLEN_SLOT_SIZE);
+  IncreaseSize(-1);
+}
+
+/*****************************************************************************
+ * SPLIT
+ *****************************************************************************/
+template <typename ValueType>
+void B_PLUS_TREE_VARLEN_PAGE_TYPE::MoveHalfTo(BPlusTreeVarlenPage *recipient) {
+  auto entries = Decode();
+  int size = static_cast<int>(entries.size());
+  auto entry_bytes = [](const Entry &entry) { return VARLEN_SLOT_SIZE + entry.first.size() + sizeof(ValueType); };
+  size_t total = 0;
+  for (const auto &entry : entries) {
+    total += entry_bytes(entry);
+  }
+  //按字节数而不是按个数对半分
+  size_t left_bytes = 0;
+  int split = 0;
+  while (split < size - 1 && left_bytes + entry_bytes(entries[split]) <= total / 2) {
+    left_bytes += entry_bytes(entries[split]);
+    split++;
+  }
+  split = std::max(split, 1);
+  recipient->Rebuild(std::vector<Entry>(entries.begin() + split, entries.end()));
+  entries.resize(split);
+  Rebuild(entries);
+}
+
+template <typename ValueType>
+std::string B_PLUS_TREE_VARLEN_PAGE_TYPE::ShortestSeparator(std::string_view left_max, std::string_view right_min) {
+  size_t common = 0;
+  while (common < left_max.size() && common < right_min.size() && left_max[common] == right_min[common]) {
+    common++;
+  }
+  // right_min的前common+1个字节：大于left_max，且不大于right_min
+  return std::string(right_min.substr(0, common + 1));
+}
+
+/*****************************************************************************
+ * REBUILD
+ *****************************************************************************/
+template <typename ValueType>
+std::vector<typename B_PLUS_TREE_VARLEN_PAGE_TYPE::Entry> B_PLUS_TREE_VARLEN_PAGE_TYPE::Decode() const {
+  std::vector<Entry> entries;
+  entries.reserve(GetSize());
+  for (int i = 0; i < GetSize(); i++) {
+    entries.emplace_back(KeyAt(i), ValueAt(i));
+  }
+  return entries;
+}
+
+template <typename ValueType>
+size_t B_PLUS_TREE_VARLEN_PAGE_TYPE::CommonPrefixLength(const std::vector<Entry> &entries, int first) {
+  if (static_cast<int>(entries.size()) <= first) {
+    return 0;
+  }
+  // 有序的key，首尾两个的公共前缀就是所有key的公共前缀
+  const std::string &lo = entries[first].first;
+  const std::string &hi = entries.back().first;
+  size_t common = 0;
+  while (common < lo.size() && common < hi.size() && lo[common] == hi[common]) {
+    common++;
+  }
+  return common;
+}
+
+template <typename ValueType>
+bool B_PLUS_TREE_VARLEN_PAGE_TYPE::Fits(const std::vector<Entry> &entries, bool is_leaf) {
+  int first = is_leaf ? 0 : 1;
+  size_t prefix_length = CommonPrefixLength(entries, first);
+  size_t used = VARLEN_PAGE_HEADER_SIZE + prefix_length;
+  for (int i = 0; i < static_cast<int>(entries.size()); i++) {
+    used += VARLEN_SLOT_SIZE + entries[i].first.size() - (i < first ? 0 : prefix_length) + sizeof(ValueType);
+  }
+  return used <= PAGE_SIZE;
+}
+
+template <typename ValueType>
+void B_PLUS_TREE_VARLEN_PAGE_TYPE::Rebuild(const std::vector<Entry> &entries) {
+  int first = FirstKeyIndex();
+  size_t prefix_length = CommonPrefixLength(entries, first);
+  prefix_length_ = static_cast<uint16_t>(prefix_length);
+  if (prefix_length > 0) {
+    memcpy(data_, entries[first].first.data(), prefix_length);
+  }
+  free_space_pointer_ = PAGE_SIZE;
+  for (int i = 0; i < static_cast<int>(entries.size()); i++) {
+    std::string_view stored(entries[i].first);
+    if (i >= first) {
+      stored.remove_prefix(prefix_length);
+    }
+    free_space_pointer_ -= stored.size() + sizeof(ValueType);
+    char *cell = reinterpret_cast<char *>(this) + free_space_pointer_;
+    memcpy(cell, stored.data(), stored.size());
+    memcpy(cell + stored.size(), &entries[i].second, sizeof(ValueType));
+    SetSlot(i, free_space_pointer_, static_cast<uint16_t>(stored.size()));
+  }
+  SetSize(static_cast<int>(entries.size()));
+}
+
+template class BPlusTreeVarlenPage<RID>;
+template class BPlusTreeVarlenPage<page_id_t>;
+}  // namespace bustub
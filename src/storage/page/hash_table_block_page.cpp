@@ -10,37 +10,123 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <cstring>
+#include <thread>  // NOLINT
+
 #include "storage/page/hash_table_block_page.h"
 #include "storage/index/generic_key.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace bustub {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 KeyType HASH_TABLE_BLOCK_TYPE::KeyAt(slot_offset_t bucket_ind) const {
-  return {};
+  return array_[bucket_ind].first;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 ValueType HASH_TABLE_BLOCK_TYPE::ValueAt(slot_offset_t bucket_ind) const {
-  return {};
+  return array_[bucket_ind].second;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_BLOCK_TYPE::Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value,
+                                   uint8_t tag) {
+  char mask = static_cast<char>(1 << (bucket_ind % 8));
+  uint32_t stripe = StripeOf(bucket_ind);
+  LockStripe(stripe);
+  //空slot和tombstone都可以被认领
+  if ((readable_[bucket_ind / 8].load() & mask) != 0) {
+    UnlockStripe(stripe);
+    return false;
+  }
+  array_[bucket_ind] = MappingType(key, value);
+  __atomic_store_n(&tags_[bucket_ind], tag, __ATOMIC_RELAXED);
+  occupied_[bucket_ind / 8].fetch_or(mask);
+  readable_[bucket_ind / 8].fetch_or(mask);
+  UnlockStripe(stripe);
+  return true;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-bool HASH_TABLE_BLOCK_TYPE::Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value) {
-  return false;
+void HASH_TABLE_BLOCK_TYPE::Remove(slot_offset_t bucket_ind) {
+  uint32_t stripe = StripeOf(bucket_ind);
+  LockStripe(stripe);
+  //只清readable位，occupied位保留作为tombstone，线性探测的链不会断
+  readable_[bucket_ind / 8].fetch_and(static_cast<char>(~(1 << (bucket_ind % 8))));
+  __atomic_store_n(&tags_[bucket_ind], TAG_TOMBSTONE, __ATOMIC_RELAXED);
+  UnlockStripe(stripe);
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BLOCK_TYPE::Remove(slot_offset_t bucket_ind) {}
+bool HASH_TABLE_BLOCK_TYPE::ReadSlot(slot_offset_t bucket_ind, KeyType *key, ValueType *value) const {
+  const std::atomic<uint32_t> &version = stripes_[StripeOf(bucket_ind)];
+  while (true) {
+    uint32_t before = version.load(std::memory_order_acquire);
+    if ((before & 1) != 0) {
+      // writer正在改这个stripe
+      std::this_thread::yield();
+      continue;
+    }
+    bool readable = IsReadable(bucket_ind);
+    MappingType pair;
+    if (readable) {
+      memcpy(static_cast<void *>(&pair), static_cast<const void *>(&array_[bucket_ind]), sizeof(MappingType));
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (version.load(std::memory_order_relaxed) == before) {
+      if (readable) {
+        *key = pair.first;
+        *value = pair.second;
+      }
+      return readable;
+    }
+  }
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_BLOCK_TYPE::IsOccupied(slot_offset_t bucket_ind) const {
-  return false;
+  return (occupied_[bucket_ind / 8].load() & (1 << (bucket_ind % 8))) != 0;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_BLOCK_TYPE::IsReadable(slot_offset_t bucket_ind) const {
-  return false;
+  return (readable_[bucket_ind / 8].load() & (1 << (bucket_ind % 8))) != 0;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t HASH_TABLE_BLOCK_TYPE::MatchTag(slot_offset_t begin, uint8_t tag) const {
+  uint32_t count = std::min<uint32_t>(GROUP_SIZE, BLOCK_ARRAY_SIZE - begin);
+#if defined(__SSE2__)
+  //最后一组的16字节可能读到array_里，超出的位在下面被去掉
+  __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(tags_ + begin));
+  auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(tag)))));
+#else
+  uint32_t mask = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    mask |= static_cast<uint32_t>(tags_[begin + i] == tag) << i;
+  }
+#endif
+  return mask & ((1U << count) - 1);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BLOCK_TYPE::LockStripe(uint32_t stripe) {
+  uint32_t version = stripes_[stripe].load(std::memory_order_relaxed);
+  while ((version & 1) != 0 ||
+         !stripes_[stripe].compare_exchange_weak(version, version + 1, std::memory_order_acquire)) {
+    std::this_thread::yield();
+    version = stripes_[stripe].load(std::memory_order_relaxed);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BLOCK_TYPE::UnlockStripe(uint32_t stripe) {
+  stripes_[stripe].fetch_add(1, std::memory_order_release);
 }
 
 // DO NOT REMOVE ANYTHING BELOW THIS LINE
@@ -0,0 +1,67 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_chain_page.cpp
+//
+// Identification: src/storage/page/hash_table_chain_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/hash_table_chain_page.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_CHAIN_TYPE::Init() {
+  //NewPage清零后next是0，是一个合法的page id
+  next_page_id_ = INVALID_PAGE_ID;
+  count_ = 0;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_CHAIN_TYPE::GetValue(const KeyType &key, KeyComparator cmp, std::vector<ValueType> *result) const {
+  bool found = false;
+  for (uint32_t i = 0; i < count_; i++) {
+    if (cmp(array_[i].first, key) == 0) {
+      result->push_back(array_[i].second);
+      found = true;
+    }
+  }
+  return found;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+int HASH_TABLE_CHAIN_TYPE::Find(const KeyType &key, const ValueType &value, KeyComparator cmp) const {
+  for (uint32_t i = 0; i < count_; i++) {
+    if (cmp(array_[i].first, key) == 0 && array_[i].second == value) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_CHAIN_TYPE::Append(const MappingType &pair) {
+  if (IsFull()) {
+    return false;
+  }
+  array_[count_++] = pair;
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_CHAIN_TYPE::RemoveAt(uint32_t index) {
+  array_[index] = array_[--count_];
+}
+
+// DO NOT REMOVE ANYTHING BELOW THIS LINE
+template class HashTableChainPage<int, int, IntComparator>;
+template class HashTableChainPage<GenericKey<4>, RID, GenericComparator<4>>;
+template class HashTableChainPage<GenericKey<8>, RID, GenericComparator<8>>;
+template class HashTableChainPage<GenericKey<16>, RID, GenericComparator<16>>;
+template class HashTableChainPage<GenericKey<32>, RID, GenericComparator<32>>;
+template class HashTableChainPage<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_cuckoo_page.cpp
+//
+// Identification: src/storage/page/hash_table_cuckoo_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/hash_table_cuckoo_page.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_CUCKOO_TYPE::GetValue(uint32_t bucket, const KeyType &key, KeyComparator cmp,
+                                      std::vector<ValueType> *result) const {
+  bool found = false;
+  const MappingType *slots = &array_[bucket * CUCKOO_SLOTS];
+  for (uint32_t i = 0; i < CUCKOO_SLOTS; i++) {
+    if (IsReadable(bucket, i) && cmp(slots[i].first, key) == 0) {
+      result->push_back(slots[i].second);
+      found = true;
+    }
+  }
+  return found;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_CUCKOO_TYPE::Contains(uint32_t bucket, const KeyType &key, const ValueType &value,
+                                      KeyComparator cmp) const {
+  const MappingType *slots = &array_[bucket * CUCKOO_SLOTS];
+  for (uint32_t i = 0; i < CUCKOO_SLOTS; i++) {
+    if (IsReadable(bucket, i) && cmp(slots[i].first, key) == 0 && slots[i].second == value) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_CUCKOO_TYPE::Insert(uint32_t bucket, const MappingType &pair) {
+  if (IsFull(bucket)) {
+    return false;
+  }
+  //最低的空闲slot
+  SetAt(bucket, static_cast<uint32_t>(__builtin_ctz(~readable_[bucket] & FULL_MASK)), pair);
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_CUCKOO_TYPE::Remove(uint32_t bucket, const KeyType &key, const ValueType &value, KeyComparator cmp) {
+  const MappingType *slots = &array_[bucket * CUCKOO_SLOTS];
+  for (uint32_t i = 0; i < CUCKOO_SLOTS; i++) {
+    if (IsReadable(bucket, i) && cmp(slots[i].first, key) == 0 && slots[i].second == value) {
+      readable_[bucket] = static_cast<uint8_t>(readable_[bucket] & ~(1 << i));
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_CUCKOO_TYPE::SetAt(uint32_t bucket, uint32_t slot, const MappingType &pair) {
+  array_[bucket * CUCKOO_SLOTS + slot] = pair;
+  readable_[bucket] = static_cast<uint8_t>(readable_[bucket] | (1 << slot));
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_CUCKOO_TYPE::IsReadable(uint32_t bucket, uint32_t slot) const {
+  return (readable_[bucket] & (1 << slot)) != 0;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+const MappingType &HASH_TABLE_CUCKOO_TYPE::PairAt(uint32_t bucket, uint32_t slot) const {
+  return array_[bucket * CUCKOO_SLOTS + slot];
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_CUCKOO_TYPE::IsFull(uint32_t bucket) const {
+  return readable_[bucket] == FULL_MASK;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t HASH_TABLE_CUCKOO_TYPE::CountKey(uint32_t bucket, const KeyType &key, KeyComparator cmp) const {
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < CUCKOO_SLOTS; i++) {
+    if (IsReadable(bucket, i) && cmp(array_[bucket * CUCKOO_SLOTS + i].first, key) == 0) {
+      count++;
+    }
+  }
+  return count;
+}
+
+// DO NOT REMOVE ANYTHING BELOW THIS LINE
+template class HashTableCuckooPage<int, int, IntComparator>;
+template class HashTableCuckooPage<GenericKey<4>, RID, GenericComparator<4>>;
+template class HashTableCuckooPage<GenericKey<8>, RID, GenericComparator<8>>;
+template class HashTableCuckooPage<GenericKey<16>, RID, GenericComparator<16>>;
+template class HashTableCuckooPage<GenericKey<32>, RID, GenericComparator<32>>;
+template class HashTableCuckooPage<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_directory_page.cpp
+//
+// Identification: src/storage/page/hash_table_directory_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/hash_table_directory_page.h"
+
+#include <cstring>
+#include <unordered_map>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+page_id_t HashTableDirectoryPage::GetPageId() const { return page_id_; }
+
+void HashTableDirectoryPage::SetPageId(page_id_t page_id) { page_id_ = page_id; }
+
+lsn_t HashTableDirectoryPage::GetLSN() const { return lsn_; }
+
+void HashTableDirectoryPage::SetLSN(lsn_t lsn) { lsn_ = lsn; }
+
+uint32_t HashTableDirectoryPage::GetGlobalDepth() const { return global_depth_; }
+
+uint32_t HashTableDirectoryPage::GetGlobalDepthMask() const { return (1U << global_depth_) - 1; }
+
+void HashTableDirectoryPage::IncrGlobalDepth() {
+  BUSTUB_ASSERT(global_depth_ < MAX_DEPTH, "directory is full");
+  uint32_t size = Size();
+  //新的一半是旧的一半的拷贝：多出来的那一位还没有bucket用到
+  memcpy(local_depths_ + size, local_depths_, size * sizeof(uint8_t));
+  memcpy(bucket_page_ids_ + size, bucket_page_ids_, size * sizeof(page_id_t));
+  global_depth_++;
+}
+
+void HashTableDirectoryPage::DecrGlobalDepth() {
+  BUSTUB_ASSERT(CanShrink(), "directory cannot shrink");
+  global_depth_--;
+}
+
+bool HashTableDirectoryPage::CanShrink() const {
+  if (global_depth_ == 0) {
+    return false;
+  }
+  for (uint32_t i = 0; i < Size(); i++) {
+    if (local_depths_[i] == global_depth_) {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint32_t HashTableDirectoryPage::Size() const { return 1U << global_depth_; }
+
+page_id_t HashTableDirectoryPage::GetBucketPageId(uint32_t bucket_idx) const { return bucket_page_ids_[bucket_idx]; }
+
+void HashTableDirectoryPage::SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id) {
+  bucket_page_ids_[bucket_idx] = bucket_page_id;
+}
+
+uint32_t HashTableDirectoryPage::GetLocalDepth(uint32_t bucket_idx) const { return local_depths_[bucket_idx]; }
+
+void HashTableDirectoryPage::SetLocalDepth(uint32_t bucket_idx, uint32_t local_depth) {
+  local_depths_[bucket_idx] = static_cast<uint8_t>(local_depth);
+}
+
+uint32_t HashTableDirectoryPage::GetSplitImageIndex(uint32_t bucket_idx) const {
+  uint32_t local_depth = local_depths_[bucket_idx];
+  BUSTUB_ASSERT(local_depth > 0, "a bucket of local depth 0 has no split image");
+  return bucket_idx ^ (1U << (local_depth - 1));
+}
+
+void HashTableDirectoryPage::VerifyIntegrity() const {
+  std::unordered_map<page_id_t, uint32_t> slots;
+  std::unordered_map<page_id_t, uint32_t> depths;
+  for (uint32_t i = 0; i < Size(); i++) {
+    page_id_t page_id = bucket_page_ids_[i];
+    BUSTUB_ASSERT(local_depths_[i] <= global_depth_, "local depth above global depth");
+    auto iter = depths.find(page_id);
+    BUSTUB_ASSERT(iter == depths.end() || iter->second == local_depths_[i], "slots of a bucket disagree on its depth");
+    depths[page_id] = local_depths_[i];
+    slots[page_id]++;
+  }
+  for (const auto &entry : slots) {
+    BUSTUB_ASSERT(entry.second == 1U << (global_depth_ - depths[entry.first]), "bucket referenced by a wrong count");
+  }
+}
+
+}  // namespace bustub
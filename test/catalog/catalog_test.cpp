@@ -10,19 +10,21 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <string>
 #include <unordered_set>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/catalog.h"
+#include "concurrency/transaction.h"
 #include "gtest/gtest.h"
 #include "type/value_factory.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(CatalogTest, DISABLED_CreateTableTest) {
+TEST(CatalogTest, CreateTableTest) {
   auto disk_manager = new DiskManager("catalog_test.db");
   auto bpm = new BufferPoolManager(32, disk_manager);
   auto catalog = new Catalog(bpm, nullptr, nullptr);
@@ -38,14 +40,344 @@ TEST(CatalogTest, DISABLED_CreateTableTest) {
 
   Schema schema(columns);
   auto *table_metadata = catalog->CreateTable(nullptr, table_name, schema);
-  (void)table_metadata;
+  EXPECT_EQ(table_metadata, catalog->GetTable(table_name));
+  EXPECT_EQ(table_metadata, catalog->GetTable(table_metadata->oid_));
+  EXPECT_EQ(table_name, table_metadata->name_);
+  EXPECT_EQ(2, table_metadata->schema_.GetColumnCount());
+  EXPECT_THROW(catalog->GetTable(table_metadata->oid_ + 1), std::out_of_range);
+  EXPECT_TRUE(catalog->GetTableIndexes(table_name).empty());
 
-  // Notice that this test case doesn't check anything! :(
-  // It is up to you to extend it
+  delete catalog;
+  delete bpm;
+  delete disk_manager;
+  remove("catalog_test.db");
+}
+
+// NOLINTNEXTLINE
+TEST(CatalogTest, CreateIndexTest) {
+  const int num_tuples = 20000;
+  auto disk_manager = new DiskManager("catalog_test.db");
+  auto bpm = new BufferPoolManager(64, disk_manager);
+  auto catalog = new Catalog(bpm, nullptr, nullptr);
+
+  std::vector<Column> columns;
+  columns.emplace_back("A", TypeId::BIGINT);
+  columns.emplace_back("B", TypeId::INTEGER);
+  Schema schema(columns);
+  // TableHeap::InsertTuple records every insert in the write set of the transaction
+  Transaction txn(0);
+  auto *table_metadata = catalog->CreateTable(&txn, "potato", schema);
+
+  // A is a permutation of [0, num_tuples), B repeats every 100 tuples
+  std::vector<RID> rids(num_tuples);
+  std::vector<std::vector<RID>> rids_of_b(100);
+  for (int i = 0; i < num_tuples; i++) {
+    int64_t a = (static_cast<int64_t>(i) * 7919) % num_tuples;
+    Tuple tuple({ValueFactory::GetBigIntValue(a), ValueFactory::GetIntegerValue(i % 100)}, &schema);
+    RID rid;
+    ASSERT_TRUE(table_metadata->table_->InsertTuple(tuple, &rid, &txn));
+    rids[a] = rid;
+    rids_of_b[i % 100].push_back(rid);
+  }
+
+  std::vector<uint32_t> key_attrs{0};
+  Schema *key_schema = Schema::CopySchema(&schema, key_attrs);
+  for (size_t num_threads : {1, 4}) {
+    std::string index_name = "index_" + std::to_string(num_threads);
+    auto *index_info = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+        &txn, index_name, "potato", schema, *key_schema, key_attrs, 8, num_threads);
+    EXPECT_EQ(index_info, catalog->GetIndex(index_name, "potato"));
+    EXPECT_EQ(index_info, catalog->GetIndex(index_info->index_oid_));
+
+    // every key finds its tuple
+    std::vector<RID> result;
+    for (int64_t a = 0; a < num_tuples; a += 37) {
+      result.clear();
+      Tuple key({ValueFactory::GetBigIntValue(a)}, key_schema);
+      index_info->index_->ScanKey(key, &result, nullptr);
+      ASSERT_EQ(1, result.size());
+      EXPECT_EQ(rids[a], result[0]);
+    }
+
+    // the leaves hold all keys in order
+    auto *index = dynamic_cast<BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>> *>(index_info->index_.get());
+    ASSERT_NE(nullptr, index);
+    int64_t expected = 0;
+    for (auto iter = index->GetBeginIterator(); !iter.isEnd(); ++iter) {
+      EXPECT_EQ(rids[expected], (*iter).second);
+      expected++;
+    }
+    EXPECT_EQ(num_tuples, expected);
+
+    // statistics are collected when the index is created
+    const IndexStats &stats = index_info->stats_;
+    EXPECT_EQ(num_tuples, stats.num_entries_);
+    EXPECT_EQ(num_tuples, stats.distinct_keys_);
+    EXPECT_GT(stats.height_, 1);
+    ASSERT_EQ(16, stats.bucket_bounds_.size());
+    EXPECT_EQ(num_tuples - 1, stats.bucket_bounds_.back().GetAs<int64_t>());
+  }
+  EXPECT_EQ(2, catalog->GetTableIndexes("potato").size());
+  EXPECT_THROW(catalog->GetIndex("index_2", "potato"), std::out_of_range);
+
+  // B is not unique: a unique index on it fails instead of dropping tuples, a non-unique one keeps them all
+  std::vector<uint32_t> b_attrs{1};
+  Schema *b_schema = Schema::CopySchema(&schema, b_attrs);
+  EXPECT_THROW((catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+                   &txn, "index_b_unique", "potato", schema, *b_schema, b_attrs, 8, 4)),
+               Exception);
+  EXPECT_THROW(catalog->GetIndex("index_b_unique", "potato"), std::out_of_range);
+  auto *b_index_info = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      &txn, "index_b", "potato", schema, *b_schema, b_attrs, 8, 4, {}, false, false);
+  EXPECT_FALSE(b_index_info->index_->GetMetadata()->IsUnique());
+  std::vector<RID> result;
+  for (int32_t b = 0; b < 100; b++) {
+    result.clear();
+    b_index_info->index_->ScanKey(Tuple({ValueFactory::GetIntegerValue(b)}, b_schema), &result, nullptr);
+    ASSERT_EQ(num_tuples / 100, result.size());
+    std::sort(result.begin(), result.end(), [](const RID &lhs, const RID &rhs) { return lhs.Get() < rhs.Get(); });
+    EXPECT_EQ(rids_of_b[b], result);
+  }
+  EXPECT_EQ(num_tuples, b_index_info->stats_.num_entries_);
+  EXPECT_EQ(100, b_index_info->stats_.distinct_keys_);
+  EXPECT_EQ(3, catalog->GetTableIndexes("potato").size());
+
+  delete b_schema;
+  delete key_schema;
+  delete catalog;
+  delete bpm;
+  delete disk_manager;
+  remove("catalog_test.db");
+}
+
+TEST(CatalogTest, CoveringIndexTest) {
+  const int num_tuples = 1000;
+  auto disk_manager = new DiskManager("catalog_test.db");
+  auto bpm = new BufferPoolManager(64, disk_manager);
+  auto catalog = new Catalog(bpm, nullptr, nullptr);
+
+  std::vector<Column> columns;
+  columns.emplace_back("A", TypeId::BIGINT);
+  columns.emplace_back("B", TypeId::INTEGER);
+  columns.emplace_back("C", TypeId::BIGINT);
+  Schema schema(columns);
+  Transaction txn(0);
+  auto *table_metadata = catalog->CreateTable(&txn, "potato", schema);
+  for (int i = 0; i < num_tuples; i++) {
+    Tuple tuple({ValueFactory::GetBigIntValue(i), ValueFactory::GetIntegerValue(i % 10),
+                 ValueFactory::GetBigIntValue(static_cast<int64_t>(i) * 3)},
+                &schema);
+    RID rid;
+    ASSERT_TRUE(table_metadata->table_->InsertTuple(tuple, &rid, &txn));
+  }
+
+  // index on A, including B and C: 4 + 8 bytes fit into the 16 byte payload
+  std::vector<uint32_t> key_attrs{0};
+  std::vector<uint32_t> included_attrs{1, 2};
+  Schema *key_schema = Schema::CopySchema(&schema, key_attrs);
+  auto *index_info = catalog->CreateIndex<GenericKey<8>, CoveringValue<16>, GenericComparator<8>>(
+      &txn, "covering", "potato", schema, *key_schema, key_attrs, 8, 2, included_attrs);
+  Index *index = index_info->index_.get();
+  ASSERT_TRUE(index->IsCovering());
+
+  // included columns need a covering value with room for them, checked before anything is built
+  EXPECT_THROW((catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+                   &txn, "rid_only", "potato", schema, *key_schema, key_attrs, 8, 2, included_attrs)),
+               Exception);
+  EXPECT_THROW((catalog->CreateIndex<GenericKey<8>, CoveringValue<16>, GenericComparator<8>>(
+                   &txn, "too_small", "potato", schema, *key_schema, key_attrs, 8, 2, {0, 1, 2})),
+               Exception);
+  EXPECT_EQ(1, catalog->GetTableIndexes("potato").size());
+  ASSERT_EQ(2, index->GetIncludedSchema()->GetColumnCount());
+
+  // the included columns come back without reading the table
+  std::vector<RID> rids;
+  std::vector<Tuple> included;
+  for (int64_t a = 0; a < num_tuples; a += 7) {
+    rids.clear();
+    included.clear();
+    index->ScanKey(Tuple({ValueFactory::GetBigIntValue(a)}, key_schema), &rids, &included, nullptr);
+    ASSERT_EQ(1, rids.size());
+    ASSERT_EQ(1, included.size());
+    Tuple tuple;
+    ASSERT_TRUE(table_metadata->table_->GetTuple(rids[0], &tuple, &txn));
+    EXPECT_EQ(a, tuple.GetValue(&schema, 0).GetAs<int64_t>());
+    EXPECT_EQ(a % 10, included[0].GetValue(index->GetIncludedSchema(), 0).GetAs<int32_t>());
+    EXPECT_EQ(a * 3, included[0].GetValue(index->GetIncludedSchema(), 1).GetAs<int64_t>());
+  }
+
+  // inserts carry the included columns, deletes only need the rid
+  Tuple key({ValueFactory::GetBigIntValue(num_tuples)}, key_schema);
+  Tuple new_included({ValueFactory::GetIntegerValue(42), ValueFactory::GetBigIntValue(-1)},
+                     index->GetIncludedSchema());
+  index->InsertEntry(key, new_included, RID(100, 1), nullptr);
+  rids.clear();
+  included.clear();
+  index->ScanKey(key, &rids, &included, nullptr);
+  ASSERT_EQ(1, included.size());
+  EXPECT_EQ(RID(100, 1), rids[0]);
+  EXPECT_EQ(42, included[0].GetValue(index->GetIncludedSchema(), 0).GetAs<int32_t>());
+  EXPECT_EQ(-1, included[0].GetValue(index->GetIncludedSchema(), 1).GetAs<int64_t>());
+
+  index->DeleteEntry(key, RID(100, 1), nullptr);
+  rids.clear();
+  included.clear();
+  index->ScanKey(key, &rids, &included, nullptr);
+  EXPECT_TRUE(rids.empty());
+  EXPECT_TRUE(included.empty());
+
+  delete key_schema;
+  delete catalog;
+  delete bpm;
+  delete disk_manager;
+  remove("catalog_test.db");
+}
+
+TEST(CatalogTest, InMemoryIndexTest) {
+  const int num_tuples = 5000;
+  auto disk_manager = new DiskManager("catalog_test.db");
+  auto bpm = new BufferPoolManager(64, disk_manager);
+  auto catalog = new Catalog(bpm, nullptr, nullptr);
+
+  std::vector<Column> columns;
+  columns.emplace_back("A", TypeId::BIGINT);
+  columns.emplace_back("B", TypeId::INTEGER);
+  Schema schema(columns);
+  Transaction txn(0);
+  auto *table_metadata = catalog->CreateTable(&txn, "potato", schema);
+  std::vector<RID> rids(num_tuples);
+  for (int i = 0; i < num_tuples; i++) {
+    Tuple tuple({ValueFactory::GetBigIntValue(i), ValueFactory::GetIntegerValue(i % 100)}, &schema);
+    ASSERT_TRUE(table_metadata->table_->InsertTuple(tuple, &rids[i], &txn));
+  }
+
+  std::vector<uint32_t> key_attrs{0};
+  Schema *key_schema = Schema::CopySchema(&schema, key_attrs);
+  auto *index_info = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      &txn, "in_memory", "potato", schema, *key_schema, key_attrs, 8, 4, {}, true);
+  auto *index = dynamic_cast<InMemoryBPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>> *>(index_info->index_.get());
+  ASSERT_NE(nullptr, index);
+
+  std::vector<RID> result;
+  for (int64_t a = 0; a < num_tuples; a += 13) {
+    result.clear();
+    index->ScanKey(Tuple({ValueFactory::GetBigIntValue(a)}, key_schema), &result, nullptr);
+    ASSERT_EQ(1, result.size());
+    EXPECT_EQ(rids[a], result[0]);
+  }
+  int64_t expected = 0;
+  for (auto iter = index->GetBeginIterator(); !iter.isEnd(); ++iter) {
+    EXPECT_EQ(rids[expected], (*iter).second);
+    expected++;
+  }
+  EXPECT_EQ(num_tuples, expected);
+
+  // B repeats every 100 tuples
+  std::vector<uint32_t> b_attrs{1};
+  Schema *b_schema = Schema::CopySchema(&schema, b_attrs);
+  EXPECT_THROW((catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+                   &txn, "in_memory_b_unique", "potato", schema, *b_schema, b_attrs, 8, 4, {}, true)),
+               Exception);
+  auto *b_index_info = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      &txn, "in_memory_b", "potato", schema, *b_schema, b_attrs, 8, 4, {}, true, false);
+  for (int32_t b = 0; b < 100; b += 7) {
+    result.clear();
+    b_index_info->index_->ScanKey(Tuple({ValueFactory::GetIntegerValue(b)}, b_schema), &result, nullptr);
+    EXPECT_EQ(num_tuples / 100, result.size());
+  }
+
+  delete b_schema;
+  delete key_schema;
+  delete catalog;
+  delete bpm;
+  delete disk_manager;
+  remove("catalog_test.db");
+}
+
+// NOLINTNEXTLINE
+TEST(CatalogTest, VarlenIndexTest) {
+  const int num_tuples = 2000;
+  auto disk_manager = new DiskManager("catalog_test.db");
+  auto bpm = new BufferPoolManager(64, disk_manager);
+  // the index keeps its root page id in the header page, which must not be a table page
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  auto catalog = new Catalog(bpm, nullptr, nullptr);
+
+  std::vector<Column> columns;
+  columns.emplace_back("A", TypeId::BIGINT);
+  columns.emplace_back("B", TypeId::VARCHAR, 128);
+  columns.emplace_back("C", TypeId::VARCHAR, 16);
+  Schema schema(columns);
+  Transaction txn(0);
+  auto *table_metadata = catalog->CreateTable(&txn, "potato", schema);
+  // the B values share their first 80 bytes, more than a GenericKey<64> holds
+  const std::string prefix(80, 'p');
+  std::vector<RID> rids(num_tuples);
+  for (int i = 0; i < num_tuples; i++) {
+    Tuple tuple({ValueFactory::GetBigIntValue(i), ValueFactory::GetVarcharValue(prefix + std::to_string(i)),
+                 ValueFactory::GetVarcharValue("group" + std::to_string(i % 10))},
+                &schema);
+    ASSERT_TRUE(table_metadata->table_->InsertTuple(tuple, &rids[i], &txn));
+  }
+
+  std::vector<uint32_t> key_attrs{1};
+  Schema *key_schema = Schema::CopySchema(&schema, key_attrs);
+  auto *index_info = catalog->CreateIndex<VarlenKey, RID, VarlenComparator>(&txn, "varlen", "potato", schema,
+                                                                            *key_schema, key_attrs, 0);
+  auto *index = dynamic_cast<VarlenBPlusTreeIndex *>(index_info->index_.get());
+  ASSERT_NE(nullptr, index);
+  EXPECT_EQ(2, index->GetHeight());
+
+  std::vector<RID> result;
+  for (int i = 0; i < num_tuples; i += 7) {
+    result.clear();
+    index->ScanKey(Tuple({ValueFactory::GetVarcharValue(prefix + std::to_string(i))}, key_schema), &result, nullptr);
+    ASSERT_EQ(1, result.size());
+    EXPECT_EQ(rids[i], result[0]);
+  }
+  result.clear();
+  index->ScanKey(Tuple({ValueFactory::GetVarcharValue(prefix)}, key_schema), &result, nullptr);
+  EXPECT_TRUE(result.empty());
+
+  Tuple key({ValueFactory::GetVarcharValue(prefix + "0")}, key_schema);
+  index->DeleteEntry(key, rids[0], nullptr);
+  index->ScanKey(key, &result, nullptr);
+  EXPECT_TRUE(result.empty());
+  index->InsertEntry(key, rids[0], nullptr);
+  index->ScanKey(key, &result, nullptr);
+  EXPECT_EQ(1, result.size());
+
+  // C repeats every 10 tuples
+  std::vector<uint32_t> c_attrs{2};
+  Schema *c_schema = Schema::CopySchema(&schema, c_attrs);
+  EXPECT_THROW((catalog->CreateIndex<VarlenKey, RID, VarlenComparator>(&txn, "varlen_c_unique", "potato", schema,
+                                                                       *c_schema, c_attrs, 0)),
+               Exception);
+  EXPECT_THROW((catalog->CreateIndex<VarlenKey, RID, VarlenComparator>(&txn, "varlen_c_in_memory", "potato", schema,
+                                                                       *c_schema, c_attrs, 0, 1, {}, true, false)),
+               Exception);
+  auto *c_index_info = catalog->CreateIndex<VarlenKey, RID, VarlenComparator>(
+      &txn, "varlen_c", "potato", schema, *c_schema, c_attrs, 0, 1, {}, false, false);
+  for (int c = 0; c < 10; c++) {
+    result.clear();
+    c_index_info->index_->ScanKey(Tuple({ValueFactory::GetVarcharValue("group" + std::to_string(c))}, c_schema),
+                                  &result, nullptr);
+    ASSERT_EQ(num_tuples / 10, result.size());
+    for (auto &rid : result) {
+      Tuple tuple;
+      ASSERT_TRUE(table_metadata->table_->GetTuple(rid, &tuple, &txn));
+      EXPECT_EQ(c, tuple.GetValue(&schema, 0).GetAs<int64_t>() % 10);
+    }
+  }
 
+  delete c_schema;
+  delete key_schema;
   delete catalog;
   delete bpm;
   delete disk_manager;
+  remove("catalog_test.db");
 }
 
 }  // namespace bustub
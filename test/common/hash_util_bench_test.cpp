@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_util_bench_test.cpp
+//
+// Identification: test/common/hash_util_bench_test.cpp
+//
+// Timings of the hash functions, kept out of the unit tests.
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "container/hash/hash_function.h"
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+static const std::vector<std::pair<std::string, HashAlgorithm>> ALGORITHMS = {
+    {"murmur3", HashAlgorithm::MURMUR3}, {"crc32c", HashAlgorithm::CRC32C}, {"wyhash", HashAlgorithm::WYHASH}};
+
+// ns per hash of fixed-width keys and of strings, printed for comparison
+TEST(HashUtilBenchTest, Microbenchmark) {
+  const int num_hashes = 1 << 18;
+  uint64_t sink = 0;
+  auto report = [](const std::string &name, std::chrono::high_resolution_clock::time_point start, int count) {
+    auto end = std::chrono::high_resolution_clock::now();
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    std::cout << name << ": " << static_cast<double>(ns) / count << " ns/hash" << std::endl;
+  };
+  for (const auto &algorithm : ALGORITHMS) {
+    HashFunction<GenericKey<8>> narrow(algorithm.second);
+    HashFunction<GenericKey<64>> wide(algorithm.second);
+    GenericKey<8> narrow_key;
+    GenericKey<64> wide_key;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < num_hashes; i++) {
+      narrow_key.SetFromInteger(i);
+      sink += narrow.GetHash(narrow_key);
+    }
+    report(algorithm.first + " GenericKey<8>", start, num_hashes);
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < num_hashes; i++) {
+      wide_key.SetFromInteger(i);
+      sink += wide.GetHash(wide_key);
+    }
+    report(algorithm.first + " GenericKey<64>", start, num_hashes);
+  }
+
+  std::vector<std::string> strings;
+  for (int i = 0; i < 1024; i++) {
+    strings.push_back(std::string(i % 100 + 1, static_cast<char>('a' + i % 26)) + std::to_string(i));
+  }
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < num_hashes; i++) {
+    const std::string &text = strings[i % strings.size()];
+    sink += HashUtil::HashBytes(text.data(), text.size());
+  }
+  report("wyhash strings", start, num_hashes);
+  start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < num_hashes; i++) {
+    const std::string &text = strings[i % strings.size()];
+    sink += HashUtil::HashCrc32c(text.data(), text.size());
+  }
+  report("crc32c strings", start, num_hashes);
+  EXPECT_NE(0U, sink);
+}
+
+}  // namespace bustub
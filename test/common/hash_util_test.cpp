@@ -0,0 +1,101 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_util_test.cpp
+//
+// Identification: test/common/hash_util_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "container/hash/hash_function.h"
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+static const std::vector<std::pair<std::string, HashAlgorithm>> ALGORITHMS = {
+    {"murmur3", HashAlgorithm::MURMUR3}, {"crc32c", HashAlgorithm::CRC32C}, {"wyhash", HashAlgorithm::WYHASH}};
+
+// chi-squared of the counts against a uniform spread
+static double ChiSquared(const std::vector<int> &counts, int total) {
+  double expected = static_cast<double>(total) / counts.size();
+  double chi = 0;
+  for (int count : counts) {
+    chi += (count - expected) * (count - expected) / expected;
+  }
+  return chi;
+}
+
+TEST(HashUtilTest, Crc32cCheckValue) {
+  // the check value of CRC-32C
+  EXPECT_EQ(0xe3069283U, HashUtil::Crc32c("123456789", 9));
+  EXPECT_EQ(0U, HashUtil::Crc32c("", 0));
+  // chained over pieces like over the whole string
+  std::string text = "the quick brown fox jumps over the lazy dog";
+  uint32_t crc = HashUtil::Crc32c(text.data(), 13);
+  EXPECT_EQ(HashUtil::Crc32c(text.data(), text.size()), HashUtil::Crc32c(text.data() + 13, text.size() - 13, crc));
+}
+
+TEST(HashUtilTest, HashBytesEveryLength) {
+  // every length goes through a different read pattern: all bytes must count, and the length
+  std::string text(200, 'x');
+  for (size_t length = 0; length <= text.size(); length++) {
+    hash_t hash = HashUtil::HashBytes(text.data(), length);
+    EXPECT_EQ(hash, HashUtil::HashBytes(std::string(text, 0, length).data(), length));
+    if (length > 0) {
+      EXPECT_NE(hash, HashUtil::HashBytes(text.data(), length - 1));
+      std::string changed(text, 0, length);
+      changed[length / 3] = 'y';
+      EXPECT_NE(hash, HashUtil::HashBytes(changed.data(), length));
+    }
+  }
+  EXPECT_NE(HashUtil::HashBytes(text.data(), 16, 1), HashUtil::HashBytes(text.data(), 16, 2));
+}
+
+/*
+ * Sequential integer keys, the worst case of a weak hash: the low bits (the
+ * slot of a table) and the top 7 bits (the tags of the block pages) must
+ * spread evenly, and flipping one bit of the key must flip about half of
+ * the bits of the hash.
+ */
+TEST(HashUtilTest, Distribution) {
+  const int num_keys = 1 << 16;
+  const int num_buckets = 256;
+  // chi-squared of 255 degrees of freedom, far out in the tail
+  const double max_chi = 400;
+  for (const auto &algorithm : ALGORITHMS) {
+    HashFunction<GenericKey<8>> hash_fn(algorithm.second);
+    std::vector<int> low(num_buckets, 0);
+    std::vector<int> high(128, 0);
+    double flipped = 0;
+    int flips = 0;
+    GenericKey<8> key;
+    for (int i = 0; i < num_keys; i++) {
+      key.SetFromInteger(i);
+      uint64_t hash = hash_fn.GetHash(key);
+      low[hash % num_buckets]++;
+      high[hash >> 57]++;
+      if (i % 64 == 0) {
+        for (int bit = 0; bit < 64; bit++) {
+          key.SetFromInteger(static_cast<int64_t>(static_cast<uint64_t>(i) ^ (1ULL << bit)));
+          flipped += __builtin_popcountll(hash ^ hash_fn.GetHash(key));
+          flips++;
+        }
+      }
+    }
+    EXPECT_LT(ChiSquared(low, num_keys), max_chi) << algorithm.first;
+    EXPECT_LT(ChiSquared(high, num_keys), max_chi) << algorithm.first;
+    double avalanche = flipped / flips;
+    EXPECT_GT(avalanche, 30.0) << algorithm.first;
+    EXPECT_LT(avalanche, 34.0) << algorithm.first;
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,281 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// chained_hash_table_test.cpp
+//
+// Identification: test/container/chained_hash_table_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <atomic>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "container/hash/chained_hash_table.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+/*
+ * A few pairs spread over the initial buckets fit their head pages: no
+ * overflow page and no split, and a pair is stored once.
+ */
+// NOLINTNEXTLINE
+TEST(ChainedHashTableTest, SampleTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  ChainedHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 4, HashFunction<int>());
+
+  // key i has the values i and -i, key 0 only one
+  for (int i = 0; i < 20; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    EXPECT_EQ(i != 0, ht.Insert(nullptr, i, -i));
+    EXPECT_FALSE(ht.Insert(nullptr, i, i));
+  }
+  EXPECT_EQ(4, ht.GetSize());
+  EXPECT_DOUBLE_EQ(1.0, ht.GetAverageChainLength());
+  for (int i = 0; i < 20; i++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    std::sort(res.begin(), res.end());
+    EXPECT_EQ(i == 0 ? 1 : 2, res.size());
+    EXPECT_EQ(i, res.back());
+  }
+
+  for (int i = 0; i < 20; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    EXPECT_FALSE(ht.Remove(nullptr, i, i));
+    std::vector<int> res;
+    EXPECT_EQ(i != 0, ht.GetValue(nullptr, i, &res));
+  }
+  EXPECT_EQ(4, ht.GetSize());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+/*
+ * From one bucket to many, one split at a time: the chains stay short on
+ * average, every pair stays reachable, and removing all pairs frees every
+ * overflow page.
+ */
+// NOLINTNEXTLINE
+TEST(ChainedHashTableTest, SplitTest) {
+  const int num_keys = 20000;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  Schema key_schema({Column("a", TypeId::BIGINT)});
+  GenericComparator<64> comparator(&key_schema);
+
+  ChainedHashTable<GenericKey<64>, RID, GenericComparator<64>> ht("blah", bpm, comparator, 1,
+                                                                  HashFunction<GenericKey<64>>());
+  GenericKey<64> index_key;
+  for (int key = 0; key < num_keys; key++) {
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(ht.Insert(nullptr, index_key, RID(key, key)));
+  }
+  // 20000个72字节的pair至少要353个page
+  EXPECT_GT(ht.GetSize(), 100);
+  EXPECT_LE(ht.GetAverageChainLength(), 1.6);
+  for (int key = 0; key < num_keys; key++) {
+    index_key.SetFromInteger(key);
+    std::vector<RID> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, index_key, &res));
+    ASSERT_EQ(1, res.size());
+    EXPECT_EQ(RID(key, key), res[0]);
+  }
+  for (int key = 0; key < num_keys; key++) {
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(ht.Remove(nullptr, index_key, RID(key, key)));
+  }
+  EXPECT_DOUBLE_EQ(1.0, ht.GetAverageChainLength());
+  index_key.SetFromInteger(7);
+  std::vector<RID> res;
+  EXPECT_FALSE(ht.GetValue(nullptr, index_key, &res));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+/*
+ * Thousands of values for a few keys make long chains in their buckets;
+ * all values come back, and removes from the middle of a chain keep it
+ * whole.
+ */
+// NOLINTNEXTLINE
+TEST(ChainedHashTableTest, DuplicateKeysTest) {
+  const int num_hot_keys = 3;
+  const int values_per_key = 3000;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  ChainedHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 64, HashFunction<int>());
+  for (int v = 0; v < values_per_key; v++) {
+    for (int key = 0; key < num_hot_keys; key++) {
+      ASSERT_TRUE(ht.Insert(nullptr, key, v));
+    }
+  }
+  for (int key = num_hot_keys; key < 1000; key++) {
+    ASSERT_TRUE(ht.Insert(nullptr, key, key));
+  }
+  for (int key = 0; key < num_hot_keys; key++) {
+    std::vector<int> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, key, &res));
+    ASSERT_EQ(values_per_key, res.size());
+    std::sort(res.begin(), res.end());
+    EXPECT_EQ(0, res.front());
+    EXPECT_EQ(values_per_key - 1, res.back());
+  }
+  for (int key = num_hot_keys; key < 1000; key++) {
+    std::vector<int> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, key, &res));
+    ASSERT_EQ(1, res.size());
+  }
+  // 从链中间删掉，重复的pair仍然被拒绝
+  for (int v = 0; v < values_per_key; v += 2) {
+    EXPECT_TRUE(ht.Remove(nullptr, 1, v));
+    EXPECT_FALSE(ht.Insert(nullptr, 1, v + 1));
+  }
+  std::vector<int> res;
+  ASSERT_TRUE(ht.GetValue(nullptr, 1, &res));
+  EXPECT_EQ(values_per_key / 2, res.size());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+/*
+ * Writer threads insert distinct keys, and one more writer piles values on a
+ * single hot key, into a table of one bucket: the chains grow and the split
+ * pointer walks the buckets round after round, each split rehashing one
+ * chain under the exclusive latch between the inserts of the others. Reader
+ * threads meanwhile look up fixed keys, the keys inserted so far and the
+ * hot key, whose values must all be in its chain wherever it is split. The
+ * readers take their first round before the writers start and their last
+ * one after them, and see the number of buckets only go up.
+ */
+// NOLINTNEXTLINE
+TEST(ChainedHashTableTest, SplitWhileReadingTest) {
+  const int num_fixed = 100;
+  const int num_writers = 2;
+  const int num_readers = 2;
+  const int keys_per_writer = 10000;
+  const int hot_values = 3000;
+  const int hot_key = -1;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  ChainedHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1, HashFunction<int>());
+  for (int i = 0; i < num_fixed; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, -i));
+  }
+
+  // writer w插入first_key(w)开始的key，inserted[w]个已经插入；hot_inserted个hot key的value已经插入
+  auto first_key = [](int w) { return num_fixed + w * keys_per_writer; };
+  std::atomic<int> inserted[num_writers] = {};
+  std::atomic<int> hot_inserted{0};
+  std::atomic<int> readers_ready{0};
+  std::atomic<bool> done{false};
+  std::vector<std::vector<size_t>> sizes(num_readers);
+  std::vector<std::thread> readers;
+  for (int r = 0; r < num_readers; r++) {
+    readers.emplace_back([&, r] {
+      std::vector<size_t> &seen = sizes[r];
+      std::vector<int> res;
+      for (bool last = false; !last;) {
+        last = done.load();
+        seen.push_back(ht.GetSize());
+        for (int i = 0; i < num_fixed; i++) {
+          res.clear();
+          ASSERT_TRUE(ht.GetValue(nullptr, i, &res));
+          ASSERT_EQ(1, res.size());
+          ASSERT_EQ(-i, res[0]);
+        }
+        for (int w = 0; w < num_writers; w++) {
+          int present = inserted[w].load();
+          for (int i = present % 7; i < present; i += 7) {
+            res.clear();
+            ASSERT_TRUE(ht.GetValue(nullptr, first_key(w) + i, &res));
+            ASSERT_EQ(1, res.size());
+          }
+        }
+        int hot_present = hot_inserted.load();
+        res.clear();
+        ht.GetValue(nullptr, hot_key, &res);
+        ASSERT_LE(hot_present, res.size());
+        ASSERT_GE(hot_values, res.size());
+        if (seen.size() == 1) {
+          readers_ready++;
+        }
+      }
+    });
+  }
+  std::vector<std::thread> writers;
+  for (int w = 0; w < num_writers; w++) {
+    writers.emplace_back([&, w] {
+      while (readers_ready.load() < num_readers) {
+        std::this_thread::yield();
+      }
+      for (int i = 0; i < keys_per_writer; i++) {
+        EXPECT_TRUE(ht.Insert(nullptr, first_key(w) + i, i));
+        inserted[w]++;
+      }
+    });
+  }
+  writers.emplace_back([&] {
+    while (readers_ready.load() < num_readers) {
+      std::this_thread::yield();
+    }
+    for (int v = 0; v < hot_values; v++) {
+      EXPECT_TRUE(ht.Insert(nullptr, hot_key, v));
+      hot_inserted++;
+    }
+  });
+  for (auto &thread : writers) {
+    thread.join();
+  }
+  done = true;
+  for (auto &thread : readers) {
+    thread.join();
+  }
+
+  size_t grown_size = ht.GetSize();
+  EXPECT_GT(grown_size, 16);
+  EXPECT_LE(ht.GetAverageChainLength(), 1.6);
+  for (auto &seen : sizes) {
+    EXPECT_EQ(1, seen.front());
+    EXPECT_EQ(grown_size, seen.back());
+    EXPECT_TRUE(std::is_sorted(seen.begin(), seen.end()));
+  }
+  std::vector<int> res;
+  ASSERT_TRUE(ht.GetValue(nullptr, hot_key, &res));
+  std::sort(res.begin(), res.end());
+  ASSERT_EQ(hot_values, res.size());
+  EXPECT_EQ(hot_values - 1, res.back());
+  for (int w = 0; w < num_writers; w++) {
+    for (int i = 0; i < keys_per_writer; i++) {
+      res.clear();
+      ASSERT_TRUE(ht.GetValue(nullptr, first_key(w) + i, &res));
+      EXPECT_EQ(i, res[0]);
+    }
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+}  // namespace bustub
@@ -0,0 +1,228 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// cuckoo_hash_table_test.cpp
+//
+// Identification: test/container/cuckoo_hash_table_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <atomic>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "container/hash/cuckoo_hash_table.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+/*
+ * The values of a key live in its two buckets only, so a key holds at most
+ * 2 * CUCKOO_SLOTS of them, however empty the rest of the table is.
+ */
+// NOLINTNEXTLINE
+TEST(CuckooHashTableTest, SampleTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  CuckooHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1, HashFunction<int>());
+  size_t size = ht.GetSize();
+
+  for (int key = 0; key < 3; key++) {
+    for (int v = 0; v < 2 * CUCKOO_SLOTS; v++) {
+      EXPECT_TRUE(ht.Insert(nullptr, key, v));
+      EXPECT_FALSE(ht.Insert(nullptr, key, v));
+    }
+    EXPECT_FALSE(ht.Insert(nullptr, key, 2 * CUCKOO_SLOTS));
+  }
+  EXPECT_EQ(size, ht.GetSize());
+  for (int key = 0; key < 3; key++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, key, &res));
+    EXPECT_EQ(2 * CUCKOO_SLOTS, res.size());
+  }
+  std::vector<int> res;
+  EXPECT_FALSE(ht.GetValue(nullptr, 3, &res));
+
+  // a removed value makes room for another one of the same key
+  EXPECT_TRUE(ht.Remove(nullptr, 1, 0));
+  EXPECT_FALSE(ht.Remove(nullptr, 1, 0));
+  EXPECT_TRUE(ht.Insert(nullptr, 1, 2 * CUCKOO_SLOTS));
+  res.clear();
+  EXPECT_TRUE(ht.GetValue(nullptr, 1, &res));
+  EXPECT_EQ(2 * CUCKOO_SLOTS, res.size());
+  EXPECT_EQ(res.end(), std::find(res.begin(), res.end(), 0));
+
+  for (int v = 0; v < 2 * CUCKOO_SLOTS; v++) {
+    EXPECT_TRUE(ht.Remove(nullptr, 2, v));
+  }
+  res.clear();
+  EXPECT_FALSE(ht.GetValue(nullptr, 2, &res));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+/*
+ * From one page of buckets to enough for 20000 wide keys: the evictions and
+ * the growing must keep every pair reachable from one of its two buckets.
+ */
+// NOLINTNEXTLINE
+TEST(CuckooHashTableTest, GrowTest) {
+  const int num_keys = 20000;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  Schema key_schema({Column("a", TypeId::BIGINT)});
+  GenericComparator<64> comparator(&key_schema);
+
+  CuckooHashTable<GenericKey<64>, RID, GenericComparator<64>> ht("blah", bpm, comparator, 1,
+                                                                 HashFunction<GenericKey<64>>());
+  size_t initial_size = ht.GetSize();
+  GenericKey<64> index_key;
+  for (int key = 0; key < num_keys; key++) {
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(ht.Insert(nullptr, index_key, RID(key, key)));
+  }
+  EXPECT_GT(ht.GetSize(), initial_size);
+  // 只在放不下时才扩容，装载率不会太低
+  EXPECT_GT(static_cast<size_t>(num_keys), ht.GetSize() * CUCKOO_SLOTS / 4);
+  for (int key = 0; key < num_keys; key += 2) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(ht.Remove(nullptr, index_key, RID(key, key)));
+  }
+  for (int key = 0; key < num_keys + 100; key++) {
+    index_key.SetFromInteger(key);
+    std::vector<RID> res;
+    ASSERT_EQ(key % 2 == 1 && key < num_keys, ht.GetValue(nullptr, index_key, &res));
+    if (!res.empty()) {
+      ASSERT_EQ(1, res.size());
+      EXPECT_EQ(RID(key, key), res[0]);
+    }
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+/*
+ * Reader threads look up a fixed set of keys, and the keys the writers have
+ * inserted so far, while the writers fill the table to 90% without growing
+ * it: far past the load where some key finds both of its buckets full, so
+ * the inserts have to search eviction chains and move pairs, the fixed ones
+ * included, to their other bucket. An insert moves its chain under the
+ * exclusive table latch; the readers must find every pair in one of its two
+ * buckets between any two inserts. Then the writers go on until the table
+ * has grown a few times under the readers.
+ */
+// NOLINTNEXTLINE
+TEST(CuckooHashTableTest, EvictWhileReadingTest) {
+  const int num_fixed = 100;
+  const int num_writers = 2;
+  const int num_readers = 2;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  CuckooHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+  const size_t initial_size = ht.GetSize();
+  const int capacity = static_cast<int>(initial_size) * CUCKOO_SLOTS;
+  for (int i = 0; i < num_fixed; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, -i));
+  }
+
+  // writer w插入first_key(w)开始的key，inserted[w]个已经插入
+  const int max_keys_per_writer = 2 * capacity;
+  auto first_key = [&](int w) { return num_fixed + w * max_keys_per_writer; };
+  std::atomic<int> inserted[num_writers] = {};
+  auto run = [&](int keys_per_writer, std::vector<std::vector<size_t>> *sizes) {
+    std::atomic<int> readers_ready{0};
+    std::atomic<bool> done{false};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < num_readers; r++) {
+      readers.emplace_back([&, r] {
+        std::vector<size_t> &seen = (*sizes)[r];
+        std::vector<int> res;
+        for (bool last = false; !last;) {
+          last = done.load();
+          seen.push_back(ht.GetSize());
+          for (int i = 0; i < num_fixed; i++) {
+            res.clear();
+            ASSERT_TRUE(ht.GetValue(nullptr, i, &res));
+            ASSERT_EQ(1, res.size());
+            ASSERT_EQ(-i, res[0]);
+          }
+          for (int w = 0; w < num_writers; w++) {
+            int present = inserted[w].load();
+            for (int i = present % 5; i < present; i += 5) {
+              res.clear();
+              ASSERT_TRUE(ht.GetValue(nullptr, first_key(w) + i, &res));
+              ASSERT_EQ(1, res.size());
+              ASSERT_EQ(i, res[0]);
+            }
+          }
+          if (seen.size() == 1) {
+            readers_ready++;
+          }
+        }
+      });
+    }
+    std::vector<std::thread> writers;
+    for (int w = 0; w < num_writers; w++) {
+      writers.emplace_back([&, w] {
+        while (readers_ready.load() < num_readers) {
+          std::this_thread::yield();
+        }
+        for (int i = inserted[w].load(); i < keys_per_writer; i++) {
+          EXPECT_TRUE(ht.Insert(nullptr, first_key(w) + i, i));
+          inserted[w]++;
+        }
+      });
+    }
+    for (auto &thread : writers) {
+      thread.join();
+    }
+    done = true;
+    for (auto &thread : readers) {
+      thread.join();
+    }
+  };
+
+  std::vector<std::vector<size_t>> sizes(num_readers);
+  run((capacity * 9 / 10 - num_fixed) / num_writers, &sizes);
+  EXPECT_EQ(initial_size, ht.GetSize());
+  for (auto &seen : sizes) {
+    EXPECT_EQ(std::vector<size_t>(seen.size(), initial_size), seen);
+    seen.clear();
+  }
+
+  run(max_keys_per_writer, &sizes);
+  size_t grown_size = ht.GetSize();
+  EXPECT_GE(grown_size, 4 * initial_size);
+  for (auto &seen : sizes) {
+    EXPECT_EQ(initial_size, seen.front());
+    EXPECT_EQ(grown_size, seen.back());
+    EXPECT_TRUE(std::is_sorted(seen.begin(), seen.end()));
+  }
+  for (int w = 0; w < num_writers; w++) {
+    for (int i = 0; i < max_keys_per_writer; i++) {
+      std::vector<int> res;
+      ASSERT_TRUE(ht.GetValue(nullptr, first_key(w) + i, &res));
+      ASSERT_EQ(i, res[0]);
+    }
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+}  // namespace bustub
@@ -0,0 +1,250 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table_test.cpp
+//
+// Identification: test/container/extendible_hash_table_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "container/hash/extendible_hash_table.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/*
+ * A handful of pairs fits the one bucket of depth 0: several values per key,
+ * a pair only once, and emptying the bucket does not merge anything.
+ */
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, SampleTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // key i has the values 0..i
+  for (int i = 0; i < 5; i++) {
+    for (int v = 0; v <= i; v++) {
+      EXPECT_TRUE(ht.Insert(nullptr, i, v));
+    }
+    EXPECT_FALSE(ht.Insert(nullptr, i, i));
+  }
+  for (int i = 0; i < 5; i++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    std::sort(res.begin(), res.end());
+    EXPECT_EQ(i + 1, res.size());
+    EXPECT_EQ(i, res.back());
+  }
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+
+  // removing one value keeps the others of the key, a removed pair can come back
+  EXPECT_TRUE(ht.Remove(nullptr, 3, 1));
+  EXPECT_FALSE(ht.Remove(nullptr, 3, 1));
+  std::vector<int> res;
+  EXPECT_TRUE(ht.GetValue(nullptr, 3, &res));
+  EXPECT_EQ(3, res.size());
+  EXPECT_TRUE(ht.Insert(nullptr, 3, 1));
+
+  for (int i = 0; i < 5; i++) {
+    for (int v = 0; v <= i; v++) {
+      EXPECT_TRUE(ht.Remove(nullptr, i, v));
+    }
+    res.clear();
+    EXPECT_FALSE(ht.GetValue(nullptr, i, &res));
+  }
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+  ht.VerifyIntegrity();
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+/*
+ * Enough pairs for many splits and a few directory doublings, then all of
+ * them removed: the buckets merge back and the directory shrinks to one slot.
+ */
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, SplitAndMergeTest) {
+  const int num_keys = 20000;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  for (int i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  ht.VerifyIntegrity();
+  // 20000个pair至少要41个bucket
+  EXPECT_GE(ht.GetGlobalDepth(), 6);
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &res));
+    ASSERT_EQ(1, res.size());
+    EXPECT_EQ(i, res[0]);
+  }
+
+  for (int i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  ht.VerifyIntegrity();
+  for (int i = 0; i < num_keys; i += 97) {
+    std::vector<int> res;
+    EXPECT_FALSE(ht.GetValue(nullptr, i, &res));
+  }
+  // reusable after shrinking
+  for (int i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, -i));
+  }
+  ht.VerifyIntegrity();
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+/*
+ * Reader threads look up a fixed set of keys, and the keys the writers have
+ * inserted so far, while the writers grow the table from one bucket: every
+ * lookup must find its bucket through the directory whichever split or
+ * doubling has just run. The readers take their first round before the
+ * writers start and their last one after them, so they see the directory at
+ * depth 0 and fully grown. Then the writers remove their keys again: the
+ * buckets merge under the readers, the removed keys stay gone and the fixed
+ * keys stay.
+ */
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, SplitWhileReadingTest) {
+  const int num_fixed = 100;
+  const int num_writers = 2;
+  const int num_readers = 2;
+  const int keys_per_writer = 10000;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+  for (int i = 0; i < num_fixed; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, -i));
+  }
+  ASSERT_EQ(0, ht.GetGlobalDepth());
+
+  // writer w的key是first_key(w)开始的keys_per_writer个：inserted[w]个已经插入，
+  // removing[w]个开始删除，其中removed[w]个已经删完
+  auto first_key = [](int w) { return num_fixed + w * keys_per_writer; };
+  std::atomic<int> inserted[num_writers] = {};
+  std::atomic<int> removing[num_writers] = {};
+  std::atomic<int> removed[num_writers] = {};
+  std::atomic<int> readers_ready{0};
+  std::atomic<bool> done{false};
+  auto read = [&](std::vector<uint32_t> *depths) {
+    std::vector<int> res;
+    for (bool last = false; !last;) {
+      last = done.load();
+      depths->push_back(ht.GetGlobalDepth());
+      for (int i = 0; i < num_fixed; i++) {
+        res.clear();
+        ASSERT_TRUE(ht.GetValue(nullptr, i, &res));
+        ASSERT_EQ(1, res.size());
+        ASSERT_EQ(-i, res[0]);
+      }
+      for (int w = 0; w < num_writers; w++) {
+        int gone = removed[w].load();
+        int present = inserted[w].load();
+        for (int i = gone; i < present; i += 7) {
+          res.clear();
+          ASSERT_TRUE(ht.GetValue(nullptr, first_key(w) + i, &res) || i < removing[w].load());
+        }
+        for (int i = 0; i < gone; i += 7) {
+          res.clear();
+          ASSERT_FALSE(ht.GetValue(nullptr, first_key(w) + i, &res));
+        }
+      }
+      if (depths->size() == 1) {
+        readers_ready++;
+      }
+    }
+  };
+  auto run = [&](const std::function<void(int)> &write, std::vector<std::vector<uint32_t>> *depths) {
+    readers_ready = 0;
+    done = false;
+    std::vector<std::thread> threads;
+    for (int r = 0; r < num_readers; r++) {
+      threads.emplace_back(read, &(*depths)[r]);
+    }
+    std::vector<std::thread> writers;
+    for (int w = 0; w < num_writers; w++) {
+      writers.emplace_back([&, w] {
+        while (readers_ready.load() < num_readers) {
+          std::this_thread::yield();
+        }
+        write(w);
+      });
+    }
+    for (auto &thread : writers) {
+      thread.join();
+    }
+    done = true;
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  };
+
+  std::vector<std::vector<uint32_t>> depths(num_readers);
+  run(
+      [&](int w) {
+        for (int i = 0; i < keys_per_writer; i++) {
+          EXPECT_TRUE(ht.Insert(nullptr, first_key(w) + i, i));
+          inserted[w]++;
+        }
+      },
+      &depths);
+  ht.VerifyIntegrity();
+  uint32_t grown_depth = ht.GetGlobalDepth();
+  EXPECT_GE(grown_depth, 6);
+  for (auto &seen : depths) {
+    EXPECT_EQ(0, seen.front());
+    EXPECT_EQ(grown_depth, seen.back());
+    EXPECT_TRUE(std::is_sorted(seen.begin(), seen.end()));
+  }
+
+  for (auto &seen : depths) {
+    seen.clear();
+  }
+  run(
+      [&](int w) {
+        for (int i = 0; i < keys_per_writer; i++) {
+          removing[w]++;
+          EXPECT_TRUE(ht.Remove(nullptr, first_key(w) + i, i));
+          removed[w]++;
+        }
+      },
+      &depths);
+  ht.VerifyIntegrity();
+  // 剩下的fixed key分散在各个bucket里，能合并多少取决于它们的hash
+  for (auto &seen : depths) {
+    EXPECT_EQ(grown_depth, seen.front());
+    EXPECT_EQ(ht.GetGlobalDepth(), seen.back());
+    EXPECT_TRUE(std::is_sorted(seen.rbegin(), seen.rend()));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+}  // namespace bustub
@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_bench_test.cpp
+//
+// Identification: test/container/hash_table_bench_test.cpp
+//
+// Timings of batched against one by one lookups, kept out of the unit tests.
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "container/hash/linear_probe_hash_table.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+/*
+ * Benchmark: the same random probes through GetValue in a loop and through
+ * one GetValues call, a quarter of them missing.
+ */
+// NOLINTNEXTLINE
+TEST(HashTableBenchTest, BatchLookupBenchmark) {
+  const int num_keys = 100000;
+  const int num_probes = 100000;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(256, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 2 * num_keys, HashFunction<int>());
+  for (int key = 0; key < num_keys; key++) {
+    ht.Insert(nullptr, key, key);
+  }
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<int> dist(0, num_keys + num_keys / 3);
+  std::vector<int> probes(num_probes);
+  for (auto &probe : probes) {
+    probe = dist(rng);
+  }
+
+  auto start = std::chrono::high_resolution_clock::now();
+  size_t single_found = 0;
+  std::vector<int> res;
+  for (int probe : probes) {
+    res.clear();
+    single_found += ht.GetValue(nullptr, probe, &res) ? 1 : 0;
+  }
+  auto mid = std::chrono::high_resolution_clock::now();
+  std::vector<std::vector<int>> results;
+  size_t batch_found = ht.GetValues(nullptr, probes, &results);
+  auto end = std::chrono::high_resolution_clock::now();
+  EXPECT_EQ(single_found, batch_found);
+
+  auto ns = [](auto duration) { return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(); };
+  std::cout << "GetValue: " << static_cast<double>(ns(mid - start)) / num_probes << " ns/key" << std::endl;
+  std::cout << "GetValues: " << static_cast<double>(ns(end - mid)) / num_probes << " ns/key" << std::endl;
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+}  // namespace bustub
@@ -23,7 +23,7 @@
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_HeaderPageSampleTest) {
+TEST(HashTablePageTest, HeaderPageSampleTest) {
   DiskManager *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(5, disk_manager);
 
@@ -61,19 +61,19 @@ TEST(HashTablePageTest, DISABLED_HeaderPageSampleTest) {
 }
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_BlockPageSampleTest) {
+TEST(HashTablePageTest, BlockPageSampleTest) {
   DiskManager *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(5, disk_manager);
 
   // get a block page from the BufferPoolManager
   page_id_t block_page_id = INVALID_PAGE_ID;
 
-  auto block_page =
-      reinterpret_cast<HashTableBlockPage<int, int, IntComparator> *>(bpm->NewPage(&block_page_id, nullptr)->GetData());
+  using BlockPage = HashTableBlockPage<int, int, IntComparator>;
+  auto block_page = reinterpret_cast<BlockPage *>(bpm->NewPage(&block_page_id, nullptr)->GetData());
 
-  // insert a few (key, value) pairs
+  // insert a few (key, value) pairs, with the tags of hashes 0..9 << 57
   for (unsigned i = 0; i < 10; i++) {
-    block_page->Insert(i, i, i);
+    block_page->Insert(i, i, i, BlockPage::HashTag(static_cast<uint64_t>(i) << 57));
   }
 
   // check for the inserted pairs
@@ -103,6 +103,18 @@ TEST(HashTablePageTest, DISABLED_BlockPageSampleTest) {
     }
   }
 
+  // tag matching over a group of slots
+  EXPECT_EQ(1U << 4, block_page->MatchTag(0, BlockPage::HashTag(static_cast<uint64_t>(4) << 57)));
+  EXPECT_EQ(0U, block_page->MatchTag(0, BlockPage::HashTag(static_cast<uint64_t>(5) << 57)));
+  EXPECT_EQ(0x2AAU, block_page->MatchTag(0, BlockPage::TAG_TOMBSTONE));
+  EXPECT_EQ(0xFC00U, block_page->MatchEmpty(0));
+  EXPECT_EQ(0xFFFFU, block_page->MatchEmpty(16));
+  // the last group of the block is cut short
+  using KeyType = int;
+  using ValueType = int;
+  slot_offset_t last = BLOCK_ARRAY_SIZE - 3;
+  EXPECT_EQ(0x7U, block_page->MatchEmpty(last));
+
   // unpin the header page now that we are done
   bpm->UnpinPage(block_page_id, true, nullptr);
   disk_manager->ShutDown();
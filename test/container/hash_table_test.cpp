@@ -10,6 +10,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <atomic>
 #include <thread>  // NOLINT
 #include <vector>
 
@@ -17,11 +19,12 @@
 #include "container/hash/linear_probe_hash_table.h"
 #include "gtest/gtest.h"
 #include "murmur3/MurmurHash3.h"
+#include "storage/index/generic_key.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(HashTableTest, DISABLED_SampleTest) {
+TEST(HashTableTest, SampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(50, disk_manager);
 
@@ -104,4 +107,237 @@ TEST(HashTableTest, DISABLED_SampleTest) {
   delete bpm;
 }
 
+/*
+ * A table of 10 buckets grows to hold thousands of pairs through several
+ * incremental resizes; every pair stays visible at every step, also to
+ * readers running next to the writer.
+ */
+// NOLINTNEXTLINE
+TEST(HashTableTest, IncrementalResizeTest) {
+  const int num_keys = 5000;
+  const int num_readers = 2;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 10, HashFunction<int>());
+
+  std::atomic<int> inserted{0};
+  std::atomic<int> failures{0};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < num_readers; i++) {
+    readers.emplace_back([&] {
+      while (inserted.load() < num_keys) {
+        // 已经插入的key，不管正在搬迁到哪边都必须能查到
+        int upto = inserted.load();
+        for (int key = 0; key < upto; key += 7) {
+          std::vector<int> res;
+          if (!ht.GetValue(nullptr, key, &res) || res.size() != 1 || res[0] != key) {
+            failures++;
+          }
+        }
+      }
+    });
+  }
+  for (int key = 0; key < num_keys; key++) {
+    EXPECT_TRUE(ht.Insert(nullptr, key, key));
+    inserted++;
+  }
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(0, failures.load());
+  EXPECT_GE(ht.GetSize(), static_cast<size_t>(num_keys));
+
+  // duplicates are caught whether the pair was migrated yet or not
+  for (int key = 0; key < num_keys; key += 3) {
+    EXPECT_FALSE(ht.Insert(nullptr, key, key));
+    EXPECT_TRUE(ht.Remove(nullptr, key, key));
+  }
+  for (int key = 0; key < num_keys; key++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, key, &res);
+    if (key % 3 == 0) {
+      EXPECT_EQ(0, res.size());
+    } else {
+      ASSERT_EQ(1, res.size());
+      EXPECT_EQ(key, res[0]);
+    }
+  }
+
+  // an explicit resize keeps the table as it is
+  ht.Resize(ht.GetSize());
+  for (int key = 1; key < num_keys; key += 3) {
+    EXPECT_TRUE(ht.Remove(nullptr, key, key));
+    EXPECT_FALSE(ht.Remove(nullptr, key, key));
+  }
+  for (int key = 0; key < num_keys; key++) {
+    std::vector<int> res;
+    EXPECT_EQ(key % 3 == 2, ht.GetValue(nullptr, key, &res));
+  }
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+/*
+ * Wide keys spread over many small block pages: the tag groups are cut at
+ * block ends and the probe sequences wrap around the table.
+ */
+// NOLINTNEXTLINE
+TEST(HashTableTest, GenericKeyTest) {
+  const int num_keys = 3000;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  Schema key_schema({Column("a", TypeId::BIGINT)});
+  GenericComparator<64> comparator(&key_schema);
+
+  LinearProbeHashTable<GenericKey<64>, RID, GenericComparator<64>> ht("blah", bpm, comparator, 100,
+                                                                      HashFunction<GenericKey<64>>());
+  GenericKey<64> index_key;
+  for (int key = 0; key < num_keys; key++) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(ht.Insert(nullptr, index_key, RID(key, key)));
+  }
+  for (int key = 0; key < num_keys; key += 2) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(ht.Remove(nullptr, index_key, RID(key, key)));
+  }
+  for (int key = 0; key < num_keys + 100; key++) {
+    index_key.SetFromInteger(key);
+    std::vector<RID> res;
+    ASSERT_EQ(key % 2 == 1 && key < num_keys, ht.GetValue(nullptr, index_key, &res));
+    if (!res.empty()) {
+      ASSERT_EQ(1, res.size());
+      EXPECT_EQ(RID(key, key), res[0]);
+    }
+  }
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+/*
+ * Writers race on the same pairs while the table grows from 10 buckets:
+ * each pair is inserted and removed exactly once, and a reader running next
+ * to them never sees a pair twice.
+ */
+// NOLINTNEXTLINE
+TEST(HashTableTest, ConcurrentWritersTest) {
+  const int num_writers = 4;
+  const int num_keys = 4000;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 10, HashFunction<int>());
+
+  std::atomic<int> inserted{0};
+  std::atomic<int> removed{0};
+  std::atomic<int> finished{0};
+  std::atomic<bool> done{false};
+  std::atomic<int> failures{0};
+  // the keys below num_keys / 2 are never removed
+  std::thread reader([&] {
+    while (!done.load()) {
+      for (int key = 0; key < num_keys / 2; key += 13) {
+        std::vector<int> res;
+        bool found = ht.GetValue(nullptr, key, &res);
+        if (found && (res.size() != 1 || res[0] != key)) {
+          failures++;
+        }
+      }
+    }
+  });
+  std::vector<std::thread> writers;
+  for (int t = 0; t < num_writers; t++) {
+    writers.emplace_back([&, t] {
+      // 每个writer从不同的位置开始，同一个pair会被几个writer同时插入
+      for (int i = 0; i < num_keys; i++) {
+        int key = (i + t * num_keys / num_writers) % num_keys;
+        if (ht.Insert(nullptr, key, key)) {
+          inserted++;
+        }
+      }
+      // 所有insert结束后才开始remove，否则被remove的pair会被慢的writer再插入一次
+      finished++;
+      while (finished.load() < num_writers) {
+        std::this_thread::yield();
+      }
+      for (int i = 0; i < num_keys; i++) {
+        int key = (i + t * num_keys / num_writers) % num_keys;
+        if (key >= num_keys / 2 && ht.Remove(nullptr, key, key)) {
+          removed++;
+        }
+      }
+    });
+  }
+  for (auto &writer : writers) {
+    writer.join();
+  }
+  done = true;
+  reader.join();
+  EXPECT_EQ(num_keys, inserted.load());
+  EXPECT_EQ(num_keys / 2, removed.load());
+  EXPECT_EQ(0, failures.load());
+  for (int key = 0; key < num_keys; key++) {
+    std::vector<int> res;
+    ASSERT_EQ(key < num_keys / 2, ht.GetValue(nullptr, key, &res)) << key;
+  }
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+/*
+ * Batched lookups agree with one GetValue per key, in any key order, with
+ * non-unique keys, missing keys and keys repeated within the batch, also
+ * while a resize is half way through.
+ */
+// NOLINTNEXTLINE
+TEST(HashTableTest, BatchLookupTest) {
+  const int num_keys = 10000;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+  for (int key = 0; key < num_keys; key++) {
+    EXPECT_TRUE(ht.Insert(nullptr, key, key));
+    if (key % 4 == 0 && key != 0) {
+      EXPECT_TRUE(ht.Insert(nullptr, key, -key));
+    }
+  }
+  std::vector<int> keys;
+  for (int key = num_keys + 500; key >= 0; key -= 3) {
+    keys.push_back(key);
+    keys.push_back(key / 2);
+  }
+
+  for (int round = 0; round < 2; round++) {
+    std::vector<std::vector<int>> results;
+    size_t found = ht.GetValues(nullptr, keys, &results);
+    ASSERT_EQ(keys.size(), results.size());
+    size_t expected_found = 0;
+    for (size_t i = 0; i < keys.size(); i++) {
+      std::vector<int> res;
+      expected_found += ht.GetValue(nullptr, keys[i], &res) ? 1 : 0;
+      std::sort(res.begin(), res.end());
+      std::sort(results[i].begin(), results[i].end());
+      ASSERT_EQ(res, results[i]);
+      EXPECT_EQ(keys[i] >= num_keys ? 0 : keys[i] % 4 == 0 && keys[i] != 0 ? 2 : 1, results[i].size());
+    }
+    EXPECT_EQ(expected_found, found);
+    // 第二轮：旧表只搬了一部分
+    ht.Resize(ht.GetSize());
+    for (int key = 0; key < 10; key++) {
+      EXPECT_TRUE(ht.Insert(nullptr, num_keys + 1000 * (round + 1) + key, key));
+    }
+  }
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 }  // namespace bustub
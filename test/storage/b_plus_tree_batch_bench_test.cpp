@@ -0,0 +1,78 @@
+/**
+ * b_plus_tree_batch_bench_test.cpp
+ *
+ * Timing of batched against one by one point lookups, kept out of the unit tests.
+ */
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+
+namespace bustub {
+
+using IntegerTree = BPlusTree<GenericKey<8>, RID, GenericIntegerComparator<8>>;
+
+/*
+ * Benchmark: an IN-list style probe of 10% of the keys, one GetValue per key
+ * against one GetValues call.
+ */
+TEST(BPlusTreeBatchBenchTest, BatchBenchmark) {
+  GenericIntegerComparator<8> comparator;
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(256, disk_manager);
+  IntegerTree tree("foo_pk", bpm, comparator);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+
+  const int64_t num_keys = 100000;
+  std::vector<std::pair<GenericKey<8>, RID>> entries(num_keys);
+  for (int64_t key = 0; key < num_keys; key++) {
+    entries[key].first.SetFromInteger(key);
+    entries[key].second = RID(0, static_cast<uint32_t>(key));
+  }
+  EXPECT_EQ(tree.InsertBatch(entries), num_keys);
+
+  std::mt19937_64 rng(0);
+  std::vector<GenericKey<8>> probes(num_keys / 10);
+  for (auto &probe : probes) {
+    probe.SetFromInteger(static_cast<int64_t>(rng() % num_keys));
+  }
+
+  auto start = std::chrono::high_resolution_clock::now();
+  std::vector<RID> rids;
+  int64_t single_sum = 0;
+  for (auto &probe : probes) {
+    rids.clear();
+    tree.GetValue(probe, &rids);
+    single_sum += rids[0].GetSlotNum();
+  }
+  auto mid = std::chrono::high_resolution_clock::now();
+  std::vector<std::vector<RID>> results;
+  tree.GetValues(probes, &results);
+  auto end = std::chrono::high_resolution_clock::now();
+  int64_t batch_sum = 0;
+  for (auto &result : results) {
+    batch_sum += result[0].GetSlotNum();
+  }
+  EXPECT_EQ(single_sum, batch_sum);
+
+  auto ns = [](auto duration) { return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(); };
+  std::cout << "GetValue: " << static_cast<double>(ns(mid - start)) / probes.size() << " ns/key" << std::endl;
+  std::cout << "GetValues: " << static_cast<double>(ns(end - mid)) / probes.size() << " ns/key" << std::endl;
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
@@ -0,0 +1,134 @@
+/**
+ * b_plus_tree_batch_test.cpp
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+
+namespace bustub {
+
+using IntegerTree = BPlusTree<GenericKey<8>, RID, GenericIntegerComparator<8>>;
+
+// every page but the header must be unpinned after a batch, or NewPage fails
+static void CheckNoPinnedPages(BufferPoolManager *bpm, size_t pool_size) {
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < pool_size - 1; i++) {
+    page_id_t page_id;
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id));
+    page_ids.push_back(page_id);
+  }
+  for (auto page_id : page_ids) {
+    bpm->UnpinPage(page_id, false);
+  }
+}
+
+TEST(BPlusTreeBatchTest, InsertBatchAndGetValues) {
+  const size_t pool_size = 50;
+  GenericIntegerComparator<8> comparator;
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(pool_size, disk_manager);
+  IntegerTree tree("foo_pk", bpm, comparator, 8, 8);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+
+  // even keys only, inserted in two shuffled batches, with repeated keys
+  std::mt19937 rng(0);
+  std::vector<std::pair<GenericKey<8>, RID>> entries;
+  for (int64_t key = 0; key < 2000; key += 2) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(key);
+    entries.emplace_back(index_key, RID(0, static_cast<uint32_t>(key)));
+  }
+  std::shuffle(entries.begin(), entries.end(), rng);
+  std::vector<std::pair<GenericKey<8>, RID>> first(entries.begin(), entries.begin() + 600);
+  std::vector<std::pair<GenericKey<8>, RID>> second(entries.begin() + 500, entries.end());
+  EXPECT_EQ(tree.InsertBatch(first), 600);
+  EXPECT_EQ(tree.InsertBatch(second), 400);
+  CheckNoPinnedPages(bpm, pool_size);
+
+  int64_t current_key = 0;
+  for (auto &pair : tree) {
+    EXPECT_EQ(pair.second.GetSlotNum(), current_key);
+    current_key += 2;
+  }
+  EXPECT_EQ(current_key, 2000);
+
+  // present and missing keys, unsorted, with repeats
+  std::vector<GenericKey<8>> probes(3000);
+  for (auto &probe : probes) {
+    probe.SetFromInteger(static_cast<int64_t>(rng() % 2100));
+  }
+  std::vector<std::vector<RID>> results;
+  tree.GetValues(probes, &results);
+  CheckNoPinnedPages(bpm, pool_size);
+  ASSERT_EQ(results.size(), probes.size());
+  for (size_t i = 0; i < probes.size(); i++) {
+    int64_t key = probes[i].ToString();
+    if (key % 2 == 0 && key < 2000) {
+      ASSERT_EQ(results[i].size(), 1);
+      EXPECT_EQ(results[i][0].GetSlotNum(), key);
+    } else {
+      EXPECT_TRUE(results[i].empty());
+    }
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeBatchTest, NonUniqueGetValues) {
+  const size_t pool_size = 50;
+  GenericIntegerComparator<8> comparator;
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(pool_size, disk_manager);
+  IntegerTree tree("foo_idx", bpm, comparator, 4, 4);
+  tree.SetUniqueKeys(false);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+
+  // key k has k % 7 + 1 rids
+  std::vector<std::pair<GenericKey<8>, RID>> entries;
+  for (int64_t key = 0; key < 100; key++) {
+    for (int64_t i = 0; i <= key % 7; i++) {
+      GenericKey<8> index_key;
+      index_key.SetFromInteger(key);
+      entries.emplace_back(index_key, RID(static_cast<page_id_t>(key), static_cast<uint32_t>(i)));
+    }
+  }
+  std::shuffle(entries.begin(), entries.end(), std::mt19937(1));
+  EXPECT_EQ(tree.InsertBatch(entries), static_cast<int>(entries.size()));
+
+  std::vector<GenericKey<8>> probes(110);
+  for (int64_t key = 0; key < 110; key++) {
+    probes[109 - key].SetFromInteger(key);
+  }
+  std::vector<std::vector<RID>> results;
+  tree.GetValues(probes, &results);
+  CheckNoPinnedPages(bpm, pool_size);
+  for (size_t i = 0; i < probes.size(); i++) {
+    int64_t key = probes[i].ToString();
+    EXPECT_EQ(results[i].size(), key < 100 ? key % 7 + 1 : 0);
+    for (auto &rid : results[i]) {
+      EXPECT_EQ(rid.GetPageId(), key);
+    }
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
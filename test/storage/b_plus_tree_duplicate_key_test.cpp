@@ -0,0 +1,281 @@
+/**
+ * b_plus_tree_duplicate_key_test.cpp
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+TEST(BPlusTreeDuplicateKeyTest, InsertLookupRemove) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // small pages, so that runs of one key span several leaves
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_idx", bpm, comparator, 4, 4);
+  tree.SetUniqueKeys(false);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+
+  // 5 distinct keys, 30 rids each
+  const int num_keys = 5;
+  const int rids_per_key = 30;
+  std::vector<std::pair<int64_t, int>> entries;
+  for (int64_t key = 0; key < num_keys; key++) {
+    for (int slot = 0; slot < rids_per_key; slot++) {
+      entries.emplace_back(key, slot);
+    }
+  }
+  std::shuffle(entries.begin(), entries.end(), std::mt19937(0));
+  GenericKey<8> index_key;
+  for (auto &entry : entries) {
+    index_key.SetFromInteger(entry.first);
+    EXPECT_TRUE(tree.Insert(index_key, RID(static_cast<page_id_t>(entry.first), entry.second)));
+  }
+
+  std::vector<RID> rids;
+  for (int64_t key = 0; key < num_keys; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.GetValue(index_key, &rids));
+    EXPECT_EQ(rids.size(), rids_per_key);
+    for (auto &rid : rids) {
+      EXPECT_EQ(rid.GetPageId(), key);
+    }
+  }
+  rids.clear();
+  index_key.SetFromInteger(num_keys);
+  EXPECT_FALSE(tree.GetValue(index_key, &rids));
+
+  // the iterator sees every entry, in key order
+  int64_t count = 0;
+  int64_t last_key = 0;
+  for (auto &pair : tree) {
+    EXPECT_LE(last_key, pair.second.GetPageId());
+    last_key = pair.second.GetPageId();
+    count++;
+  }
+  EXPECT_EQ(count, num_keys * rids_per_key);
+
+  // remove the even slots of every key by exact pair
+  std::shuffle(entries.begin(), entries.end(), std::mt19937(1));
+  for (auto &entry : entries) {
+    if (entry.second % 2 == 0) {
+      index_key.SetFromInteger(entry.first);
+      EXPECT_TRUE(tree.Remove(index_key, RID(static_cast<page_id_t>(entry.first), entry.second)));
+    }
+  }
+  index_key.SetFromInteger(0);
+  EXPECT_FALSE(tree.Remove(index_key, RID(0, 0)));
+  for (int64_t key = 0; key < num_keys; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.GetValue(index_key, &rids));
+    EXPECT_EQ(rids.size(), rids_per_key / 2);
+    for (auto &rid : rids) {
+      EXPECT_EQ(rid.GetSlotNum() % 2, 1);
+    }
+  }
+
+  // Remove(key) drops one entry of the key at a time
+  for (int64_t key = 0; key < num_keys; key++) {
+    index_key.SetFromInteger(key);
+    for (int i = 0; i < rids_per_key / 2; i++) {
+      tree.Remove(index_key);
+    }
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeDuplicateKeyTest, NonUniqueIndex) {
+  Schema *table_schema = ParseCreateStatement("a bigint");
+  IndexMetadata *metadata = new IndexMetadata("foo_idx", "foo", table_schema, {0}, false);
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  // the index owns the metadata
+  auto *index = new BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>>(metadata, bpm);
+
+  std::vector<Value> values{ValueFactory::GetBigIntValue(7)};
+  Tuple key(values, table_schema);
+  for (uint32_t slot = 0; slot < 100; slot++) {
+    index->InsertEntry(key, RID(1, slot), nullptr);
+  }
+  std::vector<RID> rids;
+  index->ScanKey(key, &rids, nullptr);
+  EXPECT_EQ(rids.size(), 100);
+
+  index->DeleteEntry(key, RID(1, 42), nullptr);
+  rids.clear();
+  index->ScanKey(key, &rids, nullptr);
+  EXPECT_EQ(rids.size(), 99);
+  EXPECT_EQ(std::find(rids.begin(), rids.end(), RID(1, 42)), rids.end());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete index;
+  delete table_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+// equal keys come back in RID order whatever the insertion order, and exact deletes find their pair in any leaf
+TEST(BPlusTreeDuplicateKeyTest, RidOrder) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericIntegerComparator<8> comparator(key_schema);
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericIntegerComparator<8>> tree("foo_idx", bpm, comparator, 4, 4);
+  tree.SetUniqueKeys(false);
+  tree.SetInterpolationSearch(true);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+
+  // 3 keys, 200 rids each spread over several pages, every key runs across dozens of leaves
+  const int num_keys = 3;
+  const int rids_per_key = 200;
+  std::vector<std::pair<int64_t, RID>> entries;
+  for (int64_t key = 0; key < num_keys; key++) {
+    for (int i = 0; i < rids_per_key; i++) {
+      entries.emplace_back(key, RID(i % 7, i));
+    }
+  }
+  std::shuffle(entries.begin(), entries.end(), std::mt19937(2));
+  GenericKey<8> index_key;
+  for (auto &entry : entries) {
+    index_key.SetFromInteger(entry.first);
+    EXPECT_TRUE(tree.Insert(index_key, entry.second));
+  }
+
+  std::vector<RID> rids;
+  for (int64_t key = 0; key < num_keys; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.GetValue(index_key, &rids));
+    ASSERT_EQ(rids.size(), rids_per_key);
+    for (size_t i = 1; i < rids.size(); i++) {
+      EXPECT_LT(rids[i - 1].Get(), rids[i].Get());
+    }
+  }
+  int64_t count = 0;
+  std::pair<int64_t, int64_t> last{-1, 0};
+  for (auto &pair : tree) {
+    std::pair<int64_t, int64_t> current{GenericIntegerComparator<8>::ToInteger(pair.first), pair.second.Get()};
+    EXPECT_LT(last, current);
+    last = current;
+    count++;
+  }
+  EXPECT_EQ(count, num_keys * rids_per_key);
+
+  // exact deletes in random order, a missing pair in the middle of a run is not found
+  std::shuffle(entries.begin(), entries.end(), std::mt19937(3));
+  for (auto &entry : entries) {
+    if (entry.second.GetSlotNum() % 3 != 0) {
+      index_key.SetFromInteger(entry.first);
+      EXPECT_TRUE(tree.Remove(index_key, entry.second));
+      EXPECT_FALSE(tree.Remove(index_key, entry.second));
+    }
+  }
+  for (int64_t key = 0; key < num_keys; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.GetValue(index_key, &rids));
+    ASSERT_EQ(rids.size(), (rids_per_key + 2) / 3);
+    for (size_t i = 0; i < rids.size(); i++) {
+      EXPECT_EQ(rids[i].GetSlotNum() % 3, 0);
+      if (i > 0) {
+        EXPECT_LT(rids[i - 1].Get(), rids[i].Get());
+      }
+    }
+  }
+
+  // Remove(key) drops the pair with the smallest RID
+  index_key.SetFromInteger(1);
+  tree.Remove(index_key);
+  rids.clear();
+  EXPECT_TRUE(tree.GetValue(index_key, &rids));
+  EXPECT_EQ(std::find(rids.begin(), rids.end(), RID(0, 0)), rids.end());
+  EXPECT_EQ(rids.size(), (rids_per_key + 2) / 3 - 1);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+// BulkLoad and InsertBatch order the pairs of a key by RID as well
+TEST(BPlusTreeDuplicateKeyTest, BulkLoadAndBatchRidOrder) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> loaded("loaded_idx", bpm, comparator, 4, 4);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> batched("batched_idx", bpm, comparator, 4, 4);
+  loaded.SetUniqueKeys(false);
+  batched.SetUniqueKeys(false);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+
+  // sorted by key, RIDs of a key descending
+  const int num_keys = 4;
+  const int rids_per_key = 50;
+  std::vector<std::pair<GenericKey<8>, RID>> entries;
+  GenericKey<8> index_key;
+  for (int64_t key = 0; key < num_keys; key++) {
+    index_key.SetFromInteger(key);
+    for (int slot = rids_per_key - 1; slot >= 0; slot--) {
+      entries.emplace_back(index_key, RID(1, slot));
+    }
+  }
+  EXPECT_EQ(batched.InsertBatch(entries), num_keys * rids_per_key);
+  EXPECT_TRUE(loaded.BulkLoad(&entries));
+
+  std::vector<RID> rids;
+  for (auto *tree : {&loaded, &batched}) {
+    for (int64_t key = 0; key < num_keys; key++) {
+      rids.clear();
+      index_key.SetFromInteger(key);
+      EXPECT_TRUE(tree->GetValue(index_key, &rids));
+      ASSERT_EQ(rids.size(), rids_per_key);
+      for (int slot = 0; slot < rids_per_key; slot++) {
+        EXPECT_EQ(rids[slot], RID(1, slot));
+      }
+    }
+    // every pair is reached by its exact delete
+    for (auto &entry : entries) {
+      EXPECT_TRUE(tree->Remove(entry.first, entry.second));
+    }
+    EXPECT_TRUE(tree->IsEmpty());
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
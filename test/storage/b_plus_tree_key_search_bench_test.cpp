@@ -0,0 +1,122 @@
+/**
+ * b_plus_tree_key_search_bench_test.cpp
+ *
+ * Timings of the leaf key search kernels, kept out of the unit tests.
+ */
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "b_plus_tree_key_search_test_util.h"  // NOLINT
+#include "b_plus_tree_test_util.h"             // NOLINT
+#include "gtest/gtest.h"
+#include "storage/page/b_plus_tree_internal_page.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+
+namespace bustub {
+
+// Same semantics as GenericIntegerComparator, but a distinct type, so the search falls back to the plain binary search
+class ScalarIntegerComparator {
+ public:
+  inline int operator()(const GenericKey<8> &lhs, const GenericKey<8> &rhs) const { return comparator_(lhs, rhs); }
+
+ private:
+  GenericIntegerComparator<8> comparator_;
+};
+
+template <typename ValueType, typename KeyComparator>
+int64_t RunLowerBounds(const std::vector<std::pair<GenericKey<8>, ValueType>> &entries,
+                       const std::vector<GenericKey<8>> &probes, const KeyComparator &comparator) {
+  int64_t checksum = 0;
+  for (const auto &probe : probes) {
+    checksum += BPlusTreeKeySearch<GenericKey<8>, ValueType, KeyComparator>::LowerBound(
+        entries.data(), 0, static_cast<int>(entries.size()), probe, comparator);
+  }
+  return checksum;
+}
+
+/*
+ * Benchmark: lower bound over a full leaf page of BIGINT keys, using
+ * (1) GenericComparator binary search (the default index comparator),
+ * (2) integer binary search, and (3) the integer SIMD kernel.
+ */
+TEST(BPlusTreeKeySearchBenchTest, SearchBenchmark) {
+  const int num_probes = 200000;
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> generic_comparator(key_schema);
+  ScalarIntegerComparator scalar_comparator;
+  GenericIntegerComparator<8> simd_comparator;
+
+  auto entries = MakeSortedEntries<LeafPair>(FULL_LEAF_SIZE, 2);
+  std::mt19937_64 rng(0);
+  std::vector<GenericKey<8>> probes(num_probes);
+  for (auto &probe : probes) {
+    probe.SetFromInteger(static_cast<int64_t>(rng() % (FULL_LEAF_SIZE * 2)));
+  }
+
+  auto time = [](const char *name, size_t count, auto &&run) {
+    auto start = std::chrono::high_resolution_clock::now();
+    int64_t checksum = run();
+    auto end = std::chrono::high_resolution_clock::now();
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    std::cout << name << ": " << static_cast<double>(ns) / count << " ns/lookup" << std::endl;
+    return checksum;
+  };
+
+  // GenericComparator is far slower, a tenth of the probes is enough to compare
+  std::vector<GenericKey<8>> generic_probes(probes.begin(), probes.begin() + num_probes / 10);
+  int64_t generic_sum = time("generic binary search", generic_probes.size(),
+                             [&] { return RunLowerBounds(entries, generic_probes, generic_comparator); });
+  int64_t scalar_sum =
+      time("integer binary search", probes.size(), [&] { return RunLowerBounds(entries, probes, scalar_comparator); });
+  int64_t simd_sum =
+      time("integer simd search", probes.size(), [&] { return RunLowerBounds(entries, probes, simd_comparator); });
+
+  EXPECT_EQ(scalar_sum, simd_sum);
+  EXPECT_EQ(generic_sum, RunLowerBounds(entries, generic_probes, simd_comparator));
+  delete key_schema;
+}
+
+/*
+ * Benchmark: lower bound over a full leaf page of BIGINT keys with the integer
+ * SIMD binary search and with interpolation search, on evenly spread keys and
+ * on a Zipfian key set, where interpolation keeps missing and falls back.
+ */
+TEST(BPlusTreeKeySearchBenchTest, InterpolationBenchmark) {
+  const int num_probes = 200000;
+  GenericIntegerComparator<8> binary_comparator;
+  GenericIntegerComparator<8> interpolation_comparator;
+  interpolation_comparator.SetInterpolationSearch(true);
+
+  std::mt19937_64 rng(0);
+  std::vector<std::pair<const char *, std::vector<LeafPair>>> key_sets;
+  key_sets.emplace_back("uniform", MakeSortedEntries<LeafPair>(FULL_LEAF_SIZE, 2));
+  key_sets.emplace_back("zipfian", MakeZipfianEntries(FULL_LEAF_SIZE, 1000000, &rng));
+
+  for (const auto &key_set : key_sets) {
+    const auto &entries = key_set.second;
+    // probe the keys of the page, the common case of an index lookup
+    std::vector<GenericKey<8>> probes(num_probes);
+    for (auto &probe : probes) {
+      probe = entries[rng() % entries.size()].first;
+    }
+    auto time = [&](const char *name, const GenericIntegerComparator<8> &comparator) {
+      auto start = std::chrono::high_resolution_clock::now();
+      int64_t checksum = RunLowerBounds(entries, probes, comparator);
+      auto end = std::chrono::high_resolution_clock::now();
+      auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+      std::cout << key_set.first << " keys, " << name << ": " << static_cast<double>(ns) / num_probes << " ns/lookup"
+                << std::endl;
+      return checksum;
+    };
+    int64_t binary_sum = time("binary search", binary_comparator);
+    int64_t interpolation_sum = time("interpolation search", interpolation_comparator);
+    EXPECT_EQ(binary_sum, interpolation_sum);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,183 @@
+/**
+ * b_plus_tree_key_search_test.cpp
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "b_plus_tree_key_search_test_util.h"  // NOLINT
+#include "b_plus_tree_test_util.h"             // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/page/b_plus_tree_internal_page.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+
+namespace bustub {
+
+TEST(BPlusTreeKeySearchTest, MatchesStdBounds) {
+  std::mt19937_64 rng(15445);
+  GenericIntegerComparator<8> comparator;
+  // sizes around the SIMD window and its lane count, plus a full leaf/internal page
+  std::vector<size_t> sizes = {0, 1, 2, 3, 4, 5, 15, 16, 17, 33, FULL_LEAF_SIZE};
+  for (size_t size : sizes) {
+    auto leaf_entries = MakeSortedEntries<LeafPair>(size, 3);
+    auto internal_entries = MakeSortedEntries<InternalPair>(size, 3);
+    auto less = [&comparator](const auto &entry, const GenericKey<8> &key) { return comparator(entry.first, key) < 0; };
+    auto greater = [&comparator](const GenericKey<8> &key, const auto &entry) {
+      return comparator(key, entry.first) < 0;
+    };
+
+    std::vector<int64_t> targets = {INT64_MIN, INT64_MAX, -1, 0};
+    for (int i = 0; i < 200; i++) {
+      targets.push_back(static_cast<int64_t>(rng() % (size * 3 + 4)) - 1);
+    }
+    for (int64_t target : targets) {
+      GenericKey<8> key;
+      key.SetFromInteger(target);
+      int n = static_cast<int>(size);
+
+      int expected_lower = std::lower_bound(leaf_entries.begin(), leaf_entries.end(), key, less) - leaf_entries.begin();
+      int expected_upper = std::upper_bound(leaf_entries.begin(), leaf_entries.end(), key, greater) - leaf_entries.begin();
+      EXPECT_EQ(expected_lower, (BPlusTreeKeySearch<GenericKey<8>, RID, GenericIntegerComparator<8>>::LowerBound(
+                                    leaf_entries.data(), 0, n, key, comparator)));
+      EXPECT_EQ(expected_upper, (BPlusTreeKeySearch<GenericKey<8>, RID, GenericIntegerComparator<8>>::UpperBound(
+                                    leaf_entries.data(), 0, n, key, comparator)));
+
+      // internal pages search from index 1, their entries use a 12 byte stride
+      if (size > 0) {
+        int internal_upper =
+            std::upper_bound(internal_entries.begin() + 1, internal_entries.end(), key, greater) -
+            internal_entries.begin();
+        EXPECT_EQ(internal_upper, (BPlusTreeKeySearch<GenericKey<8>, page_id_t, GenericIntegerComparator<8>>::UpperBound(
+                                      internal_entries.data(), 1, n, key, comparator)));
+      }
+    }
+  }
+}
+
+TEST(BPlusTreeKeySearchTest, InterpolationMatchesStdBounds) {
+  std::mt19937_64 rng(15445);
+  GenericIntegerComparator<8> comparator;
+  comparator.SetInterpolationSearch(true);
+  auto less = [&comparator](const auto &entry, const GenericKey<8> &key) { return comparator(entry.first, key) < 0; };
+  auto greater = [&comparator](const GenericKey<8> &key, const auto &entry) { return comparator(key, entry.first) < 0; };
+
+  // evenly spread, skewed, runs of equal keys, and keys across the whole int64 range
+  std::vector<std::vector<LeafPair>> key_sets;
+  key_sets.push_back(MakeSortedEntries<LeafPair>(FULL_LEAF_SIZE, 3));
+  key_sets.push_back(MakeZipfianEntries(FULL_LEAF_SIZE, 1000000, &rng));
+  key_sets.emplace_back(FULL_LEAF_SIZE);
+  for (size_t i = 0; i < FULL_LEAF_SIZE; i++) {
+    key_sets.back()[i].first.SetFromInteger(static_cast<int64_t>(i / 50) * 7);
+  }
+  key_sets.emplace_back(FULL_LEAF_SIZE);
+  for (size_t i = 0; i < FULL_LEAF_SIZE; i++) {
+    key_sets.back()[i].first.SetFromInteger(i == 0 ? INT64_MIN : (i + 1 == FULL_LEAF_SIZE ? INT64_MAX : i * 1000));
+  }
+
+  for (const auto &entries : key_sets) {
+    int n = static_cast<int>(entries.size());
+    std::vector<int64_t> targets = {INT64_MIN, INT64_MAX, -1, 0};
+    for (const auto &entry : entries) {
+      int64_t key = GenericIntegerComparator<8>::ToInteger(entry.first);
+      targets.push_back(key);
+      targets.push_back(key == INT64_MIN ? key : key - 1);
+      targets.push_back(key == INT64_MAX ? key : key + 1);
+    }
+    for (int64_t target : targets) {
+      GenericKey<8> key;
+      key.SetFromInteger(target);
+      int expected_lower = std::lower_bound(entries.begin(), entries.end(), key, less) - entries.begin();
+      int expected_upper = std::upper_bound(entries.begin(), entries.end(), key, greater) - entries.begin();
+      ASSERT_EQ(expected_lower, (BPlusTreeKeySearch<GenericKey<8>, RID, GenericIntegerComparator<8>>::LowerBound(
+                                    entries.data(), 0, n, key, comparator)));
+      ASSERT_EQ(expected_upper, (BPlusTreeKeySearch<GenericKey<8>, RID, GenericIntegerComparator<8>>::UpperBound(
+                                    entries.data(), 0, n, key, comparator)));
+    }
+  }
+}
+
+TEST(BPlusTreeKeySearchTest, LeafPageLookup) {
+  char buffer[PAGE_SIZE];
+  auto *leaf = reinterpret_cast<BPlusTreeLeafPage<GenericKey<8>, RID, GenericIntegerComparator<8>> *>(buffer);
+  GenericIntegerComparator<8> comparator;
+  leaf->Init(1, INVALID_PAGE_ID);
+
+  GenericKey<8> index_key;
+  std::vector<int64_t> keys;
+  for (int64_t key = static_cast<int64_t>(leaf->GetMaxSize()) - 1; key >= 0; key--) {
+    keys.push_back(key * 2);
+  }
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    leaf->Insert(index_key, RID(0, static_cast<uint32_t>(key)), comparator);
+  }
+  EXPECT_EQ(leaf->GetSize(), leaf->GetMaxSize());
+
+  RID rid;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(leaf->Lookup(index_key, &rid, comparator));
+    EXPECT_EQ(rid.GetSlotNum(), key);
+    index_key.SetFromInteger(key + 1);
+    EXPECT_FALSE(leaf->Lookup(index_key, &rid, comparator));
+    EXPECT_EQ(leaf->KeyIndex(index_key, comparator), key / 2 + 1);
+  }
+}
+
+TEST(BPlusTreeKeySearchTest, IntegerKeyTree) {
+  GenericIntegerComparator<8> comparator;
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericIntegerComparator<8>> tree("foo_pk", bpm, comparator, 16, 16);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+
+  GenericKey<8> index_key;
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= 1000; key++) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, RID(0, static_cast<uint32_t>(key))));
+  }
+
+  std::vector<RID> rids;
+  for (auto key : keys) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.GetValue(index_key, &rids));
+    EXPECT_EQ(rids[0].GetSlotNum(), key);
+  }
+  int64_t current_key = 1;
+  for (auto &pair : tree) {
+    EXPECT_EQ(pair.second.GetSlotNum(), current_key);
+    current_key++;
+  }
+  EXPECT_EQ(current_key, 1001);
+
+  // the same lookups through interpolation search
+  EXPECT_TRUE(tree.SetInterpolationSearch(true));
+  for (auto key : keys) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.GetValue(index_key, &rids));
+    EXPECT_EQ(rids[0].GetSlotNum(), key);
+    index_key.SetFromInteger(key + 1000);
+    EXPECT_FALSE(tree.GetValue(index_key, &rids));
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
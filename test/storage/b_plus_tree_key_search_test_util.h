@@ -0,0 +1,58 @@
+/**
+ * b_plus_tree_key_search_test_util.h
+ *
+ * Leaf and internal page entries of BIGINT keys, shared by the key search tests and benchmarks.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "storage/index/generic_key.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+
+namespace bustub {
+
+using LeafPair = std::pair<GenericKey<8>, RID>;
+using InternalPair = std::pair<GenericKey<8>, page_id_t>;
+
+// number of entries in a full leaf page of BIGINT keys
+static const size_t FULL_LEAF_SIZE = (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(LeafPair);
+
+// size entries with the keys 0, step, 2 * step, ...
+template <typename Pair>
+std::vector<Pair> MakeSortedEntries(size_t size, int64_t step) {
+  std::vector<Pair> entries(size);
+  for (size_t i = 0; i < size; i++) {
+    entries[i].first.SetFromInteger(static_cast<int64_t>(i) * step);
+  }
+  return entries;
+}
+
+// a full leaf of distinct keys drawn from a Zipf(1) distribution over [1, domain]: dense at the low end, sparse after
+inline std::vector<LeafPair> MakeZipfianEntries(size_t size, int64_t domain, std::mt19937_64 *rng) {
+  std::vector<double> cdf(domain);
+  double sum = 0;
+  for (int64_t rank = 1; rank <= domain; rank++) {
+    sum += 1.0 / static_cast<double>(rank);
+    cdf[rank - 1] = sum;
+  }
+  std::uniform_real_distribution<double> uniform(0, sum);
+  std::vector<int64_t> keys;
+  while (keys.size() < size) {
+    keys.push_back(std::lower_bound(cdf.begin(), cdf.end(), uniform(*rng)) - cdf.begin() + 1);
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  }
+  std::vector<LeafPair> entries(size);
+  for (size_t i = 0; i < size; i++) {
+    entries[i].first.SetFromInteger(keys[i]);
+  }
+  return entries;
+}
+
+}  // namespace bustub
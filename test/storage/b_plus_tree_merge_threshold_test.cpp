@@ -0,0 +1,137 @@
+/**
+ * b_plus_tree_merge_threshold_test.cpp
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+
+namespace bustub {
+
+using IntegerTree = BPlusTree<GenericKey<8>, RID, GenericIntegerComparator<8>>;
+using IntegerLeaf = BPlusTreeLeafPage<GenericKey<8>, RID, GenericIntegerComparator<8>>;
+
+// walk the leaf chain, returning the number of leaves and the size of the smallest non-root leaf
+static int CountLeaves(IntegerTree *tree, BufferPoolManager *bpm, int *min_leaf_size) {
+  GenericKey<8> useless{};
+  Page *page = tree->FindLeafPage(useless, true);
+  int count = 0;
+  *min_leaf_size = INT32_MAX;
+  while (page != nullptr) {
+    auto *leaf = reinterpret_cast<IntegerLeaf *>(page->GetData());
+    count++;
+    if (!leaf->IsRootPage()) {
+      *min_leaf_size = std::min(*min_leaf_size, leaf->GetSize());
+    }
+    page_id_t next_page_id = leaf->GetNextPageId();
+    bpm->UnpinPage(page->GetPageId(), false);
+    page = next_page_id == INVALID_PAGE_ID ? nullptr : bpm->FetchPage(next_page_id);
+  }
+  return count;
+}
+
+static void CheckContents(IntegerTree *tree, const std::vector<int64_t> &keys) {
+  auto it = keys.begin();
+  for (auto &pair : *tree) {
+    ASSERT_NE(it, keys.end());
+    EXPECT_EQ(pair.second.GetSlotNum(), *it);
+    ++it;
+  }
+  EXPECT_EQ(it, keys.end());
+  std::vector<RID> rids;
+  GenericKey<8> index_key;
+  for (auto key : keys) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree->GetValue(index_key, &rids));
+  }
+}
+
+/*
+ * Delete three keys out of four. The default threshold keeps every leaf half
+ * full, a relaxed one leaves sparse leaves behind until Compact() is run.
+ */
+TEST(BPlusTreeMergeThresholdTest, RelaxedThresholdAndCompact) {
+  const int leaf_max_size = 16;
+  int default_leaves = 0;
+  for (double ratio : {0.5, 0.25, 0.0}) {
+    GenericIntegerComparator<8> comparator;
+    DiskManager *disk_manager = new DiskManager("test.db");
+    BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+    IntegerTree tree("foo_pk", bpm, comparator, leaf_max_size, 8);
+    tree.SetMergeThreshold(ratio);
+    page_id_t page_id;
+    bpm->NewPage(&page_id);
+
+    std::vector<int64_t> keys;
+    for (int64_t key = 0; key < 2000; key++) {
+      keys.push_back(key);
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+    GenericKey<8> index_key;
+    for (auto key : keys) {
+      index_key.SetFromInteger(key);
+      tree.Insert(index_key, RID(0, static_cast<uint32_t>(key)));
+    }
+    int min_leaf_size;
+    int leaves_before = CountLeaves(&tree, bpm, &min_leaf_size);
+
+    std::vector<int64_t> remaining;
+    for (auto key : keys) {
+      if (key % 4 != 0) {
+        index_key.SetFromInteger(key);
+        tree.Remove(index_key);
+      }
+    }
+    for (int64_t key = 0; key < 2000; key += 4) {
+      remaining.push_back(key);
+    }
+    CheckContents(&tree, remaining);
+    int leaves_after = CountLeaves(&tree, bpm, &min_leaf_size);
+    if (ratio == 0.5) {
+      EXPECT_GE(min_leaf_size, leaf_max_size / 2);
+      default_leaves = leaves_after;
+    } else {
+      EXPECT_GE(min_leaf_size, std::max(1, static_cast<int>(ratio * leaf_max_size)));
+      // fewer merges: more of the original leaves survive than with the default threshold
+      EXPECT_GT(leaves_after, default_leaves);
+    }
+    EXPECT_LE(leaves_after, leaves_before);
+
+    tree.Compact();
+    CheckContents(&tree, remaining);
+    int leaves_compacted = CountLeaves(&tree, bpm, &min_leaf_size);
+    EXPECT_GE(min_leaf_size, leaf_max_size / 2);
+    EXPECT_LE(leaves_compacted, leaves_after);
+
+    // the tree keeps working after compaction
+    for (int64_t key = 1; key < 2000; key += 4) {
+      index_key.SetFromInteger(key);
+      EXPECT_TRUE(tree.Insert(index_key, RID(0, static_cast<uint32_t>(key))));
+    }
+    for (auto key : remaining) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key);
+    }
+    std::vector<int64_t> odd_keys;
+    for (int64_t key = 1; key < 2000; key += 4) {
+      odd_keys.push_back(key);
+    }
+    CheckContents(&tree, odd_keys);
+
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete bpm;
+    delete disk_manager;
+    remove("test.db");
+    remove("test.log");
+  }
+}
+
+}  // namespace bustub
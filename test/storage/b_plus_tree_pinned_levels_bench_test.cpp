@@ -0,0 +1,68 @@
+/**
+ * b_plus_tree_pinned_levels_bench_test.cpp
+ *
+ * Timing of point lookups with and without pinned upper levels, kept out of the unit tests.
+ */
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+
+namespace bustub {
+
+using IntegerTree = BPlusTree<GenericKey<8>, RID, GenericIntegerComparator<8>>;
+
+/*
+ * Benchmark: point lookups with the upper levels going through the buffer pool
+ * and with them pinned.
+ */
+TEST(BPlusTreePinnedLevelsBenchTest, LookupBenchmark) {
+  const int num_keys = 20000;
+  GenericIntegerComparator<8> comparator;
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(200, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  IntegerTree tree("foo_pk", bpm, comparator, 32, 32);
+
+  GenericKey<8> index_key;
+  for (int64_t key = 0; key < num_keys; key++) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, static_cast<uint32_t>(key)));
+  }
+  std::vector<GenericKey<8>> probes(10000);
+  std::mt19937_64 rng(0);
+  for (auto &probe : probes) {
+    probe.SetFromInteger(static_cast<int64_t>(rng() % num_keys));
+  }
+
+  for (int levels : {0, 2}) {
+    tree.SetPinnedLevels(levels);
+    std::vector<RID> rids;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const auto &probe : probes) {
+      rids.clear();
+      EXPECT_TRUE(tree.GetValue(probe, &rids));
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    std::cout << "pinned levels " << levels << ": " << static_cast<double>(ns) / probes.size() << " ns/lookup"
+              << std::endl;
+  }
+  tree.SetPinnedLevels(0);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
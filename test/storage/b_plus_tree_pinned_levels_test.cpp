@@ -0,0 +1,116 @@
+/**
+ * b_plus_tree_pinned_levels_test.cpp
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/page/header_page.h"
+
+namespace bustub {
+
+using IntegerTree = BPlusTree<GenericKey<8>, RID, GenericIntegerComparator<8>>;
+
+// every page but the header must be unpinned, or NewPage fails
+static void CheckNoPinnedPages(BufferPoolManager *bpm, size_t pool_size) {
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < pool_size - 1; i++) {
+    page_id_t page_id;
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id));
+    page_ids.push_back(page_id);
+  }
+  for (auto page_id : page_ids) {
+    bpm->UnpinPage(page_id, false);
+  }
+}
+
+static page_id_t HeaderRootId(BufferPoolManager *bpm, const std::string &name) {
+  auto *header_page = static_cast<HeaderPage *>(bpm->FetchPage(HEADER_PAGE_ID));
+  page_id_t root_id = INVALID_PAGE_ID;
+  header_page->GetRootId(name, &root_id);
+  bpm->UnpinPage(HEADER_PAGE_ID, false);
+  return root_id;
+}
+
+TEST(BPlusTreePinnedLevelsTest, InsertRemoveWithPinnedLevels) {
+  const size_t pool_size = 50;
+  GenericIntegerComparator<8> comparator;
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(pool_size, disk_manager);
+  page_id_t page_id;
+  auto *header_page = static_cast<HeaderPage *>(bpm->NewPage(&page_id));
+  // placeholder root id, overwritten by the first flush
+  header_page->InsertRecord("foo_pk", HEADER_PAGE_ID);
+
+  // small pages give a deep tree, so root changes and internal merges happen often
+  IntegerTree tree("foo_pk", bpm, comparator, 4, 4);
+  tree.SetPinnedLevels(2);
+  tree.SetDeferRootUpdates(true);
+
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < 1000; key++) {
+    keys.push_back(key);
+  }
+  std::mt19937 rng(0);
+  std::shuffle(keys.begin(), keys.end(), rng);
+  GenericKey<8> index_key;
+  std::vector<RID> rids;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, RID(0, static_cast<uint32_t>(key))));
+    rids.clear();
+    EXPECT_TRUE(tree.GetValue(index_key, &rids));
+  }
+
+  // the header page only sees the root after a flush
+  EXPECT_EQ(HEADER_PAGE_ID, HeaderRootId(bpm, "foo_pk"));
+  tree.FlushRootPageId();
+  EXPECT_EQ(tree.GetRootPageId(), HeaderRootId(bpm, "foo_pk"));
+
+  std::shuffle(keys.begin(), keys.end(), rng);
+  std::vector<int64_t> remaining;
+  for (size_t i = 0; i < keys.size(); i++) {
+    index_key.SetFromInteger(keys[i]);
+    if (i % 3 != 0) {
+      tree.Remove(index_key);
+      rids.clear();
+      EXPECT_FALSE(tree.GetValue(index_key, &rids));
+    } else {
+      remaining.push_back(keys[i]);
+    }
+  }
+  std::sort(remaining.begin(), remaining.end());
+  auto it = remaining.begin();
+  for (auto &pair : tree) {
+    ASSERT_NE(it, remaining.end());
+    EXPECT_EQ(pair.second.GetSlotNum(), *it);
+    ++it;
+  }
+  EXPECT_EQ(it, remaining.end());
+  auto rit = remaining.rbegin();
+  for (auto iter = tree.RBegin(); !iter.isEnd(); ++iter) {
+    EXPECT_EQ((*iter).second.GetSlotNum(), *rit);
+    ++rit;
+  }
+  EXPECT_EQ(rit, remaining.rend());
+
+  // turning deferral off writes the pending root
+  tree.SetDeferRootUpdates(false);
+  EXPECT_EQ(tree.GetRootPageId(), HeaderRootId(bpm, "foo_pk"));
+  tree.SetPinnedLevels(0);
+  CheckNoPinnedPages(bpm, pool_size);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
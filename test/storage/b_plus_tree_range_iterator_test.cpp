@@ -0,0 +1,192 @@
+/**
+ * b_plus_tree_range_iterator_test.cpp
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+
+namespace bustub {
+
+using IntegerTree = BPlusTree<GenericKey<8>, RID, GenericIntegerComparator<8>>;
+
+static GenericKey<8> MakeKey(int64_t key) {
+  GenericKey<8> index_key;
+  index_key.SetFromInteger(key);
+  return index_key;
+}
+
+template <typename Iterator>
+static std::vector<int64_t> Collect(Iterator &&iterator) {
+  std::vector<int64_t> keys;
+  for (; !iterator.isEnd(); ++iterator) {
+    keys.push_back((*iterator).first.ToString());
+  }
+  return keys;
+}
+
+template <typename Iterator>
+static std::vector<int64_t> CollectBatches(Iterator &&iterator, int max) {
+  std::vector<int64_t> keys;
+  std::vector<std::pair<GenericKey<8>, RID>> batch;
+  while (iterator.NextBatch(&batch, max) > 0) {
+    EXPECT_LE(batch.size(), max);
+    for (auto &pair : batch) {
+      keys.push_back(pair.first.ToString());
+    }
+  }
+  return keys;
+}
+
+static std::vector<int64_t> Expected(const std::vector<int64_t> &keys, int64_t lo, int64_t hi, bool reverse) {
+  std::vector<int64_t> expected;
+  for (auto key : keys) {
+    if (key >= lo && key < hi) {
+      expected.push_back(key);
+    }
+  }
+  if (reverse) {
+    std::reverse(expected.begin(), expected.end());
+  }
+  return expected;
+}
+
+TEST(BPlusTreeRangeIteratorTest, BoundedAndReverse) {
+  GenericIntegerComparator<8> comparator;
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  IntegerTree tree("foo_pk", bpm, comparator, 4, 4);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+
+  // keys 0, 3, 6, ..., then remove some of them so that leaves get merged and redistributed
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < 600; key += 3) {
+    keys.push_back(key);
+  }
+  std::vector<int64_t> shuffled(keys);
+  std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(0));
+  for (auto key : shuffled) {
+    tree.Insert(MakeKey(key), RID(0, static_cast<uint32_t>(key)));
+  }
+  std::vector<int64_t> remaining;
+  for (auto key : keys) {
+    if (key % 4 == 0) {
+      tree.Remove(MakeKey(key));
+    } else {
+      remaining.push_back(key);
+    }
+  }
+
+  // full reverse scan follows the left-sibling links of every leaf
+  EXPECT_EQ(Collect(tree.RBegin()), Expected(remaining, INT64_MIN, INT64_MAX, true));
+  int64_t count = 0;
+  for (auto iterator = tree.RBegin(); iterator != tree.end(); ++iterator) {
+    count++;
+  }
+  EXPECT_EQ(count, remaining.size());
+
+  std::mt19937 rng(1);
+  for (int i = 0; i < 200; i++) {
+    int64_t lo = static_cast<int64_t>(rng() % 620) - 10;
+    int64_t hi = lo + static_cast<int64_t>(rng() % 100);
+    EXPECT_EQ(Collect(tree.Begin(MakeKey(lo), MakeKey(hi))), Expected(remaining, lo, hi, false));
+    EXPECT_EQ(Collect(tree.RBegin(MakeKey(lo), MakeKey(hi))), Expected(remaining, lo, hi, true));
+    EXPECT_EQ(Collect(tree.RBegin(MakeKey(hi))), Expected(remaining, INT64_MIN, hi + 1, true));
+  }
+
+  // a bounded scan compares equal to end() once it stops
+  int64_t current = 0;
+  for (auto iterator = tree.Begin(MakeKey(100), MakeKey(200)); iterator != tree.end(); ++iterator) {
+    current = (*iterator).first.ToString();
+  }
+  EXPECT_EQ(current, 198);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeRangeIteratorTest, NextBatch) {
+  GenericIntegerComparator<8> comparator;
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  IntegerTree tree("foo_pk", bpm, comparator, 16, 16);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < 1000; key++) {
+    keys.push_back(key);
+    tree.Insert(MakeKey(key), RID(0, static_cast<uint32_t>(key)));
+  }
+
+  for (int max : {1, 7, 16, 100, 2000}) {
+    EXPECT_EQ(CollectBatches(tree.begin(), max), keys);
+    EXPECT_EQ(CollectBatches(tree.RBegin(), max), Expected(keys, 0, 1000, true));
+    EXPECT_EQ(CollectBatches(tree.Begin(MakeKey(123), MakeKey(456)), max), Expected(keys, 123, 456, false));
+    EXPECT_EQ(CollectBatches(tree.RBegin(MakeKey(123), MakeKey(456)), max), Expected(keys, 123, 456, true));
+  }
+
+  // batches and ++ can be mixed; the iterator unpins its leaf when it goes out of scope, before the pool is deleted
+  {
+    auto iterator = tree.Begin(MakeKey(10));
+    std::vector<std::pair<GenericKey<8>, RID>> batch;
+    EXPECT_EQ(iterator.NextBatch(&batch, 5), 5);
+    EXPECT_EQ(batch.back().first.ToString(), 14);
+    EXPECT_EQ((*iterator).first.ToString(), 15);
+    ++iterator;
+    EXPECT_EQ(iterator.NextBatch(&batch, 1), 1);
+    EXPECT_EQ(batch[0].first.ToString(), 16);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeRangeIteratorTest, ReverseWithDuplicates) {
+  GenericIntegerComparator<8> comparator;
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  IntegerTree tree("foo_idx", bpm, comparator, 4, 4);
+  tree.SetUniqueKeys(false);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < 20; key++) {
+    for (int i = 0; i < 5; i++) {
+      keys.push_back(key);
+    }
+  }
+  std::vector<int64_t> shuffled(keys);
+  std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(0));
+  for (size_t i = 0; i < shuffled.size(); i++) {
+    tree.Insert(MakeKey(shuffled[i]), RID(0, static_cast<uint32_t>(i)));
+  }
+
+  for (int64_t key = -1; key <= 20; key++) {
+    EXPECT_EQ(Collect(tree.RBegin(MakeKey(key))), Expected(keys, INT64_MIN, key + 1, true));
+    EXPECT_EQ(Collect(tree.Begin(MakeKey(key), MakeKey(key + 1))), Expected(keys, key, key + 1, false));
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
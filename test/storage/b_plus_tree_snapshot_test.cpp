@@ -0,0 +1,211 @@
+/**
+ * b_plus_tree_snapshot_test.cpp
+ */
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstring>
+#include <future>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/shadow_page_manager.h"
+
+namespace bustub {
+
+using IntegerTree = BPlusTree<GenericKey<8>, RID, GenericIntegerComparator<8>>;
+
+// the keys of a snapshot scan, in scan order
+static std::vector<int64_t> ScanSnapshot(IntegerTree *tree, uint64_t snapshot) {
+  std::vector<int64_t> keys;
+  for (auto iter = tree->SnapshotBegin(snapshot); !iter.isEnd(); ++iter) {
+    keys.push_back((*iter).first.ToString());
+  }
+  return keys;
+}
+
+TEST(BPlusTreeSnapshotTest, SnapshotsKeepTheirContents) {
+  GenericIntegerComparator<8> comparator;
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  IntegerTree tree("foo_pk", bpm, comparator, 8, 8);
+  tree.SetShadowPaging(true);
+
+  GenericKey<8> index_key;
+  std::vector<int64_t> evens;
+  for (int64_t key = 0; key < 1000; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, static_cast<uint32_t>(key)));
+    evens.push_back(key);
+  }
+  uint64_t first = tree.TakeSnapshot();
+
+  // fill the gaps (splits everywhere), then remove a third of the keys (merges and root changes)
+  for (int64_t key = 1; key < 1000; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, static_cast<uint32_t>(key)));
+  }
+  std::vector<int64_t> rest;
+  for (int64_t key = 0; key < 1000; key++) {
+    index_key.SetFromInteger(key);
+    if (key % 3 == 0) {
+      tree.Remove(index_key);
+    } else {
+      rest.push_back(key);
+    }
+  }
+  uint64_t second = tree.TakeSnapshot();
+  for (int64_t key = 0; key < 1000; key++) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key);
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+
+  EXPECT_EQ(evens, ScanSnapshot(&tree, first));
+  EXPECT_EQ(rest, ScanSnapshot(&tree, second));
+  std::vector<RID> rids;
+  for (int64_t key = 0; key < 1000; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    ASSERT_EQ(key % 2 == 0, tree.GetValueAt(first, index_key, &rids));
+    ASSERT_EQ(key % 3 != 0, tree.GetValueAt(second, index_key, &rids));
+  }
+  GenericKey<8> lo;
+  GenericKey<8> hi;
+  lo.SetFromInteger(100);
+  hi.SetFromInteger(110);
+  std::vector<std::pair<GenericKey<8>, RID>> batch;
+  auto iter = tree.SnapshotBegin(second, lo, hi);
+  EXPECT_EQ(7, iter.NextBatch(&batch, 64));
+  EXPECT_EQ(100, batch.front().first.ToString());
+  EXPECT_EQ(109, batch.back().first.ToString());
+
+  // a snapshot of the empty tree, then the versions go away with the snapshots
+  uint64_t empty = tree.TakeSnapshot();
+  EXPECT_TRUE(tree.SnapshotBegin(empty).isEnd());
+  tree.ReleaseSnapshot(first);
+  EXPECT_EQ(rest, ScanSnapshot(&tree, second));
+  tree.ReleaseSnapshot(second);
+  tree.ReleaseSnapshot(empty);
+  tree.SetShadowPaging(false);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+/*
+ * A writer keeps inserting and removing while readers scan a snapshot taken
+ * at the start over and over; every scan must return the snapshot contents.
+ */
+TEST(BPlusTreeSnapshotTest, ConcurrentScans) {
+  const int num_readers = 3;
+  GenericIntegerComparator<8> comparator;
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(100, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  IntegerTree tree("foo_pk", bpm, comparator, 8, 8);
+  tree.SetShadowPaging(true);
+
+  GenericKey<8> index_key;
+  std::vector<int64_t> expected;
+  for (int64_t key = 0; key < 600; key += 3) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, static_cast<uint32_t>(key)));
+    expected.push_back(key);
+  }
+  uint64_t snapshot = tree.TakeSnapshot();
+
+  std::atomic<bool> done{false};
+  std::atomic<int> failures{0};
+  std::atomic<int> scans{0};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < num_readers; i++) {
+    readers.emplace_back([&] {
+      // at least one scan per reader, the writer may be done before the first one
+      do {
+        if (ScanSnapshot(&tree, snapshot) != expected) {
+          failures++;
+        }
+        scans++;
+      } while (!done.load());
+    });
+  }
+  GenericKey<8> key;
+  for (int round = 0; round < 3; round++) {
+    for (int64_t k = 0; k < 600; k++) {
+      key.SetFromInteger(k);
+      tree.Insert(key, RID(0, static_cast<uint32_t>(k)));
+    }
+    // a new snapshot now and then, so that pages get several versions
+    tree.ReleaseSnapshot(tree.TakeSnapshot());
+    for (int64_t k = 0; k < 600; k++) {
+      key.SetFromInteger(k);
+      tree.Remove(key);
+    }
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(0, failures.load());
+  EXPECT_GE(scans.load(), num_readers);
+  tree.ReleaseSnapshot(snapshot);
+  tree.SetShadowPaging(false);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+// a snapshot read of a page the writer is changing waits neither for the end of the write operation nor sees it
+TEST(BPlusTreeSnapshotTest, ReadersDoNotWaitForTheWriter) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  page_id_t page_id;
+  Page *page = bpm->NewPage(&page_id);
+  memset(page->GetData(), 'a', PAGE_SIZE);
+
+  auto *shadow = new ShadowPageManager(bpm);
+  shadow->BeginWrite();
+  uint64_t snapshot = shadow->TakeSnapshot(page_id);
+  shadow->EndWrite();
+
+  shadow->BeginWrite();
+  shadow->BeforeWrite(page_id);
+  memset(page->GetData(), 'b', PAGE_SIZE);
+  // the operation is still open
+  auto read = std::async(std::launch::async, [&] {
+    std::vector<char> out(PAGE_SIZE);
+    shadow->ReadPage(snapshot, page_id, out.data());
+    return out;
+  });
+  ASSERT_EQ(std::future_status::ready, read.wait_for(std::chrono::seconds(5)));
+  std::vector<char> out = read.get();
+  EXPECT_EQ(std::vector<char>(PAGE_SIZE, 'a'), out);
+  shadow->EndWrite();
+  EXPECT_EQ(1, shadow->GetShadowCount());
+
+  shadow->ReleaseSnapshot(snapshot);
+  EXPECT_EQ(0, shadow->GetShadowCount());
+  delete shadow;
+  bpm->UnpinPage(page_id, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
@@ -0,0 +1,96 @@
+/**
+ * b_plus_tree_stats_test.cpp
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+
+namespace bustub {
+
+using IntegerTree = BPlusTree<GenericKey<8>, RID, GenericIntegerComparator<8>>;
+
+TEST(BPlusTreeStatsTest, ShapeAndHistogram) {
+  GenericIntegerComparator<8> comparator;
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  IntegerTree tree("foo_pk", bpm, comparator, 8, 8);
+  tree.SetUniqueKeys(false);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+
+  IndexStats stats;
+  std::vector<GenericKey<8>> bounds;
+  tree.CollectStats(&stats, &bounds, 4);
+  EXPECT_EQ(0, stats.height_);
+  EXPECT_EQ(0, stats.num_entries_);
+  EXPECT_TRUE(bounds.empty());
+
+  // 1000 distinct keys, each inserted 3 times
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < 3000; key++) {
+    keys.push_back(key / 3);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+  GenericKey<8> index_key;
+  uint32_t slot = 0;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, slot++));
+  }
+
+  tree.CollectStats(&stats, &bounds, 10);
+  EXPECT_EQ(3000, stats.num_entries_);
+  EXPECT_EQ(1000, stats.distinct_keys_);
+  EXPECT_DOUBLE_EQ(0.001, stats.EqualitySelectivity());
+
+  // the leaf count and height match a walk of the leaf chain
+  uint32_t leaves = 0;
+  Page *page = tree.FindLeafPage(index_key, true);
+  while (page != nullptr) {
+    auto *leaf = reinterpret_cast<BPlusTreeLeafPage<GenericKey<8>, RID, GenericIntegerComparator<8>> *>(page->GetData());
+    leaves++;
+    page_id_t next_page_id = leaf->GetNextPageId();
+    bpm->UnpinPage(page->GetPageId(), false);
+    page = next_page_id == INVALID_PAGE_ID ? nullptr : bpm->FetchPage(next_page_id);
+  }
+  EXPECT_EQ(leaves, stats.leaf_page_count_);
+  EXPECT_GT(stats.internal_page_count_, 0);
+  EXPECT_GE(stats.height_, 4);
+  // no page is full and, apart from the root, none is below half full
+  EXPECT_GT(stats.leaf_fill_, 0.5);
+  EXPECT_LT(stats.leaf_fill_, 1.0);
+
+  // equi-depth: 300 entries per bucket, bounds are the keys at positions 299, 599, ...
+  ASSERT_EQ(10, bounds.size());
+  ASSERT_EQ(10, stats.bucket_counts_.size());
+  for (size_t b = 0; b < bounds.size(); b++) {
+    EXPECT_EQ(300, stats.bucket_counts_[b]);
+    EXPECT_EQ(static_cast<int64_t>((b + 1) * 100 - 1), bounds[b].ToString());
+  }
+
+  // sampling every other leaf gives estimates of the real counts (small leaves, so within 20%)
+  tree.CollectStats(&stats, &bounds, 10, 2);
+  EXPECT_EQ(2, stats.leaf_sample_rate_);
+  EXPECT_EQ(leaves, stats.leaf_page_count_);
+  EXPECT_NEAR(3000, stats.num_entries_, 300);
+  EXPECT_NEAR(1000, stats.distinct_keys_, 200);
+  ASSERT_EQ(10, bounds.size());
+  for (size_t b = 1; b < bounds.size(); b++) {
+    EXPECT_LE(bounds[b - 1].ToString(), bounds[b].ToString());
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
@@ -0,0 +1,187 @@
+/**
+ * b_plus_tree_varlen_page_test.cpp
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/rid.h"
+#include "gtest/gtest.h"
+#include "storage/page/b_plus_tree_varlen_page.h"
+
+namespace bustub {
+
+using VarlenLeafPage = BPlusTreeVarlenPage<RID>;
+using VarlenInternalPage = BPlusTreeVarlenPage<page_id_t>;
+
+// keys of a typical VARCHAR index: a long shared prefix and a short distinct tail
+static std::string UrlKey(int i) {
+  char buf[64];
+  snprintf(buf, sizeof(buf), "https://www.example.com/users/%06d/profile", i);
+  return std::string(buf);
+}
+
+TEST(BPlusTreeVarlenPageTest, PrefixCompression) {
+  char buffer[PAGE_SIZE];
+  auto *leaf = reinterpret_cast<VarlenLeafPage *>(buffer);
+  leaf->Init(1);
+
+  std::vector<int> ids(1000);
+  for (int i = 0; i < 1000; i++) {
+    ids[i] = i;
+  }
+  std::shuffle(ids.begin(), ids.end(), std::mt19937(0));
+  std::vector<int> inserted;
+  for (int id : ids) {
+    if (!leaf->Insert(UrlKey(id), RID(0, id))) {
+      break;
+    }
+    inserted.push_back(id);
+  }
+  // a GenericKey<64> leaf holds (4096 - 28) / 72 = 56 entries
+  EXPECT_GT(inserted.size(), 56 * 2);
+  EXPECT_EQ(leaf->GetSize(), static_cast<int>(inserted.size()));
+  EXPECT_EQ(leaf->GetPrefix().substr(0, 30), "https://www.example.com/users/");
+
+  for (int i = 1; i < leaf->GetSize(); i++) {
+    EXPECT_LT(leaf->KeyAt(i - 1), leaf->KeyAt(i));
+  }
+  RID rid;
+  for (int id : inserted) {
+    EXPECT_TRUE(leaf->Lookup(UrlKey(id), &rid));
+    EXPECT_EQ(rid.GetSlotNum(), id);
+  }
+  EXPECT_FALSE(leaf->Lookup("https://www.example.com/users/", &rid));
+  EXPECT_FALSE(leaf->Lookup("a", &rid));
+  EXPECT_FALSE(leaf->Lookup("z", &rid));
+  EXPECT_EQ(leaf->KeyIndex("a"), 0);
+  EXPECT_EQ(leaf->KeyIndex("z"), leaf->GetSize());
+}
+
+TEST(BPlusTreeVarlenPageTest, PrefixBreakAndRemove) {
+  char buffer[PAGE_SIZE];
+  auto *leaf = reinterpret_cast<VarlenLeafPage *>(buffer);
+  leaf->Init(1);
+
+  for (int i = 0; i < 10; i++) {
+    EXPECT_TRUE(leaf->Insert(UrlKey(i * 2), RID(0, i * 2)));
+  }
+  // a split/compaction computes the prefix, the next key breaks it
+  char other[PAGE_SIZE];
+  auto *right = reinterpret_cast<VarlenLeafPage *>(other);
+  right->Init(2);
+  leaf->MoveHalfTo(right);
+  EXPECT_GT(leaf->GetPrefix().size(), 30);
+  EXPECT_TRUE(leaf->Insert("apple", RID(0, 100)));
+  EXPECT_TRUE(leaf->GetPrefix().empty());
+  EXPECT_EQ(leaf->KeyAt(0), "apple");
+
+  RID rid;
+  int size = leaf->GetSize();
+  leaf->Remove(0);
+  EXPECT_EQ(leaf->GetSize(), size - 1);
+  EXPECT_FALSE(leaf->Lookup("apple", &rid));
+  for (int i = 0; i < leaf->GetSize(); i++) {
+    EXPECT_TRUE(leaf->Lookup(leaf->KeyAt(i), &rid));
+    EXPECT_EQ(rid, leaf->ValueAt(i));
+  }
+
+  // removed cells are garbage until the page is rebuilt by an insert that does not fit the gap
+  size_t free_space = leaf->GetFreeSpace();
+  while (leaf->GetSize() > 1) {
+    leaf->Remove(leaf->GetSize() - 1);
+  }
+  EXPECT_GT(leaf->GetFreeSpace(), free_space);
+  int id = 1000;
+  while (leaf->Insert(UrlKey(id), RID(0, id))) {
+    id++;
+  }
+  EXPECT_LT(leaf->GetFreeSpace(), 64);
+  for (int i = 1000; i < id; i++) {
+    EXPECT_TRUE(leaf->Lookup(UrlKey(i), &rid));
+    EXPECT_EQ(rid.GetSlotNum(), i);
+  }
+}
+
+TEST(BPlusTreeVarlenPageTest, SplitWithTruncatedSeparator) {
+  char left_buffer[PAGE_SIZE];
+  char right_buffer[PAGE_SIZE];
+  char root_buffer[PAGE_SIZE];
+  auto *left = reinterpret_cast<VarlenLeafPage *>(left_buffer);
+  auto *right = reinterpret_cast<VarlenLeafPage *>(right_buffer);
+  auto *root = reinterpret_cast<VarlenInternalPage *>(root_buffer);
+  left->Init(1);
+  right->Init(2);
+  root->Init(3, INVALID_PAGE_ID, IndexPageType::INTERNAL_PAGE);
+
+  int count = 0;
+  while (left->Insert(UrlKey(count), RID(0, count))) {
+    count++;
+  }
+  left->MoveHalfTo(right);
+  EXPECT_EQ(left->GetSize() + right->GetSize(), count);
+  EXPECT_LT(left->KeyAt(left->GetSize() - 1), right->KeyAt(0));
+
+  std::string separator = VarlenLeafPage::ShortestSeparator(left->KeyAt(left->GetSize() - 1), right->KeyAt(0));
+  EXPECT_LT(separator.size(), right->KeyAt(0).size());
+  root->PopulateNewRoot(1, separator, 2);
+  EXPECT_EQ(root->GetSize(), 2);
+  EXPECT_EQ(root->KeyAt(1), separator);
+
+  RID rid;
+  for (int i = 0; i < count; i++) {
+    page_id_t child = root->LookupChild(UrlKey(i));
+    VarlenLeafPage *leaf = child == 1 ? left : right;
+    EXPECT_TRUE(leaf->Lookup(UrlKey(i), &rid));
+    EXPECT_EQ(rid.GetSlotNum(), i);
+  }
+}
+
+TEST(BPlusTreeVarlenPageTest, InternalPage) {
+  char buffer[PAGE_SIZE];
+  auto *internal = reinterpret_cast<VarlenInternalPage *>(buffer);
+  internal->Init(1, INVALID_PAGE_ID, IndexPageType::INTERNAL_PAGE);
+  internal->PopulateNewRoot(100, "key:0050", 101);
+  char key[16];
+  for (int i = 2; i < 50; i++) {
+    snprintf(key, sizeof(key), "key:%04d", i * 50);
+    EXPECT_TRUE(internal->Insert(key, 100 + i));
+  }
+  // every key that broke the prefix rebuilt the page with a shorter one
+  EXPECT_EQ(internal->GetPrefix(), "key:");
+  EXPECT_EQ(internal->LookupChild("a"), 100);
+  EXPECT_EQ(internal->LookupChild("key:0049"), 100);
+  EXPECT_EQ(internal->LookupChild("key:0050"), 101);
+  EXPECT_EQ(internal->LookupChild("key:0099"), 101);
+  EXPECT_EQ(internal->LookupChild("key:0100"), 102);
+  EXPECT_EQ(internal->LookupChild("key:0149"), 102);
+  EXPECT_EQ(internal->LookupChild("key:0150"), 103);
+  EXPECT_EQ(internal->LookupChild("z"), 149);
+  EXPECT_EQ(internal->ValueIndex(120), 20);
+
+  // removing the first child turns the next key into the invalid one
+  internal->Remove(0);
+  EXPECT_EQ(internal->ValueAt(0), 101);
+  EXPECT_EQ(internal->LookupChild("a"), 101);
+  EXPECT_EQ(internal->LookupChild("key:0100"), 102);
+
+  char other[PAGE_SIZE];
+  auto *recipient = reinterpret_cast<VarlenInternalPage *>(other);
+  recipient->Init(2, INVALID_PAGE_ID, IndexPageType::INTERNAL_PAGE);
+  internal->MoveHalfTo(recipient);
+  std::string middle = recipient->KeyAt(0);
+  EXPECT_EQ(recipient->LookupChild(middle), recipient->ValueAt(0));
+  EXPECT_EQ(internal->LookupChild(middle), internal->ValueAt(internal->GetSize() - 1));
+}
+
+TEST(BPlusTreeVarlenPageTest, ShortestSeparator) {
+  EXPECT_EQ(VarlenLeafPage::ShortestSeparator("apple", "banana"), "b");
+  EXPECT_EQ(VarlenLeafPage::ShortestSeparator("user/0041", "user/0057"), "user/005");
+  EXPECT_EQ(VarlenLeafPage::ShortestSeparator("abc", "abcd"), "abcd");
+  EXPECT_EQ(VarlenLeafPage::ShortestSeparator("", "a"), "a");
+}
+
+}  // namespace bustub
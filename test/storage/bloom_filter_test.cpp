@@ -0,0 +1,113 @@
+/**
+ * bloom_filter_test.cpp
+ */
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/bloom_filter.h"
+
+namespace bustub {
+
+using IntegerTree = BPlusTree<GenericKey<8>, RID, GenericIntegerComparator<8>>;
+
+TEST(BloomFilterTest, NoFalseNegatives) {
+  const size_t num_keys = 10000;
+  BloomFilter filter(num_keys, 10);
+  EXPECT_EQ(0, filter.GetSizeInBytes() % 64);
+  std::mt19937_64 rng(0);
+  std::vector<uint64_t> hashes(num_keys);
+  for (auto &hash : hashes) {
+    hash = rng();
+    filter.Insert(hash);
+  }
+  for (auto hash : hashes) {
+    EXPECT_TRUE(filter.MayContain(hash));
+  }
+  // about 1% false positives at 10 bits per key, a little more for the blocked layout
+  int false_positives = 0;
+  const int num_probes = 100000;
+  for (int i = 0; i < num_probes; i++) {
+    false_positives += filter.MayContain(rng()) ? 1 : 0;
+  }
+  EXPECT_LT(false_positives, num_probes * 3 / 100);
+}
+
+TEST(BloomFilterTest, TreeLookups) {
+  GenericIntegerComparator<8> comparator;
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  IntegerTree tree("foo_pk", bpm, comparator, 16, 16);
+
+  // half of the keys go in before the filter is enabled, the rest after; the filter is sized too small on purpose,
+  // so it has to grow
+  GenericKey<8> index_key;
+  for (int64_t key = 0; key < 2000; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, static_cast<uint32_t>(key)));
+  }
+  tree.EnableBloomFilter(500);
+  for (int64_t key = 2000; key < 4000; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, static_cast<uint32_t>(key)));
+  }
+
+  // even keys are found, odd keys are not, and most of them never reach the tree
+  std::vector<RID> rids;
+  for (int64_t key = 0; key < 4000; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_EQ(key % 2 == 0, tree.GetValue(index_key, &rids));
+  }
+  std::vector<GenericKey<8>> keys(100);
+  for (size_t i = 0; i < keys.size(); i++) {
+    keys[i].SetFromInteger(static_cast<int64_t>(i));
+  }
+  std::vector<std::vector<RID>> results;
+  tree.GetValues(keys, &results);
+  for (size_t i = 0; i < keys.size(); i++) {
+    EXPECT_EQ(i % 2 == 0 ? 1 : 0, results[i].size());
+  }
+
+  IndexStats stats;
+  std::vector<GenericKey<8>> bounds;
+  tree.CollectStats(&stats, &bounds, 4);
+  EXPECT_GT(stats.bloom_filter_bytes_, 0);
+  EXPECT_EQ(2000 + 50, stats.bloom_negatives_ + stats.bloom_false_positives_);
+  EXPECT_LT(stats.BloomFalsePositiveRate(), 0.05);
+
+  // removed keys are not found any more, even though they stay in the filter
+  for (int64_t key = 0; key < 4000; key += 4) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key);
+  }
+  for (int64_t key = 0; key < 4000; key += 2) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_EQ(key % 4 != 0, tree.GetValue(index_key, &rids));
+  }
+  tree.CollectStats(&stats, &bounds, 4);
+  EXPECT_EQ(2000 + 50 + 1000, stats.bloom_negatives_ + stats.bloom_false_positives_);
+  EXPECT_GE(stats.bloom_false_positives_, 1000);
+  tree.RebuildBloomFilter(1000);
+  for (int64_t key = 0; key < 4000; key += 4) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_FALSE(tree.GetValue(index_key, &rids));
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
@@ -0,0 +1,72 @@
+/**
+ * in_memory_b_plus_tree_bench_test.cpp
+ *
+ * Timing of point lookups in the buffer pool tree against the in-memory tree, kept out of the unit tests.
+ */
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/in_memory_b_plus_tree.h"
+
+namespace bustub {
+
+using IntegerTree = BPlusTree<GenericKey<8>, RID, GenericIntegerComparator<8>>;
+using InMemoryTree = InMemoryBPlusTree<GenericKey<8>, RID, GenericIntegerComparator<8>>;
+
+/*
+ * Benchmark: point lookups through the buffer pool tree and the in-memory tree.
+ */
+TEST(InMemoryBPlusTreeBenchTest, LookupBenchmark) {
+  const int num_keys = 20000;
+  GenericIntegerComparator<8> comparator;
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(200, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  IntegerTree tree("foo_pk", bpm, comparator, 32, 32);
+  InMemoryTree in_memory_tree("foo_pk", comparator, 32, 32);
+
+  GenericKey<8> index_key;
+  for (int64_t key = 0; key < num_keys; key++) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, static_cast<uint32_t>(key)));
+    in_memory_tree.Insert(index_key, RID(0, static_cast<uint32_t>(key)));
+  }
+  std::vector<GenericKey<8>> probes(10000);
+  std::mt19937_64 rng(0);
+  for (auto &probe : probes) {
+    probe.SetFromInteger(static_cast<int64_t>(rng() % num_keys));
+  }
+
+  std::vector<RID> rids;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (const auto &probe : probes) {
+    rids.clear();
+    EXPECT_TRUE(tree.GetValue(probe, &rids));
+  }
+  auto mid = std::chrono::high_resolution_clock::now();
+  for (const auto &probe : probes) {
+    rids.clear();
+    EXPECT_TRUE(in_memory_tree.GetValue(probe, &rids));
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  auto ns = [](auto from, auto to) { return std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count(); };
+  std::cout << "buffer pool: " << static_cast<double>(ns(start, mid)) / probes.size() << " ns/lookup, in memory: "
+            << static_cast<double>(ns(mid, end)) / probes.size() << " ns/lookup" << std::endl;
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
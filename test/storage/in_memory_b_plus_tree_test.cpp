@@ -0,0 +1,217 @@
+/**
+ * in_memory_b_plus_tree_test.cpp
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "gtest/gtest.h"
+#include "storage/index/in_memory_b_plus_tree.h"
+
+namespace bustub {
+
+using InMemoryTree = InMemoryBPlusTree<GenericKey<8>, RID, GenericIntegerComparator<8>>;
+
+static void CheckScans(InMemoryTree *tree, const std::vector<int64_t> &keys) {
+  auto it = keys.begin();
+  for (auto iter = tree->begin(); iter != tree->end(); ++iter) {
+    ASSERT_NE(it, keys.end());
+    EXPECT_EQ((*iter).second.GetSlotNum(), *it);
+    ++it;
+  }
+  EXPECT_EQ(it, keys.end());
+  auto rit = keys.rbegin();
+  for (auto iter = tree->RBegin(); !iter.isEnd(); ++iter) {
+    ASSERT_NE(rit, keys.rend());
+    EXPECT_EQ((*iter).second.GetSlotNum(), *rit);
+    ++rit;
+  }
+  EXPECT_EQ(rit, keys.rend());
+}
+
+TEST(InMemoryBPlusTreeTest, InsertLookupRemove) {
+  GenericIntegerComparator<8> comparator;
+  // small nodes give a deep tree
+  InMemoryTree tree("foo_pk", comparator, 4, 4);
+  EXPECT_TRUE(tree.IsEmpty());
+
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < 2000; key++) {
+    keys.push_back(key);
+  }
+  std::mt19937 rng(0);
+  std::shuffle(keys.begin(), keys.end(), rng);
+  GenericKey<8> index_key;
+  std::vector<RID> rids;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, RID(0, static_cast<uint32_t>(key))));
+    EXPECT_FALSE(tree.Insert(index_key, RID(1, static_cast<uint32_t>(key))));
+  }
+  EXPECT_FALSE(tree.IsEmpty());
+  for (auto key : keys) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.GetValue(index_key, &rids));
+    ASSERT_EQ(1, rids.size());
+    EXPECT_EQ(RID(0, static_cast<uint32_t>(key)), rids[0]);
+  }
+  rids.clear();
+  index_key.SetFromInteger(5000);
+  EXPECT_FALSE(tree.GetValue(index_key, &rids));
+  EXPECT_TRUE(rids.empty());
+
+  std::vector<int64_t> sorted(keys);
+  std::sort(sorted.begin(), sorted.end());
+  CheckScans(&tree, sorted);
+
+  // bounded scans, both directions
+  GenericKey<8> lo;
+  GenericKey<8> hi;
+  lo.SetFromInteger(100);
+  hi.SetFromInteger(200);
+  int64_t expected = 100;
+  for (auto iter = tree.Begin(lo, hi); !iter.isEnd(); ++iter) {
+    EXPECT_EQ(expected++, (*iter).first.ToString());
+  }
+  EXPECT_EQ(200, expected);
+  expected = 199;
+  for (auto iter = tree.RBegin(lo, hi); !iter.isEnd(); ++iter) {
+    EXPECT_EQ(expected--, (*iter).first.ToString());
+  }
+  EXPECT_EQ(99, expected);
+  auto iter = tree.RBegin(hi);
+  EXPECT_EQ(200, (*iter).first.ToString());
+  std::vector<std::pair<GenericKey<8>, RID>> batch;
+  auto batch_iter = tree.Begin(lo);
+  EXPECT_EQ(64, batch_iter.NextBatch(&batch, 64));
+  EXPECT_EQ(100, batch.front().first.ToString());
+  EXPECT_EQ(163, batch.back().first.ToString());
+
+  // remove two keys out of three; nodes are not merged, so leaves go sparse or empty
+  std::vector<int64_t> remaining;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    if (key % 3 != 0) {
+      tree.Remove(index_key);
+      rids.clear();
+      EXPECT_FALSE(tree.GetValue(index_key, &rids));
+    } else {
+      remaining.push_back(key);
+    }
+  }
+  std::sort(remaining.begin(), remaining.end());
+  CheckScans(&tree, remaining);
+  for (auto key : remaining) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Remove(index_key, RID(0, static_cast<uint32_t>(key))));
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+  CheckScans(&tree, {});
+
+  // the emptied tree takes inserts again
+  for (int64_t key = 0; key < 100; key++) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, RID(0, static_cast<uint32_t>(key))));
+  }
+  std::vector<int64_t> small(100);
+  for (int64_t key = 0; key < 100; key++) {
+    small[key] = key;
+  }
+  CheckScans(&tree, small);
+  EXPECT_GT(tree.GetMemoryUsage(), 0);
+}
+
+TEST(InMemoryBPlusTreeTest, DuplicateKeys) {
+  GenericIntegerComparator<8> comparator;
+  InMemoryTree tree("foo_idx", comparator, 4, 4);
+  tree.SetUniqueKeys(false);
+
+  // 200 keys, 5 values each, long runs of equal keys span several leaves
+  std::vector<std::pair<int64_t, uint32_t>> entries;
+  for (uint32_t slot = 0; slot < 1000; slot++) {
+    entries.emplace_back(slot % 200, slot);
+  }
+  std::shuffle(entries.begin(), entries.end(), std::mt19937(0));
+  GenericKey<8> index_key;
+  for (auto &entry : entries) {
+    index_key.SetFromInteger(entry.first);
+    EXPECT_TRUE(tree.Insert(index_key, RID(0, entry.second)));
+  }
+  std::vector<RID> rids;
+  for (int64_t key = 0; key < 200; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.GetValue(index_key, &rids));
+    ASSERT_EQ(5, rids.size());
+    for (auto &rid : rids) {
+      EXPECT_EQ(key, rid.GetSlotNum() % 200);
+    }
+    // the last entry <= key and the first >= key
+    EXPECT_EQ(key, (*tree.RBegin(index_key)).first.ToString());
+    EXPECT_EQ(key, (*tree.Begin(index_key)).first.ToString());
+  }
+
+  // remove the exact pairs
+  for (uint32_t slot = 0; slot < 1000; slot += 2) {
+    index_key.SetFromInteger(slot % 200);
+    EXPECT_TRUE(tree.Remove(index_key, RID(0, slot)));
+    EXPECT_FALSE(tree.Remove(index_key, RID(0, slot)));
+  }
+  int count = 0;
+  for (auto &pair : tree) {
+    EXPECT_EQ(1, pair.second.GetSlotNum() % 2);
+    count++;
+  }
+  EXPECT_EQ(500, count);
+}
+
+/*
+ * Writers insert disjoint key ranges while readers look up the keys already
+ * inserted; every reader must find them and the final tree must be complete.
+ */
+TEST(InMemoryBPlusTreeTest, ConcurrentInsertLookup) {
+  const int num_writers = 4;
+  const int64_t keys_per_writer = 5000;
+  GenericIntegerComparator<8> comparator;
+  InMemoryTree tree("foo_pk", comparator, 8, 8);
+
+  std::vector<std::thread> threads;
+  std::atomic<int> failures{0};
+  for (int t = 0; t < num_writers; t++) {
+    threads.emplace_back([&, t] {
+      GenericKey<8> index_key;
+      std::vector<RID> rids;
+      for (int64_t i = 0; i < keys_per_writer; i++) {
+        // interleave the ranges so that writers share leaves
+        int64_t key = i * num_writers + t;
+        index_key.SetFromInteger(key);
+        if (!tree.Insert(index_key, RID(0, static_cast<uint32_t>(key)))) {
+          failures++;
+        }
+        // read back a key inserted earlier by this thread
+        index_key.SetFromInteger((i / 2) * num_writers + t);
+        rids.clear();
+        if (!tree.GetValue(index_key, &rids) || rids.size() != 1) {
+          failures++;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(0, failures.load());
+
+  std::vector<int64_t> keys(num_writers * keys_per_writer);
+  for (size_t i = 0; i < keys.size(); i++) {
+    keys[i] = static_cast<int64_t>(i);
+  }
+  CheckScans(&tree, keys);
+}
+
+}  // namespace bustub
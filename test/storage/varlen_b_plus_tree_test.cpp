@@ -0,0 +1,134 @@
+/**
+ * varlen_b_plus_tree_test.cpp
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/exception.h"
+#include "gtest/gtest.h"
+#include "storage/index/varlen_b_plus_tree.h"
+
+namespace bustub {
+
+// keys of a typical VARCHAR index: a long shared prefix and a short distinct tail
+static std::string UrlKey(int i) {
+  char buf[64];
+  snprintf(buf, sizeof(buf), "https://www.example.com/users/%06d/profile", i);
+  return std::string(buf);
+}
+
+TEST(VarlenBPlusTreeTest, InsertLookupRemove) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  bpm->UnpinPage(page_id, true);
+  VarlenBPlusTree tree("url_idx", bpm);
+
+  const int num_keys = 20000;
+  std::vector<int> ids(num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    ids[i] = i;
+  }
+  std::shuffle(ids.begin(), ids.end(), std::mt19937(0));
+  for (int id : ids) {
+    EXPECT_TRUE(tree.Insert(UrlKey(id), RID(id, id)));
+  }
+  EXPECT_FALSE(tree.Insert(UrlKey(7), RID(1, 1)));
+  // 40 byte keys: GenericKey<64> pages hold ~56 entries and need 3 levels, truncated separators and
+  // prefix compression fit the leaves of 20000 keys under a single root
+  EXPECT_EQ(2, tree.GetHeight());
+
+  std::vector<RID> rids;
+  for (int i = 0; i < num_keys; i++) {
+    rids.clear();
+    tree.GetValue(UrlKey(i), &rids);
+    ASSERT_EQ(1, rids.size());
+    EXPECT_EQ(i, rids[0].GetSlotNum());
+  }
+  rids.clear();
+  tree.GetValue("https://www.example.com/users/", &rids);
+  tree.GetValue(UrlKey(num_keys), &rids);
+  EXPECT_TRUE(rids.empty());
+
+  for (int i = 0; i < num_keys; i += 2) {
+    EXPECT_TRUE(tree.Remove(UrlKey(i), RID(i, i)));
+  }
+  EXPECT_FALSE(tree.Remove(UrlKey(0), RID(0, 0)));
+  EXPECT_FALSE(tree.Remove(UrlKey(1), RID(2, 2)));
+  for (int i = 0; i < num_keys; i++) {
+    rids.clear();
+    tree.GetValue(UrlKey(i), &rids);
+    EXPECT_EQ(i % 2, rids.size());
+  }
+
+  std::string too_long(VarlenBPlusTree::MAX_KEY_SIZE + 1, 'x');
+  EXPECT_THROW(tree.Insert(too_long, RID(0, 0)), Exception);
+
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(VarlenBPlusTreeTest, DuplicateKeys) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  bpm->UnpinPage(page_id, true);
+  VarlenBPlusTree tree("dup_idx", bpm);
+  tree.SetUniqueKeys(false);
+
+  // runs of one key span several leaves
+  std::vector<std::string> keys{std::string(500, 'b'), std::string(500, 'c'), "d"};
+  const int rids_per_key = 200;
+  std::vector<std::pair<size_t, int>> entries;
+  for (size_t k = 0; k < keys.size(); k++) {
+    for (int slot = 0; slot < rids_per_key; slot++) {
+      entries.emplace_back(k, slot);
+    }
+  }
+  std::shuffle(entries.begin(), entries.end(), std::mt19937(0));
+  for (auto &entry : entries) {
+    EXPECT_TRUE(tree.Insert(keys[entry.first], RID(entry.second % 7, entry.second)));
+  }
+  EXPECT_GT(tree.GetHeight(), 1);
+
+  // the RIDs of a key come back in (page id, slot) order
+  std::vector<RID> rids;
+  for (const auto &key : keys) {
+    rids.clear();
+    tree.GetValue(key, &rids);
+    ASSERT_EQ(rids_per_key, rids.size());
+    for (size_t i = 1; i < rids.size(); i++) {
+      EXPECT_LT(rids[i - 1].Get(), rids[i].Get());
+    }
+  }
+
+  for (int slot = 0; slot < rids_per_key; slot += 3) {
+    EXPECT_TRUE(tree.Remove(keys[1], RID(slot % 7, slot)));
+  }
+  rids.clear();
+  tree.GetValue(keys[1], &rids);
+  EXPECT_EQ(rids_per_key - (rids_per_key + 2) / 3, rids.size());
+  for (auto &rid : rids) {
+    EXPECT_NE(0, rid.GetSlotNum() % 3);
+  }
+  rids.clear();
+  tree.GetValue(keys[0], &rids);
+  EXPECT_EQ(rids_per_key, rids.size());
+
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub